@@ -0,0 +1,213 @@
+/** @file
+ *
+ *  @ingroup example_module
+ *
+ *  @brief Coroutine version of the TCP multichat server network program.
+ *
+ *  This demo behaves the same as @c chat_server_demo.cpp and works with
+ *  @c simple_chat_demo.cpp clients, but each connection is handled by a coroutine
+ *  which awaits incoming messages instead of a message handler callback.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *  Sample make file:
+g++ -std=c++20 -Wall -Werror \
+-I ../include \
+-I ../../utility-rack/include/ \
+-I ../../utility-rack/third_party/ \
+-I ../../asio/asio/include/ \
+chat_server_coro_demo.cpp -lpthread -o chat_server_coro
+ *
+ */
+
+#include <iostream>
+#include <cstdlib> // EXIT_SUCCESS
+#include <cstddef> // std::size_t
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <thread>
+#include <cassert>
+
+#include "asio/awaitable.hpp"
+#include "asio/co_spawn.hpp"
+#include "asio/detached.hpp"
+#include "asio/use_awaitable.hpp"
+#include "asio/as_tuple.hpp"
+#include "asio/this_coro.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+#include "net_ip_component/worker.hpp"
+#include "net_ip_component/send_to_all.hpp"
+#include "net_ip_component/coro_io.hpp"
+#include "net_ip/io_type_decls.hpp"
+
+using io_interface = chops::net::tcp_io_interface;
+using sta_type = chops::net::send_to_all<chops::net::tcp_io>;
+using awaiter_type = chops::net::io_state_awaiter<chops::net::tcp_io>;
+
+const std::string DELIM = "\a"; // alert (bell)
+
+// process command line args
+// set ip_addr, port, param, print_errors as needed
+bool process_args(int argc,  char* const argv[], std::string& ip_addr,
+                  std::string& port, bool& print_errors) {
+   const std::string PORT = "5001";
+   const std::string LOCAL_LOOP = "127.0.0.1";
+   const std::string USAGE =
+       "usage:\n"
+       "  ./chat_server_coro [-h] [-e] [port]\n"
+       "      -h   print usage\n"
+       "      -e   print all error messages to console\n"
+       "      default port = " + PORT + "\n"
+       "      server IP address (fixed) = " + LOCAL_LOOP + " (local loop)";
+
+   const std::string HELP_PRM = "-h";
+   const std::string ERR_PRM = "-e";
+
+   // set default values
+   ip_addr = LOCAL_LOOP;
+   port = PORT;
+
+   if (argc > 3 || (argc == 2 && argv[1] == HELP_PRM)) {
+      std::cout << USAGE << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   if (argc == 2) {
+      if (argv[1] == ERR_PRM) {
+         print_errors = true;
+      } else {
+         port = argv[1];
+      }
+   }
+
+   if (argc == 3) {
+      if (argv[1] == ERR_PRM) {
+         print_errors = true;
+         port = argv[2];
+      } else {
+         std::cout << USAGE << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+
+   return EXIT_SUCCESS;
+}
+
+// one coroutine per client: wait for text, send it on to all other clients
+asio::awaitable<void> chat_session(io_interface iof, sta_type& sta) {
+   chops::net::coro_reader<chops::net::tcp_io> reader(co_await asio::this_coro::executor);
+   if (!iof.start_io(std::string_view(DELIM), reader.msg_handler())) {
+      co_return;
+   }
+   auto io_out = iof.make_io_output();
+   if (!io_out) {
+      co_return;
+   }
+
+   for (;;) {
+      auto [err, buf] = co_await reader.async_read(asio::as_tuple(asio::use_awaitable));
+      if (err) {
+         co_return; // client disconnected
+      }
+      const std::string_view s (static_cast<const char*> (buf.data()), buf.size());
+      if (s == "quit" + DELIM) {
+         // send 'quit' to originator
+         // originator needs message for io_state_change halt
+         io_out->send(buf.data(), buf.size());
+      } else {
+         // not 'quit' (normal message)
+         // so send message to all but originator
+         sta.send(buf.data(), buf.size(), *io_out);
+      }
+   }
+}
+
+// wait for each client connection and spawn a session coroutine for it
+asio::awaitable<void> accept_loop(awaiter_type& awaiter, sta_type& sta) {
+   auto exec = co_await asio::this_coro::executor;
+   for (;;) {
+      auto [err, iof] = co_await awaiter.async_wait_io(asio::as_tuple(asio::use_awaitable));
+      if (err) {
+         co_return; // awaiter closed
+      }
+      asio::co_spawn(exec, chat_session(iof, sta), asio::detached);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   std::string ip_addr;
+   std::string port;
+   bool print_errors = false;
+
+   if (process_args(argc, argv, ip_addr, port, print_errors) == EXIT_FAILURE) {
+      return EXIT_FAILURE;
+   }
+
+   // work guard - handles @c std::thread and @c asio::io_context management
+   chops::net::worker wk;
+   wk.start();
+   auto exec = wk.get_io_context().get_executor();
+
+   // handles all @c io_interfaces
+   sta_type sta;
+   awaiter_type awaiter(exec);
+
+   // add to or remove @c io_interface from list in sta, then hand new connections to
+   // the accept loop coroutine
+   const auto io_state_chng_hndlr = [&sta, aw = awaiter.io_state_change()]
+                              (io_interface iof, std::size_t n, bool flag) {
+      sta(iof, n, flag);
+      aw(iof, n, flag);
+   };
+
+   const auto err_func = [&print_errors](io_interface iof, std::error_code err) {
+      if (print_errors) {
+         std::cerr << err << ", " << err.message() << std::endl;
+      }
+   };
+
+   // create @c net_ip instance
+   chops::net::net_ip server(wk.get_io_context());
+   // make @c tcp_acceptor, return @c network_entity
+   auto net_entity = server.make_tcp_acceptor(port.c_str());
+   assert(net_entity.is_valid());
+   // start network entity, emplace handlers
+   net_entity.start(io_state_chng_hndlr, err_func);
+   asio::co_spawn(exec, accept_loop(awaiter, sta), asio::detached);
+
+   std::cout << "chops-net-ip chat server coroutine demo" << std::endl;
+   std::cout << "  port: " << port << std::endl;
+   if (print_errors) {
+      std::cout << "  all error messages printed to console" << std::endl;
+   }
+
+   std::string s;
+   std::cout << "press return to exit" << std::endl;
+   getline(std::cin, s);
+   // ignore any user input
+   // notify clients of server shutdown
+   s = "server shutting down..." + DELIM;
+   sta.send(s.data(), s.size());
+
+   // delay so message gets sent
+   std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+   // shutdown
+   std::cerr << "shutdown...\n";
+   awaiter.close();
+   net_entity.stop();
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+   wk.reset();
+
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/**
+ *  @file
+ *
+ *  @ingroup example_module
+ *
+ *  @brief Coroutine version of the TCP acceptor (server) that receives binary text
+ *  messages, converts to upper case, then echos back to TCP connector (client).
+ *
+ *  This demo behaves the same as @c echo_binary_text_server_demo.cpp and works with
+ *  @c echo_binary_text_client_demo.cpp, but each connection is handled by a coroutine
+ *  which awaits incoming messages instead of a message handler callback.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ *  Sample make file:
+g++ -std=c++20 -Wall -Werror \
+-I ../include \
+-I ../../utility-rack/include/ \
+-I ../../utility-rack/third_party/ \
+-I ../../asio/asio/include/ \
+echo_binary_text_server_coro_demo.cpp -lpthread -o echo_server_coro
+ *
+ */
+
+#include <iostream>
+#include <cstdlib> // EXIT_SUCCESS
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint16_t
+#include <string>
+#include <algorithm> // std::for_each
+#include <cassert>
+
+#include "asio/awaitable.hpp"
+#include "asio/co_spawn.hpp"
+#include "asio/detached.hpp"
+#include "asio/use_awaitable.hpp"
+#include "asio/as_tuple.hpp"
+#include "asio/this_coro.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+#include "net_ip/simple_variable_len_msg_frame.hpp"
+#include "net_ip_component/worker.hpp"
+#include "net_ip_component/coro_io.hpp"
+#include "serialize/extract_append.hpp"
+#include "net_ip/io_type_decls.hpp"
+
+using io_interface = chops::net::tcp_io_interface;
+using endpoint = asio::ip::tcp::endpoint;
+
+// process command line args (if any)
+bool processArgs(int argc, char* argv[], bool& print_errors, std::string& port) {
+    const std::string HELP_PRM = "-h";
+    const std::string PRINT_ERRS = "-e";
+    const std::string USEAGE = \
+    "useage: ./echo_server_coro [-h | -e] [port]\n"
+    "  -h    Print useage\n"
+    "  -e    Print error messages\n"
+    "  port  Default: 5002";
+    int offset = 0;
+
+    if (argc > 3 || (argc > 1 && argv[1] == HELP_PRM)) {
+        std::cout << USEAGE << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (argc > 1 && argv[1] == PRINT_ERRS) {
+        print_errors = true;
+        offset = 1;
+    }
+
+    if (argc > 1 + offset) {
+        port = argv[1 + offset];
+    }
+
+    return EXIT_SUCCESS;
+}
+
+constexpr std::size_t HDR_SIZE{2}; // 1st 2 bytes of data is message size
+constexpr std::size_t MAX_QUEUED_BYTES{64 * 1024}; // send backpressure limit
+
+// 1st 2 bytes is message size, endian correct data marshalling
+std::size_t decode_hdr(const std::byte* ptr, std::size_t) {
+    return chops::extract_val<std::endian::big, std::uint16_t>(ptr);
+}
+
+// one coroutine per connection: wait for a message, convert to uppercase, send back
+asio::awaitable<void> echo_session(io_interface iof) {
+    chops::net::coro_reader<chops::net::tcp_io> reader(co_await asio::this_coro::executor);
+    if (!iof.start_io(HDR_SIZE, reader.msg_handler(), &decode_hdr)) {
+        co_return;
+    }
+    auto io_out = iof.make_io_output();
+    if (!io_out) {
+        co_return;
+    }
+
+    for (;;) {
+        auto [err, buf] = co_await reader.async_read(asio::as_tuple(asio::use_awaitable));
+        if (err) {
+            co_return; // connection closed
+        }
+        // create string from buf, omit 1st 2 bytes (header); buf is only valid until the
+        // next co_await, so it is used (and copied) right away
+        std::string s (static_cast<const char*> (buf.data()) + HDR_SIZE, buf.size() - HDR_SIZE);
+        endpoint ep = reader.remote_endpoint();
+
+        // print info about client
+        std::cout << "received request from " << ep.address() << ":" << ep.port() << std::endl;
+        std::cout << "  text: " << s << std::endl;
+        // convert received text to uppercase
+        auto to_upper = [] (char& c) { c = ::toupper(c); };
+        std::for_each(s.begin(), s.end(), to_upper);
+
+        // create buffer to send altered text back to client
+        chops::mutable_shared_buffer buf_out;
+        // 1st 2 bytes are the size of the message
+        std::uint16_t size_val = static_cast<std::uint16_t>(s.size());
+        std::byte tbuf[HDR_SIZE]; // temp buffer to hold the header
+        std::size_t result = chops::append_val<std::endian::big, std::uint16_t>(tbuf, size_val);
+        assert(result == HDR_SIZE);
+        buf_out.append(tbuf, sizeof(tbuf)); // write the header
+        buf_out.append(s.data(), s.size()); // now add the text data
+        // send message back to the client, waiting if the client is not keeping up
+        auto [send_err] = co_await chops::net::async_send(*io_out,
+                                  chops::const_shared_buffer(std::move(buf_out)),
+                                  MAX_QUEUED_BYTES, asio::as_tuple(asio::use_awaitable));
+        if (send_err) {
+            co_return;
+        }
+    }
+}
+
+// wait for each accepted connection and spawn a session coroutine for it
+asio::awaitable<void> accept_loop(chops::net::io_state_awaiter<chops::net::tcp_io>& awaiter) {
+    auto exec = co_await asio::this_coro::executor;
+    for (;;) {
+        auto [err, iof] = co_await awaiter.async_wait_io(asio::as_tuple(asio::use_awaitable));
+        if (err) {
+            co_return; // awaiter closed
+        }
+        asio::co_spawn(exec, echo_session(iof), asio::detached);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const std::string PORT = "5002";
+
+    std::string port = PORT;
+    bool print_errors = false;
+
+    if (processArgs(argc, argv, print_errors, port) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
+    }
+
+    // error handler
+    auto err_func = [&] (io_interface iof, std::error_code err) {
+        if (print_errors) {
+            std::string err_text = err.category().name();
+            err_text += ": " + std::to_string(err.value()) + ", " +
+            err.message();
+            std::cerr << err_text << std::endl;
+        }
+    };
+
+    // work guard - handles @c std::thread and @c asio::io_context management
+    chops::net::worker wk;
+    wk.start();
+    auto exec = wk.get_io_context().get_executor();
+
+    // create @c net_ip instance
+    chops::net::net_ip echo_server(wk.get_io_context());
+    chops::net::io_state_awaiter<chops::net::tcp_io> awaiter(exec);
+
+    // make @ tcp_acceptor, return @c network_entity
+    auto net_entity_accept = echo_server.make_tcp_acceptor(port.c_str());
+    assert(net_entity_accept.is_valid());
+    // start network entity; connections are handed to the accept loop coroutine
+    net_entity_accept.start(awaiter.io_state_change(), err_func);
+    asio::co_spawn(exec, accept_loop(awaiter), asio::detached);
+
+    // begin
+    std::cout << "chops-net-ip binary text echo coroutine demo - server" << std::endl;
+    std::cout << "  IP address:port = 127.0.0.1:" << port << std::endl;
+    std::cout << "  print error messages: " << (print_errors ? "ON" : "OFF") << std::endl;
+    std::cout << "Press return to exit" << std::endl;
+
+    std::string s;
+    std::getline(std::cin, s); // pause until return
+
+    // cleanup
+    awaiter.close();
+    net_entity_accept.stop();
+    wk.reset();
+
+    return EXIT_SUCCESS;
+}
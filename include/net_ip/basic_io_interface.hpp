@@ -90,7 +90,9 @@ namespace net {
  *
  *  All @c basic_io_interface methods can be called concurrently from multiple threads, but
  *  calling @c stop_io at the same time as @c start_io from multiple threads may result
- *  in undesired application behavior.
+ *  in undesired application behavior. For a TCP IO handler the read processing started
+ *  by @c start_io (and the socket close from @c stop_io) runs on the executor of the IO 
+ *  handler socket, which may be a different thread than the calling thread.
  *
  *  Error handling is provided by returning a @c nonstd::expected object on most methods. 
  *  
@@ -235,6 +237,16 @@ public:
  *  The message handler function object is moved if possible, otherwise it is copied. 
  *  State data should be movable or copyable.
  *
+ *  The @c basic_io_output passed to the message handler is pinned to the IO handler
+ *  (see @c basic_io_output), so sends from within the message handler do not touch the
+ *  IO handler reference count. Pinning is lost if the @c basic_io_output is copied or
+ *  moved before it reaches the message handler code, which is the case when the
+ *  message handler is wrapped in a @c std::function (its call operator forwards the
+ *  argument, move constructing the parameter of the target) or another forwarding
+ *  wrapper. Sends then work as usual, but each one promotes a @c std::weak_ptr. Pass
+ *  the lambda or function object directly, or take the parameter by @c const
+ *  reference in the message handler signature, to keep the pinned object.
+ *
  *  @param msg_frame A message frame function object callback. The signature of
  *  the callback is:
  *
@@ -308,6 +320,8 @@ public:
  *  The message handler function object is moved if possible, otherwise it is copied. 
  *  State data should be movable or copyable.
  *
+ *  See the message frame @c start_io for keeping the @c basic_io_output pinned.
+ *
  *  @param func A function that is of type @c hdr_decoder_func.
  *
  *  @return @c nonstd::expected - IO is started on success; on error, a 
@@ -356,6 +370,8 @@ public:
  *  The message handler function object is moved if possible, otherwise it is copied. 
  *  State data should be movable or copyable.
  *
+ *  See the message frame @c start_io for keeping the @c basic_io_output pinned.
+ *
  *  @return @c nonstd::expected - IO is started on success; on error, a 
  *  @c std::error_code is returned.
  *
@@ -407,6 +423,8 @@ public:
  *  The message handler function object is moved if possible, otherwise it is copied. 
  *  State data should be movable or copyable.
  *
+ *  See the message frame @c start_io for keeping the @c basic_io_output pinned.
+ *
  *  @return @c nonstd::expected - IO is started on success; on error, a 
  *  @c std::error_code is returned.
  */
@@ -453,6 +471,8 @@ public:
  *  The message handler function object is moved if possible, otherwise it is copied. 
  *  State data should be movable or copyable.
  *
+ *  See the message frame @c start_io for keeping the @c basic_io_output pinned.
+ *
  *  @return @c nonstd::expected - IO is started on success; on error, a 
  *  @c std::error_code is returned.
  */
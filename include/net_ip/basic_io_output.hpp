@@ -20,7 +20,9 @@
 #include <memory> // std::weak_ptr, std::shared_ptr
 #include <system_error>
 #include <cstddef> // std::size_t, std::byte
-#include <utility> // std::move
+#include <utility> // std::move, std::forward
+
+#include "asio/any_io_executor.hpp"
 
 #include "nonstd/expected.hpp"
 
@@ -51,6 +53,12 @@ namespace net {
  *
  *  All @c basic_io_output @c send methods can be called concurrently from multiple threads.
  *
+ *  The @c basic_io_output passed to a message handler is pinned to the IO handler for the
+ *  duration of the message handler call: the IO handler is guaranteed to be alive, so 
+ *  @c send and the other methods do not need to promote a @c std::weak_ptr. A copy (or
+ *  move) of a pinned @c basic_io_output is a normal (unpinned) @c basic_io_output, so
+ *  the message handler can safely store it for later use.
+ *
  */
 
 template <typename IOT>
@@ -58,6 +66,7 @@ class basic_io_output {
 
 private:
   std::weak_ptr<IOT>   m_ioh_wptr;
+  IOT*                 m_pinned = nullptr;
 
 public:
   using endpoint_type = typename IOT::endpoint_type;
@@ -79,6 +88,44 @@ public:
  */
   explicit basic_io_output(std::weak_ptr<IOT> p) noexcept : m_ioh_wptr(p) { }
 
+/**
+ *  @brief Construct a pinned @c basic_io_output from a pointer to an internal IO handler.
+ *  This constructor is for internal use only and not to be used by application code.
+ *
+ *  The IO handler must stay alive for the lifetime of this object, which is the case for
+ *  the @c basic_io_output passed to a message handler.
+ *
+ *  Pinning is not transferred: a copy or move gives an unpinned object that promotes a
+ *  @c std::weak_ptr on each send. A message handler wrapped in a @c std::function (or
+ *  any wrapper that forwards its arguments by value) therefore receives an unpinned
+ *  object, see @c basic_io_interface::start_io.
+ */
+  explicit basic_io_output(IOT* p) noexcept : m_ioh_wptr(), m_pinned(p) { }
+
+/**
+ *  @brief Copy construct a @c basic_io_output; a copy of a pinned object is not pinned.
+ */
+  basic_io_output(const basic_io_output& rhs) noexcept : 
+    m_ioh_wptr(rhs.unpinned()), m_pinned(nullptr) { }
+
+/**
+ *  @brief Move construct a @c basic_io_output; the result is not pinned.
+ */
+  basic_io_output(basic_io_output&& rhs) noexcept : 
+    m_ioh_wptr(rhs.m_pinned ? rhs.unpinned() : std::move(rhs.m_ioh_wptr)), m_pinned(nullptr) { }
+
+  basic_io_output& operator=(const basic_io_output& rhs) noexcept {
+    m_ioh_wptr = rhs.unpinned();
+    m_pinned = nullptr;
+    return *this;
+  }
+
+  basic_io_output& operator=(basic_io_output&& rhs) noexcept {
+    m_ioh_wptr = rhs.m_pinned ? rhs.unpinned() : std::move(rhs.m_ioh_wptr);
+    m_pinned = nullptr;
+    return *this;
+  }
+
 /**
  *  @brief Query whether an IO handler is associated with this object.
  *
@@ -88,7 +135,7 @@ public:
  *
  *  @return @c true if associated with an IO handler.
  */
-  bool is_valid() const noexcept { return !m_ioh_wptr.expired(); }
+  bool is_valid() const noexcept { return m_pinned || !m_ioh_wptr.expired(); }
 
 /**
  *  @brief Return output queue statistics, allowing application monitoring of output queue
@@ -100,10 +147,117 @@ public:
  */
   auto get_output_queue_stats() const ->
          nonstd::expected<output_queue_stats, std::error_code> {
+    if (m_pinned) {
+      return m_pinned->get_output_queue_stats();
+    }
     return detail::wp_access<output_queue_stats>( m_ioh_wptr,
           [] (std::shared_ptr<IOT> sp) { return sp->get_output_queue_stats(); } );
   }
 
+/**
+ *  @brief Discard the buffers waiting in the output queue of the associated network IO
+ *  handler; a write in progress is not affected.
+ *
+ *  This is useful when only the most recent data matters to a slow receiver, for example
+ *  when conflating market data or status updates.
+ *
+ *  @return @c nonstd::expected - number of buffers discarded on success; on error (if no
+ *  associated IO handler), a @c std::error_code is returned.
+ *
+ */
+  auto clear_output_queue() const ->
+         nonstd::expected<std::size_t, std::error_code> {
+    if (m_pinned) {
+      return m_pinned->clear_output_queue();
+    }
+    return detail::wp_access<std::size_t>( m_ioh_wptr,
+          [] (std::shared_ptr<IOT> sp) { return sp->clear_output_queue(); } );
+  }
+
+/**
+ *  @brief Enable time stamping in the output queue of the associated network IO handler.
+ *
+ *  Time stamping is off by default, since it reads the clock for every queued buffer 
+ *  and every write. When off, the @c oldest_queued_age and 
+ *  @c write_in_progress_duration fields of @c output_queue_stats are zero. Once enabled
+ *  it stays enabled for the life of the IO handler; buffers queued (and a write started)
+ *  before enabling are not time stamped.
+ *
+ *  @return @c nonstd::expected - on error (if no associated IO handler), a 
+ *  @c std::error_code is returned.
+ *
+ */
+  auto enable_output_timestamps() const ->
+         nonstd::expected<void, std::error_code> {
+    if (m_pinned) {
+      m_pinned->enable_output_timestamps();
+      return { };
+    }
+    return detail::wp_access_void( m_ioh_wptr,
+          [] (std::shared_ptr<IOT> sp) { 
+              sp->enable_output_timestamps();
+              return std::error_code();
+            } );
+  }
+
+/**
+ *  @brief Request a notification when the output queue of the associated network IO 
+ *  handler has drained to a threshold.
+ *
+ *  The function object is invoked once, from the thread completing the write that 
+ *  drains the output queue to @c max_bytes or less, with no lock held. When 
+ *  @c max_bytes is 0, the notification is delivered when all queued data has been 
+ *  written (the output queue is empty and no write is in progress). The function object
+ *  is invoked immediately (in the calling thread) if the output queue is already 
+ *  drained or IO has not been started, and is also invoked when the IO handler stops 
+ *  (since the output queue is then discarded).
+ *
+ *  This allows an application (e.g. at shutdown) to wait for data to be sent without
+ *  polling @c get_output_queue_stats. See @c make_output_queue_drained_future for 
+ *  waiting on a collection of @c basic_io_output objects.
+ *
+ *  @param max_bytes Threshold of bytes remaining in the output queue.
+ *
+ *  @param func Function object with a signature of @c void().
+ *
+ *  @return @c nonstd::expected - on error (if no associated IO handler, in which case
+ *  the function object is not invoked), a @c std::error_code is returned.
+ *
+ */
+  template <typename F>
+  auto notify_when_drained(std::size_t max_bytes, F&& func) const ->
+         nonstd::expected<void, std::error_code> {
+    if (m_pinned) {
+      m_pinned->notify_when_drained(max_bytes, std::forward<F>(func));
+      return { };
+    }
+    return detail::wp_access_void( m_ioh_wptr,
+          [max_bytes, &func] (std::shared_ptr<IOT> sp) { 
+              sp->notify_when_drained(max_bytes, std::forward<F>(func));
+              return std::error_code();
+            } );
+  }
+
+/**
+ *  @brief Return the executor of the associated network IO handler, which identifies 
+ *  the @c asio::io_context performing its IO.
+ *
+ *  This allows applications to group @c basic_io_output objects by @c io_context, or to
+ *  post work that runs on the same thread as the IO handler.
+ *
+ *  @return @c nonstd::expected - @c asio::any_io_executor on success; on error (if no
+ *  associated IO handler), a @c std::error_code is returned.
+ *
+ */
+  auto get_executor() const ->
+         nonstd::expected<asio::any_io_executor, std::error_code> {
+    if (m_pinned) {
+      return m_pinned->get_executor();
+    }
+    return detail::wp_access<asio::any_io_executor>( m_ioh_wptr,
+          [] (std::shared_ptr<IOT> sp) { return sp->get_executor(); } );
+  }
+
 /**
  *  @brief Send a buffer of data through the associated network IO handler.
  *
@@ -132,6 +286,9 @@ public:
  *
  */
   bool send(const chops::const_shared_buffer& buf) const {
+    if (m_pinned) {
+      return m_pinned->send(buf);
+    }
     auto sp = m_ioh_wptr.lock();
     return sp ?  sp->send(buf) : false;
   }
@@ -200,6 +357,9 @@ public:
  *
  */
   bool send(const chops::const_shared_buffer& buf, const endpoint_type& endp) const {
+    if (m_pinned) {
+      return m_pinned->send(buf, endp);
+    }
     auto sp = m_ioh_wptr.lock();
     return sp ?  sp->send(buf, endp) : false;
   }
@@ -223,6 +383,55 @@ public:
     return send(chops::const_shared_buffer(std::move(buf)), endp);
   }
 
+/**
+ *  @brief Send a range of reference counted buffers through the associated network IO
+ *  handler.
+ *
+ *  All of the buffers are queued under a single lock acquisition in the IO handler and 
+ *  at most one write is started, which is more efficient than calling @c send in a loop
+ *  when messages are produced in bursts. The buffers are sent in range order.
+ *
+ *  This is a non-blocking call.
+ *
+ *  @param bufs Range (e.g. @c std::vector or @c std::span) of @c chops::const_shared_buffer 
+ *  objects.
+ *
+ *  @return Number of buffers written or queued for output, 0 if no IO handler association
+ *  or IO handler stopped.
+ *
+ */
+  template <typename R>
+  std::size_t send_batch(const R& bufs) const {
+    if (m_pinned) {
+      return m_pinned->send_batch(bufs);
+    }
+    auto sp = m_ioh_wptr.lock();
+    return sp ? sp->send_batch(bufs) : 0u;
+  }
+
+/**
+ *  @brief Send a range of reference counted buffers to a specific destination endpoint,
+ *  implemented only for UDP IO handlers.
+ *
+ *  See documentation for @c send_batch without endpoint.
+ *
+ *  @param bufs Range of @c chops::const_shared_buffer objects.
+ *
+ *  @param endp Destination @c asio::ip::udp::endpoint for the buffers.
+ *
+ *  @return Number of buffers written or queued for output, 0 if no IO handler association
+ *  or IO handler stopped.
+ *
+ */
+  template <typename R>
+  std::size_t send_batch(const R& bufs, const endpoint_type& endp) const {
+    if (m_pinned) {
+      return m_pinned->send_batch(bufs, endp);
+    }
+    auto sp = m_ioh_wptr.lock();
+    return sp ? sp->send_batch(bufs, endp) : 0u;
+  }
+
 /**
  *  @brief Compare two @c basic_io_output objects for equality.
  *
@@ -235,7 +444,7 @@ public:
  *  @return As described in the comments.
  */
   bool operator==(const basic_io_output<IOT>& rhs) const noexcept {
-    return (m_ioh_wptr.lock() == rhs.m_ioh_wptr.lock());
+    return (unpinned().lock() == rhs.unpinned().lock());
   }
 
 /**
@@ -248,7 +457,26 @@ public:
  *  @return As described in the comments.
  */
   bool operator<(const basic_io_output<IOT>& rhs) const noexcept {
-    return (m_ioh_wptr.lock() < rhs.m_ioh_wptr.lock());
+    return (unpinned().lock() < rhs.unpinned().lock());
+  }
+
+/**
+ *  @brief Owner based ordering of two @c basic_io_output objects, as provided by
+ *  @c std::owner_less.
+ *
+ *  Unlike @c operator<, the ordering does not change when the associated IO handler
+ *  is destroyed, so this can be used to key associative containers holding 
+ *  @c basic_io_output objects which may outlive their IO handler.
+ *
+ *  @return @c true if this object is ordered before @c rhs.
+ */
+  bool owner_before(const basic_io_output<IOT>& rhs) const noexcept {
+    return unpinned().owner_before(rhs.unpinned());
+  }
+
+private:
+  std::weak_ptr<IOT> unpinned() const noexcept {
+    return m_pinned ? m_pinned->weak_from_this() : m_ioh_wptr;
   }
 
 };
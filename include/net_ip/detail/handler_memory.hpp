@@ -0,0 +1,157 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Recycling memory for asynchronous operation handlers, attached to completion
+ *  handlers through the Asio associated allocator mechanism.
+ *
+ *  Each call to an Asio asynchronous function allocates storage for the operation, which
+ *  includes the completion handler (in this library a lambda holding a @c std::shared_ptr
+ *  to the IO handler plus the moved message handler and message frame function objects).
+ *  Asio caches this storage per thread, but the cache is only available to threads running
+ *  an @c io_context and is shared by everything on that thread. The classes in this file
+ *  give each chain of reads or writes its own block of memory, which is reused for every
+ *  operation in the chain, so steady-state reads and writes do not touch the heap.
+ *
+ *  A @c handler_memory object supports one outstanding allocation, which matches the
+ *  read and write processing in the IO handlers: the next read (or write) is not started
+ *  until the previous completion handler is invoked, and Asio releases operation storage
+ *  before invoking the completion handler. An allocation request that does not fit (or
+ *  arrives while the block is in use) falls back to the global heap.
+ *
+ *  @note For internal use only.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef HANDLER_MEMORY_HPP_INCLUDED
+#define HANDLER_MEMORY_HPP_INCLUDED
+
+#include <cstddef> // std::size_t, std::max_align_t
+#include <new> // ::operator new, ::operator delete
+#include <utility> // std::forward, std::move
+#include <type_traits> // std::decay_t
+
+namespace chops {
+namespace net {
+namespace detail {
+
+// sized for the largest operation used by the IO handlers (a composed read, with a
+// typical message handler and message frame) on common 64-bit platforms
+constexpr std::size_t handler_memory_size = 512u;
+
+class handler_memory {
+private:
+  alignas(std::max_align_t) unsigned char  m_storage[handler_memory_size];
+  bool                                     m_in_use;
+
+public:
+  handler_memory() noexcept : m_in_use(false) { }
+
+private:
+  // no copy or assignment semantics for this class
+  handler_memory(const handler_memory&) = delete;
+  handler_memory(handler_memory&&) = delete;
+  handler_memory& operator=(const handler_memory&) = delete;
+  handler_memory& operator=(handler_memory&&) = delete;
+
+public:
+
+  void* allocate(std::size_t size) {
+    if (!m_in_use && size <= sizeof(m_storage)) {
+      m_in_use = true;
+      return m_storage;
+    }
+    return ::operator new(size);
+  }
+
+  void deallocate(void* ptr) noexcept {
+    if (ptr == m_storage) {
+      m_in_use = false;
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
+  bool in_use() const noexcept { return m_in_use; }
+};
+
+// minimal allocator, as required by Asio for handler allocation
+template <typename T>
+class handler_allocator {
+public:
+  using value_type = T;
+
+private:
+  template <typename> friend class handler_allocator;
+
+  handler_memory*    m_memory;
+
+public:
+  explicit handler_allocator(handler_memory& mem) noexcept : m_memory(&mem) { }
+
+  template <typename U>
+  handler_allocator(const handler_allocator<U>& other) noexcept : m_memory(other.m_memory) { }
+
+  T* allocate(std::size_t n) const {
+    return static_cast<T*>(m_memory->allocate(sizeof(T) * n));
+  }
+
+  void deallocate(T* ptr, std::size_t) const noexcept {
+    m_memory->deallocate(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const handler_allocator<U>& rhs) const noexcept {
+    return m_memory == rhs.m_memory;
+  }
+
+  template <typename U>
+  bool operator!=(const handler_allocator<U>& rhs) const noexcept {
+    return m_memory != rhs.m_memory;
+  }
+};
+
+// completion handler wrapper which associates a handler_memory object with the handler;
+// the handler_memory object must outlive the asynchronous operation, which in this library
+// is guaranteed by the IO handler std::shared_ptr captured in the wrapped handler
+template <typename H>
+class alloc_handler {
+public:
+  using allocator_type = handler_allocator<H>;
+
+private:
+  handler_memory&    m_memory;
+  H                  m_handler;
+
+public:
+  alloc_handler(handler_memory& mem, H handler) :
+    m_memory(mem), m_handler(std::move(handler)) { }
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(m_memory);
+  }
+
+  template <typename ... Args>
+  void operator()(Args&& ... args) {
+    m_handler(std::forward<Args>(args)...);
+  }
+};
+
+template <typename H>
+alloc_handler<std::decay_t<H>> make_alloc_handler(handler_memory& mem, H&& handler) {
+  return alloc_handler<std::decay_t<H>>(mem, std::forward<H>(handler));
+}
+
+} // end detail namespace
+} // end net namespace
+} // end chops namespace
+
+#endif
+
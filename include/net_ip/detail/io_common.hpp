@@ -24,7 +24,12 @@
 #define IO_COMMON_HPP_INCLUDED
 
 #include <optional>
+#include <cstddef> // std::size_t
 #include <mutex>
+#include <chrono>
+#include <vector>
+#include <functional> // std::function
+#include <utility> // std::move
 
 #include "net_ip/detail/output_queue.hpp"
 #include "net_ip/queue_stats.hpp"
@@ -33,12 +38,27 @@ namespace chops {
 namespace net {
 namespace detail {
 
+// a drain function object is invoked once, when the bytes in the output queue are at or
+// below the watcher max bytes (and no write is in progress if max bytes is 0), or when
+// the output queue is cleared at shutdown
+using drain_func = std::function<void ()>;
+
 template <typename E>
 class io_common {
+private:
+  struct drain_watcher {
+    std::size_t   m_max_bytes;
+    drain_func    m_func;
+  };
+  using drain_watchers = std::vector<drain_watcher>;
+
 private:
   bool                m_io_started; // original implementation this was std::atomic_bool
   bool                m_write_in_progress;
+  bool                m_timestamps; // queue age and write duration, off by default
+  std::chrono::steady_clock::time_point  m_write_start;
   output_queue<E>     m_outq;
+  drain_watchers      m_drain_watchers;
   mutable std::mutex  m_mutex;
 
 private:
@@ -50,18 +70,108 @@ private:
     m_write_in_progress = false;
   }
 
+  bool is_drained(std::size_t max_bytes) const noexcept { // mutex should already be locked
+    return !m_io_started || (m_outq.num_bytes() <= max_bytes && 
+                             (max_bytes != 0u || !m_write_in_progress));
+  }
+
+  // mutex should already be locked; the watchers are invoked by the caller after the 
+  // mutex is unlocked
+  drain_watchers take_drained() {
+    drain_watchers ready;
+    if (m_drain_watchers.empty()) {
+      return ready;
+    }
+    for (auto it = m_drain_watchers.begin(); it != m_drain_watchers.end(); ) {
+      if (is_drained(it->m_max_bytes)) {
+        ready.push_back(std::move(*it));
+        it = m_drain_watchers.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+    return ready;
+  }
+
+  static void notify(drain_watchers& ready) {
+    for (auto& w : ready) {
+      w.m_func();
+    }
+  }
+
+  template <typename F>
+  void do_write(const E& elem, F& func) { // mutex should already be locked
+    m_write_in_progress = true;
+    if (m_timestamps) {
+      m_write_start = std::chrono::steady_clock::now();
+    }
+    func(elem);
+  }
+
 public:
   enum write_status { io_stopped, queued, write_started };
 
 public:
 
   io_common() noexcept :
-    m_io_started(false), m_write_in_progress(false), m_outq(), m_mutex() { }
+    m_io_started(false), m_write_in_progress(false), m_timestamps(false), m_write_start(), 
+    m_outq(), 
+    m_drain_watchers(), m_mutex() { }
+
+  // the following eight methods can be called concurrently
+
+  // time stamp queued elements and writes, so that the oldest queued age and the write
+  // in progress duration are reported in the output queue stats (otherwise zero); a write
+  // started before this call is not time stamped
+  void enable_timestamps() noexcept {
+    lk_guard lg(m_mutex);
+    m_timestamps = true;
+    m_outq.set_timestamps(true);
+  }
+
+  // turn time stamps back off, used when an IO handler is re-used for a new connection
+  void reset_timestamps() noexcept {
+    lk_guard lg(m_mutex);
+    m_timestamps = false;
+    m_write_start = std::chrono::steady_clock::time_point();
+    m_outq.set_timestamps(false);
+  }
 
-  // the following four methods can be called concurrently
   auto get_output_queue_stats() const noexcept {
     lk_guard lg(m_mutex);
-    return m_outq.get_queue_stats();
+    auto st = m_outq.get_queue_stats();
+    if (m_write_in_progress && m_write_start != std::chrono::steady_clock::time_point()) {
+      st.write_in_progress_duration = std::chrono::steady_clock::now() - m_write_start;
+    }
+    return st;
+  }
+
+  // discard queued elements, the write in progress (if any) is not affected; returns
+  // the number of elements discarded
+  std::size_t clear_queue() {
+    drain_watchers ready;
+    std::size_t cnt = 0u;
+    {
+      lk_guard lg(m_mutex);
+      cnt = m_outq.clear();
+      ready = take_drained();
+    }
+    notify(ready);
+    return cnt;
+  }
+
+  // func is invoked immediately (in the calling thread) if already drained, otherwise 
+  // from the thread completing the write that drains the queue
+  void notify_when_drained(std::size_t max_bytes, drain_func func) {
+    {
+      lk_guard lg(m_mutex);
+      if (!is_drained(max_bytes)) {
+        m_drain_watchers.push_back(drain_watcher { max_bytes, std::move(func) });
+        return;
+      }
+    }
+    func();
   }
 
   bool is_io_started() const noexcept {
@@ -85,9 +195,14 @@ public:
     return m_write_in_progress;
   }
 
-  void clear() noexcept {
-    lk_guard lg(m_mutex);
-    do_clear();
+  void clear() {
+    drain_watchers ready;
+    {
+      lk_guard lg(m_mutex);
+      do_clear();
+      ready.swap(m_drain_watchers);
+    }
+    notify(ready);
   }
 
   // func is the code that performs actual write, typically async_write or
@@ -103,26 +218,60 @@ public:
       m_outq.add_element(elem);
       return queued;
     }
-    m_write_in_progress = true;
-    func(elem);
+    do_write(elem, func);
     return write_started;
   }
 
-  template <typename F>
-  void write_next_elem(F&& func) {
+  // enqueue a range of elements under one lock acquisition, starting at most one write;
+  // proj converts each range element to E, and the number of elements accepted is 
+  // returned (0 if IO is stopped)
+  template <typename R, typename P, typename F>
+  std::size_t start_write_batch(const R& range, P&& proj, F&& func) {
     lk_guard lg(m_mutex);
-    if (!m_io_started) { // shutting down
+    if (!m_io_started) {
       do_clear();
-      return;
+      return 0u;
     }
-    auto elem = m_outq.get_next_element();
-    if (!elem) {
-      m_write_in_progress = false;
-      return;
+    std::size_t cnt = 0u;
+    std::optional<E> first { };
+    for (const auto& r : range) {
+      if (cnt == 0u && !m_write_in_progress) {
+        first.emplace(proj(r)); // written directly, not queued
+      }
+      else {
+        m_outq.add_element(proj(r));
+      }
+      ++cnt;
     }
-    m_write_in_progress = true;
-    func(*elem);
-    return;
+    if (first) {
+      do_write(*first, func);
+    }
+    return cnt;
+  }
+
+  // called when a write completes, drain watchers are notified when the queue has
+  // drained to their threshold
+  template <typename F>
+  void write_next_elem(F&& func) {
+    drain_watchers ready;
+    {
+      lk_guard lg(m_mutex);
+      if (!m_io_started) { // shutting down
+        do_clear();
+        ready.swap(m_drain_watchers);
+      }
+      else {
+        auto elem = m_outq.get_next_element();
+        if (!elem) {
+          m_write_in_progress = false;
+        }
+        else {
+          do_write(*elem, func);
+        }
+        ready = take_drained();
+      }
+    }
+    notify(ready);
   }
 
 };
@@ -8,6 +8,13 @@
  *  The state machine for a net entity object is unstarted, started, stopped,
  *  currently implemented within this class by a @c std::atomic_int.
  *
+ *  The @c start and @c stop methods (and the @c visit_io_output methods of the net
+ *  entities, through @c run_in_executor) run the actual work in the context of the 
+ *  entity executor. The blocking forms wait for the result, except when called from a
+ *  thread already running the executor, where the work is performed directly (waiting 
+ *  would deadlock). The completion handler forms do not block, the completion handler 
+ *  is invoked with the result in the context of the executor.
+ *
  *  Once an entity is stopped it is not allowed to be started again. This may
  *  change in the future, but internal designs would have to change to allow
  *  each net entity to completely transition through all of its shutdown operations
@@ -28,6 +35,7 @@
 #define NET_ENTITY_COMMON_HPP_INCLUDED
 
 #include "asio/any_io_executor.hpp"
+#include "asio/io_context.hpp"
 #include "asio/post.hpp"
 
 #include <atomic>
@@ -45,6 +53,38 @@ namespace chops {
 namespace net {
 namespace detail {
 
+// true if the calling thread is running the io_context of the executor
+inline bool running_in_executor(const asio::any_io_executor& exec) noexcept {
+  auto p = exec.target<asio::io_context::executor_type>();
+  return p && p->running_in_this_thread();
+}
+
+// invoke func in the context of the executor and return the result, blocking until 
+// func has run
+template <typename R, typename F>
+R run_in_executor(const asio::any_io_executor& exec, F&& func) {
+  if (running_in_executor(exec)) {
+    return func();
+  }
+  std::promise<R> prom;
+  auto fut = prom.get_future();
+  asio::post(exec, [&func, p = std::move(prom)] () mutable {
+      p.set_value(func());
+    }
+  );
+  return fut.get();
+}
+
+// invoke func in the context of the executor without blocking, then invoke the 
+// completion handler with the result
+template <typename F, typename CH>
+void post_to_executor(const asio::any_io_executor& exec, F&& func, CH&& completion) {
+  asio::post(exec, [f = std::forward<F>(func), ch = std::forward<CH>(completion)] () mutable {
+      ch(f());
+    }
+  );
+}
+
 template <typename IOT>
 class net_entity_common {
 public:
@@ -83,14 +123,24 @@ public:
     }
     m_io_state_chg_cb = io_state_chg_func;
     m_error_cb = err_func;
-    std::promise<std::error_code> prom;
-    auto fut = prom.get_future();
     // start network entity processing in context of executor thread
-    asio::post(exec, [&start_func, p = std::move(prom)] () mutable {
-        p.set_value(start_func());
-      }
-    );
-    return fut.get();
+    return run_in_executor<std::error_code>(exec, start_func);
+  }
+
+  // non-blocking start, an error is returned if already started, otherwise the 
+  // completion handler is invoked with the result of start_func
+  template <typename F1, typename F2, typename SF, typename CH>
+  std::error_code start(F1&& io_state_chg_func, F2&& err_func, 
+                        const asio::any_io_executor& exec,
+                        SF&& start_func, CH&& completion) {
+    int expected = 0;
+    if (!m_started.compare_exchange_strong(expected, 1)) {
+      return std::make_error_code(net_ip_errc::net_entity_already_started);
+    }
+    m_io_state_chg_cb = io_state_chg_func;
+    m_error_cb = err_func;
+    post_to_executor(exec, std::forward<SF>(start_func), std::forward<CH>(completion));
+    return { };
   }
  
 
@@ -101,14 +151,19 @@ public:
     if (!m_started.compare_exchange_strong(expected, 2)) {
       return std::make_error_code(net_ip_errc::net_entity_already_stopped);
     }
-    std::promise<std::error_code> prom;
-    auto fut = prom.get_future();
     // start closing in context of executor thread
-    asio::post(exec, [&stop_func, p = std::move(prom)] () mutable {
-        p.set_value(stop_func());
-      }
-    );
-    return fut.get();
+    return run_in_executor<std::error_code>(exec, stop_func);
+  }
+
+  template <typename SF, typename CH>
+  std::error_code stop(const asio::any_io_executor& exec,
+                       SF&& stop_func, CH&& completion) {
+    int expected = 1;
+    if (!m_started.compare_exchange_strong(expected, 2)) {
+      return std::make_error_code(net_ip_errc::net_entity_already_stopped);
+    }
+    post_to_executor(exec, std::forward<SF>(stop_func), std::forward<CH>(completion));
+    return { };
   }
 
   void call_io_state_chg_cb(std::shared_ptr<IOT> p, std::size_t sz, bool starting) {
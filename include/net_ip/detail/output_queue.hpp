@@ -27,6 +27,7 @@
 #include <queue>
 #include <cstddef> // std::size_t
 #include <optional>
+#include <chrono>
 
 #include "net_ip/queue_stats.hpp"
 
@@ -35,13 +36,22 @@ namespace net {
 namespace detail {
 
 // template parameter E is instantiated as either a shared_buffer or a shared_buffer and 
-// endpoint, depending on IO handler; a size() method is expected for E
+// endpoint, depending on IO handler; a size() method is expected for E; when time stamps
+// are enabled each element is time stamped when queued so that the age of the oldest 
+// element can be reported, otherwise the age is reported as zero
 template <typename E>
 class output_queue {
 private:
+  using time_point = std::chrono::steady_clock::time_point;
 
-  std::queue<E>       m_output_queue;
-  std::size_t         m_current_num_bytes;
+  struct queued_elem {
+    E             m_elem;
+    time_point    m_queued;
+  };
+
+  std::queue<queued_elem>   m_output_queue;
+  std::size_t               m_current_num_bytes;
+  bool                      m_timestamps;
 
   // std::size_t         m_queue_size;
   // std::size_t         m_total_bufs_sent;
@@ -49,31 +59,47 @@ private:
 
 public:
 
-  output_queue() noexcept : m_output_queue(), m_current_num_bytes(0u) { }
+  output_queue() noexcept : m_output_queue(), m_current_num_bytes(0u), m_timestamps(false) { }
+
+  void set_timestamps(bool on) noexcept { m_timestamps = on; }
 
   // io handlers call this method to get next buffer of data, can be empty
   std::optional<E> get_next_element() {
     if (m_output_queue.empty()) {
       return std::optional<E> { };
     }
-    E elem = m_output_queue.front();
+    E elem = m_output_queue.front().m_elem;
     m_output_queue.pop();
     m_current_num_bytes -= elem.size();
     return std::optional<E> {elem};
   }
 
   void add_element(const E& element) {
-    m_output_queue.push(element);
+    m_output_queue.push(queued_elem { element, 
+                                      m_timestamps ? std::chrono::steady_clock::now() : time_point() });
     m_current_num_bytes += element.size(); // note - possible integer overflow
   }
 
+  std::size_t num_bytes() const noexcept { return m_current_num_bytes; }
+
   chops::net::output_queue_stats get_queue_stats() const noexcept {
-    return chops::net::output_queue_stats { m_output_queue.size(), m_current_num_bytes };
+    chops::net::output_queue_stats st { m_output_queue.size(), m_current_num_bytes };
+    // elements queued before time stamps were enabled are not time stamped
+    if (!m_output_queue.empty() && m_output_queue.front().m_queued != time_point()) {
+      st.oldest_queued_age = std::chrono::steady_clock::now() - m_output_queue.front().m_queued;
+    }
+    return st;
   }
 
-  void clear() noexcept {
-    std::queue<E>().swap(m_output_queue);
+  // returns the number of elements discarded; elements are popped rather than swapping
+  // in a new container, since constructing a std::deque may allocate
+  std::size_t clear() noexcept {
+    auto sz = m_output_queue.size();
+    while (!m_output_queue.empty()) {
+      m_output_queue.pop();
+    }
     m_current_num_bytes = 0u;
+    return sz;
   }
 
 };
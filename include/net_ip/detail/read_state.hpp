@@ -0,0 +1,71 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Storage for the message handler and message frame function objects used by
+ *  the read processing of the IO handlers.
+ *
+ *  The message handler and message frame are supplied in the @c start_io call and are
+ *  needed for every read until IO processing stops. Instead of moving them into each
+ *  completion handler, they are stored once in a @c read_state object owned by the IO
+ *  handler, and the completion handlers only carry a pointer to it. This keeps the
+ *  completion handlers small (and within the recycled handler memory) no matter how
+ *  much state the application keeps in the message handler.
+ *
+ *  The IO handler classes are not templates, so the object is owned through a pointer
+ *  to a base class; the concrete type is only needed by the read functions, which are
+ *  templates on the function object types.
+ *
+ *  @note For internal use only.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef READ_STATE_HPP_INCLUDED
+#define READ_STATE_HPP_INCLUDED
+
+#include <memory> // std::unique_ptr
+#include <utility> // std::forward
+
+namespace chops {
+namespace net {
+namespace detail {
+
+class read_state_base {
+public:
+  virtual ~read_state_base() = default;
+};
+
+using read_state_ptr = std::unique_ptr<read_state_base>;
+
+// placeholder for a read_state member that is not needed by a particular read
+struct no_read_data { };
+
+// MH is the message handler type, MF the message frame type and D any additional
+// data needed by every read (e.g. the delimiter for delimiter based reads)
+template <typename MH, typename MF, typename D>
+class read_state : public read_state_base {
+public:
+  MH    m_msg_hdlr;
+  MF    m_msg_frame;
+  D     m_data;
+
+public:
+  template <typename H, typename F, typename T>
+  read_state(H&& msg_hdlr, F&& msg_frame, T&& data) :
+    m_msg_hdlr(std::forward<H>(msg_hdlr)), m_msg_frame(std::forward<F>(msg_frame)),
+    m_data(std::forward<T>(data)) { }
+};
+
+} // end detail namespace
+} // end net namespace
+} // end chops namespace
+
+#endif
+
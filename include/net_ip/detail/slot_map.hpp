@@ -0,0 +1,176 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Container with O(1) insert and erase through stable keys, and contiguous
+ *  storage for iteration.
+ *
+ *  Keys combine a slot index with a generation count, so a key for an erased element
+ *  will never find a later element that re-uses the same slot. Erase moves the last
+ *  element into the erased position, so element order is not preserved and iterators
+ *  and references are invalidated by both insert and erase.
+ *
+ *  There is no concurrency protection in this class.
+ *
+ *  @note For internal use only.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef SLOT_MAP_HPP_INCLUDED
+#define SLOT_MAP_HPP_INCLUDED
+
+#include <vector>
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <cstddef> // std::size_t
+#include <utility> // std::move
+
+namespace chops {
+namespace net {
+namespace detail {
+
+template <typename T>
+class slot_map {
+public:
+  using key_type = std::uint64_t;
+  using iterator = typename std::vector<T>::iterator;
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  // generations start at 1, so a zero key never refers to an element
+  static constexpr key_type invalid_key = 0u;
+
+private:
+  static constexpr std::uint32_t no_free_slot = 0xFFFFFFFFu;
+
+  struct slot {
+    // index into m_values when in use, otherwise the next free slot
+    std::uint32_t  m_idx;
+    std::uint32_t  m_gen;
+  };
+
+  std::vector<T>              m_values;
+  std::vector<std::uint32_t>  m_value_slots; // slot index for each element in m_values
+  std::vector<slot>           m_slots;
+  std::uint32_t               m_free_head;
+
+public:
+
+  slot_map() : m_values(), m_value_slots(), m_slots(), m_free_head(no_free_slot) { }
+
+  void reserve(std::size_t n) {
+    m_values.reserve(n);
+    m_value_slots.reserve(n);
+    m_slots.reserve(n);
+  }
+
+  key_type insert(T val) {
+    std::uint32_t s_idx = m_free_head;
+    if (s_idx == no_free_slot) {
+      s_idx = static_cast<std::uint32_t>(m_slots.size());
+      m_slots.push_back(slot{0u, 1u});
+    }
+    else {
+      m_free_head = m_slots[s_idx].m_idx;
+    }
+    m_slots[s_idx].m_idx = static_cast<std::uint32_t>(m_values.size());
+    m_values.push_back(std::move(val));
+    m_value_slots.push_back(s_idx);
+    return make_key(s_idx, m_slots[s_idx].m_gen);
+  }
+
+  T* find(key_type key) noexcept {
+    auto s = lookup(key);
+    return s ? &m_values[s->m_idx] : nullptr;
+  }
+
+  const T* find(key_type key) const noexcept {
+    auto s = const_cast<slot_map*>(this)->lookup(key);
+    return s ? &m_values[s->m_idx] : nullptr;
+  }
+
+  bool erase(key_type key) {
+    auto s = lookup(key);
+    if (!s) {
+      return false;
+    }
+    std::uint32_t v_idx = s->m_idx;
+    std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1u);
+    if (v_idx != last) {
+      m_values[v_idx] = std::move(m_values[last]);
+      m_value_slots[v_idx] = m_value_slots[last];
+      m_slots[m_value_slots[v_idx]].m_idx = v_idx;
+    }
+    m_values.pop_back();
+    m_value_slots.pop_back();
+    // bump the generation so outstanding keys no longer match, then add to free list
+    std::uint32_t s_idx = static_cast<std::uint32_t>(s - m_slots.data());
+    ++s->m_gen;
+    if (s->m_gen == 0u) {
+      s->m_gen = 1u;
+    }
+    s->m_idx = m_free_head;
+    m_free_head = s_idx;
+    return true;
+  }
+
+  void clear() {
+    for (std::uint32_t i = 0u; i < m_value_slots.size(); ++i) {
+      auto& s = m_slots[m_value_slots[i]];
+      ++s.m_gen;
+      if (s.m_gen == 0u) {
+        s.m_gen = 1u;
+      }
+      s.m_idx = m_free_head;
+      m_free_head = m_value_slots[i];
+    }
+    m_values.clear();
+    m_value_slots.clear();
+  }
+
+  std::size_t size() const noexcept { return m_values.size(); }
+  bool empty() const noexcept { return m_values.empty(); }
+
+  // element access by position, valid for 0 <= i < size()
+  T& operator[](std::size_t i) noexcept { return m_values[i]; }
+  const T& operator[](std::size_t i) const noexcept { return m_values[i]; }
+
+  iterator begin() noexcept { return m_values.begin(); }
+  iterator end() noexcept { return m_values.end(); }
+  const_iterator begin() const noexcept { return m_values.cbegin(); }
+  const_iterator end() const noexcept { return m_values.cend(); }
+
+private:
+
+  static key_type make_key(std::uint32_t s_idx, std::uint32_t gen) noexcept {
+    return (static_cast<key_type>(gen) << 32) | s_idx;
+  }
+
+  slot* lookup(key_type key) noexcept {
+    auto s_idx = static_cast<std::uint32_t>(key & 0xFFFFFFFFu);
+    auto gen = static_cast<std::uint32_t>(key >> 32);
+    if (s_idx >= m_slots.size() || m_slots[s_idx].m_gen != gen) {
+      return nullptr;
+    }
+    // a free slot has the same generation as the next key that will be issued,
+    // which is only a match if the slot is in use
+    auto& s = m_slots[s_idx];
+    if (s.m_idx >= m_values.size() || m_value_slots[s.m_idx] != s_idx) {
+      return nullptr;
+    }
+    return &s;
+  }
+
+};
+
+} // end detail namespace
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -21,6 +21,9 @@
 #include "asio/ip/tcp.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
+#include "asio/dispatch.hpp"
+#include "asio/socket_base.hpp"
+#include "asio/steady_timer.hpp"
 
 #include <system_error>
 #include <memory>// std::shared_ptr, std::weak_ptr
@@ -32,10 +35,17 @@
 #include <string_view>
 #include <future>
 #include <chrono>
+#include <atomic>
+#include <algorithm> // std::min_element
+#include <iterator> // std::distance
 
 #include "net_ip/endpoints_resolver.hpp"
+#include "net_ip/tcp_acceptor_options.hpp"
+#include "net_ip/socket_option.hpp"
 #include "net_ip/detail/tcp_io.hpp"
 #include "net_ip/detail/net_entity_common.hpp"
+#include "net_ip/detail/slot_map.hpp"
+#include "net_ip/detail/tcp_io_pool.hpp"
 
 #include "net_ip/basic_io_output.hpp"
 
@@ -43,33 +53,89 @@ namespace chops {
 namespace net {
 namespace detail {
 
+#if defined(SO_REUSEPORT)
+using reuse_port_option = int_socket_option<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+#if defined(TCP_FASTOPEN)
+using fast_open_option = int_socket_option<IPPROTO_TCP, TCP_FASTOPEN>;
+#endif
+#if defined(TCP_DEFER_ACCEPT)
+using defer_accept_option = int_socket_option<IPPROTO_TCP, TCP_DEFER_ACCEPT>;
+#endif
+
 class tcp_acceptor : public std::enable_shared_from_this<tcp_acceptor> {
 public:
   using endpoint_type = asio::ip::tcp::endpoint;
 
+private:
+  using acceptors = std::vector<asio::ip::tcp::acceptor>;
+
+  struct io_handler_entry {
+    tcp_io_shared_ptr  m_iop;
+    std::size_t        m_ioc_idx;
+  };
+  // O(1) insert and removal, even with a very large number of connections
+  using io_handler_map = slot_map<io_handler_entry>;
+
 private:
   net_entity_common<tcp_io>         m_entity_common;
   asio::io_context&                 m_ioc;
-  asio::ip::tcp::acceptor           m_acceptor;
-  std::vector<tcp_io_shared_ptr>    m_io_handlers;
+  // one listening socket, unless SO_REUSEPORT sharding is requested, in which case
+  // each listening socket uses a separate io_context
+  acceptors                         m_acceptors;
+  io_handler_map                    m_io_handlers;
+  // io_context pool for accepted connections, used with a single listening socket
+  io_context_refs                   m_conn_iocs;
+  connection_dispatch               m_conn_dispatch;
+  // open connections per io_context (either per listening socket or per pool entry)
+  std::vector<std::size_t>          m_conn_counts;
+  std::size_t                       m_next_conn_ioc;
+  tcp_io_pool_shared_ptr            m_io_pool; // empty if no pooling of tcp_io objects
+  // admission control, a token bucket for the accept rate plus a connection limit
+  std::size_t                       m_max_conns;
+  double                            m_accept_rate;
+  double                            m_accept_burst;
+  double                            m_accept_tokens;
+  std::chrono::steady_clock::time_point m_last_refill;
+  excess_connection_policy          m_excess_policy;
+  std::vector<bool>                 m_paused; // per listening socket
+  asio::steady_timer                m_resume_timer;
+  bool                              m_resume_timer_set;
+  int                               m_fast_open_qlen;
+  std::chrono::seconds              m_defer_accept;
+  endpoints_resolver<asio::ip::tcp> m_resolver;
   endpoint_type                     m_acceptor_endp;
   std::string                       m_local_port_or_service;
   std::string                       m_listen_intf;
   bool                              m_reuse_addr;
-  bool                              m_shutting_down;
+  std::atomic_bool                  m_shutting_down;
 
 public:
   tcp_acceptor(asio::io_context& ioc, const endpoint_type& endp,
-               bool reuse_addr) :
-    m_entity_common(), m_ioc(ioc), m_acceptor(ioc), m_io_handlers(), m_acceptor_endp(endp), 
-    m_local_port_or_service(), m_listen_intf(),
-    m_reuse_addr(reuse_addr), m_shutting_down(false) { }
+               bool reuse_addr, const tcp_acceptor_options& opts = tcp_acceptor_options()) :
+    tcp_acceptor(ioc, endp, std::string_view(), std::string_view(), reuse_addr, opts) { }
 
   tcp_acceptor(asio::io_context& ioc, 
                std::string_view local_port_or_service, std::string_view listen_intf,
-               bool reuse_addr) :
-    m_entity_common(), m_ioc(ioc), m_acceptor(ioc), m_io_handlers(), m_acceptor_endp(), 
-    m_local_port_or_service(local_port_or_service), m_listen_intf(listen_intf),
+               bool reuse_addr, const tcp_acceptor_options& opts = tcp_acceptor_options()) :
+    tcp_acceptor(ioc, endpoint_type(), local_port_or_service, listen_intf, reuse_addr, opts) { }
+
+private:
+  tcp_acceptor(asio::io_context& ioc, const endpoint_type& endp,
+               std::string_view local_port_or_service, std::string_view listen_intf,
+               bool reuse_addr, const tcp_acceptor_options& opts) :
+    m_entity_common(), m_ioc(ioc), m_acceptors(make_acceptors(ioc, opts)), m_io_handlers(), 
+    m_conn_iocs(opts.reuse_port_io_contexts.empty() ? opts.connection_io_contexts : io_context_refs()),
+    m_conn_dispatch(opts.dispatch), 
+    m_conn_counts(std::max(m_acceptors.size(), m_conn_iocs.size()), 0u), m_next_conn_ioc(0u),
+    m_io_pool(make_io_pool(ioc, opts)),
+    m_max_conns(opts.max_connections), m_accept_rate(opts.accept_rate), 
+    m_accept_burst(std::max(opts.accept_burst, 1.0)), m_accept_tokens(m_accept_burst),
+    m_last_refill(std::chrono::steady_clock::now()), m_excess_policy(opts.excess_policy),
+    m_paused(m_acceptors.size(), false), m_resume_timer(ioc), m_resume_timer_set(false),
+    m_fast_open_qlen(opts.fast_open_queue_len), m_defer_accept(opts.defer_accept),
+    m_resolver(ioc, opts.endpoints_cache),
+    m_acceptor_endp(endp), m_local_port_or_service(local_port_or_service), m_listen_intf(listen_intf),
     m_reuse_addr(reuse_addr), m_shutting_down(false) { }
 
 private:
@@ -79,99 +145,204 @@ private:
   tcp_acceptor& operator=(const tcp_acceptor&) = delete;
   tcp_acceptor& operator=(tcp_acceptor&&) = delete;
 
+  static acceptors make_acceptors(asio::io_context& ioc, const tcp_acceptor_options& opts) {
+    acceptors accs;
+    if (opts.reuse_port_io_contexts.empty()) {
+      accs.emplace_back(ioc);
+      return accs;
+    }
+    accs.reserve(opts.reuse_port_io_contexts.size());
+    for (auto& ioc_ref : opts.reuse_port_io_contexts) {
+      accs.emplace_back(ioc_ref.get());
+    }
+    return accs;
+  }
+
+  static tcp_io_pool_shared_ptr make_io_pool(asio::io_context& ioc, const tcp_acceptor_options& opts) {
+    return opts.io_handler_pool_size == 0u ? tcp_io_pool_shared_ptr() :
+             std::make_shared<tcp_io_pool>(ioc, opts.io_handler_pool_size);
+  }
+
 public:
 
   bool is_started() const noexcept { return m_entity_common.is_started(); }
 
+  tcp_io_pool_stats get_io_handler_pool_stats() const noexcept {
+    return m_io_pool ? m_io_pool->get_stats() : tcp_io_pool_stats();
+  }
+
   template <typename F>
   void visit_socket(F&& f) {
-    f(m_acceptor);
+    for (auto& acc : m_acceptors) {
+      f(acc);
+    }
   }
 
   template <typename F>
   std::size_t visit_io_output(F&& func) {
     auto self = shared_from_this();
-    std::promise<std::size_t> prom;
-    auto fut = prom.get_future();
-    // send to executor for concurrency protection
-    asio::post(m_ioc, [this, self, &func, p = std::move(prom)] () mutable {
-        std::size_t sum = 0u;
-        if (m_shutting_down) {
-          p.set_value(sum);
-          return;
-        }
-        for (auto& ioh : m_io_handlers) {
-          if (ioh->is_io_started()) {
-            func(basic_io_output<tcp_io>(ioh));
-            sum += 1u;
-          }
-        }
-        p.set_value(sum);
-      }
-    );
-    return fut.get();
+    // run in executor for concurrency protection
+    return run_in_executor<std::size_t>(m_ioc.get_executor(), 
+             [this, self, &func] () { return do_visit_io_output(func); } );
+  }
+
+  // non-blocking, the completion handler is invoked with the visit count
+  template <typename F, typename CH>
+  void visit_io_output(F&& func, CH&& completion) {
+    auto self = shared_from_this();
+    post_to_executor(m_ioc.get_executor(), 
+             [this, self, f = std::forward<F>(func)] () mutable { return do_visit_io_output(f); },
+             std::forward<CH>(completion));
   }
 
   template <typename F1, typename F2>
   std::error_code start(F1&& io_state_chg, F2&& err_func) {
     auto self = shared_from_this();
     return m_entity_common.start(std::forward<F1>(io_state_chg), std::forward<F2>(err_func),
-                                 m_acceptor.get_executor(),
+                                 m_ioc.get_executor(),
              [this, self] () { return do_start(); } );
   }
+
+  template <typename F1, typename F2, typename CH>
+  std::error_code start(F1&& io_state_chg, F2&& err_func, CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.start(std::forward<F1>(io_state_chg), std::forward<F2>(err_func),
+                                 m_ioc.get_executor(),
+             [this, self] () { return do_start(); }, std::forward<CH>(completion) );
+  }
                                 
   std::error_code stop() {
     auto self = shared_from_this();
-    return m_entity_common.stop(m_acceptor.get_executor(),
-             [this, self] () {
-               close(std::make_error_code(net_ip_errc::tcp_acceptor_stopped));
-               return std::error_code();
-             }
-    );
+    return m_entity_common.stop(m_ioc.get_executor(),
+             [this, self] () { return do_stop(); } );
+  }
+
+  template <typename CH>
+  std::error_code stop(CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.stop(m_ioc.get_executor(),
+             [this, self] () { return do_stop(); }, std::forward<CH>(completion) );
   }
 
 private:
 
+  template <typename F>
+  std::size_t do_visit_io_output(F& func) {
+    std::size_t sum = 0u;
+    if (m_shutting_down) {
+      return sum;
+    }
+    for (auto& e : m_io_handlers) {
+      if (e.m_iop->is_io_started()) {
+        func(basic_io_output<tcp_io>(e.m_iop));
+        sum += 1u;
+      }
+    }
+    return sum;
+  }
+
+  std::error_code do_stop() {
+    close(std::make_error_code(net_ip_errc::tcp_acceptor_stopped));
+    return { };
+  }
+
   std::error_code do_start() {
     if (!m_local_port_or_service.empty()) {
-      endpoints_resolver<asio::ip::tcp> resolver(m_ioc);
-      auto ret = resolver.make_endpoints(true, m_listen_intf, m_local_port_or_service);
+      auto ret = m_resolver.try_make_endpoints(true, m_listen_intf, m_local_port_or_service);
       if (!ret) {
-        close(ret.error());
-        return ret.error();
+        // a name lookup is needed, finish starting when it completes; errors are 
+        // reported through the error callback
+        auto self = shared_from_this();
+        m_resolver.make_endpoints(true, m_listen_intf, m_local_port_or_service,
+          [this, self] (const std::error_code& err, asio::ip::tcp::resolver::results_type res) {
+            if (m_shutting_down) {
+              return;
+            }
+            if (err) {
+              close(err);
+              return;
+            }
+            set_local_endpoint(res);
+            start_listeners();
+          }
+        );
+        return { };
+      }
+      set_local_endpoint(*ret);
+    }
+    return start_listeners();
+  }
+
+  void set_local_endpoint(const asio::ip::tcp::resolver::results_type& res) {
+    m_acceptor_endp = res.cbegin()->endpoint();
+    m_local_port_or_service.clear();
+    m_local_port_or_service.shrink_to_fit();
+    m_listen_intf.clear();
+    m_listen_intf.shrink_to_fit();
+  }
+
+  std::error_code start_listeners() {
+    for (auto& acc : m_acceptors) {
+      auto ec = open_listener(acc);
+      if (ec) {
+        close(ec);
+        return ec;
       }
-      m_acceptor_endp = ret->cbegin()->endpoint();
-      m_local_port_or_service.clear();
-      m_local_port_or_service.shrink_to_fit();
-      m_listen_intf.clear();
-      m_listen_intf.shrink_to_fit();
     }
+    for (std::size_t i = 0u; i < m_acceptors.size(); ++i) {
+      arm_listener(i);
+    }
+    return { };
+  }
+
+  std::error_code open_listener(asio::ip::tcp::acceptor& acc) {
     std::error_code ec;
-    m_acceptor.open(m_acceptor_endp.protocol(), ec);
+    acc.open(m_acceptor_endp.protocol(), ec);
     if (ec) {
-      close(ec);
       return ec;
     }
     if (m_reuse_addr) {
-      m_acceptor.set_option(asio::socket_base::reuse_address(true), ec);
+      acc.set_option(asio::socket_base::reuse_address(true), ec);
       if (ec) {
-        close(ec);
         return ec;
       }
     }
-    m_acceptor.bind(m_acceptor_endp, ec);
-    if (ec) {
-      close(ec);
-      return ec;
+    if (m_acceptors.size() > 1u) {
+#if defined(SO_REUSEPORT)
+      acc.set_option(reuse_port_option(1), ec);
+      if (ec) {
+        return ec;
+      }
+#else
+      return std::make_error_code(std::errc::operation_not_supported);
+#endif
     }
-    m_acceptor.listen(asio::socket_base::max_listen_connections, ec);
+    acc.bind(m_acceptor_endp, ec);
     if (ec) {
-      close(ec);
       return ec;
     }
-
-    start_accept();
-    return { };
+    if (m_fast_open_qlen > 0) {
+#if defined(TCP_FASTOPEN)
+      acc.set_option(fast_open_option(m_fast_open_qlen), ec);
+      if (ec) {
+        return ec;
+      }
+#else
+      return std::make_error_code(std::errc::operation_not_supported);
+#endif
+    }
+    if (m_defer_accept.count() > 0) {
+#if defined(TCP_DEFER_ACCEPT)
+      acc.set_option(defer_accept_option(static_cast<int>(m_defer_accept.count())), ec);
+      if (ec) {
+        return ec;
+      }
+#else
+      return std::make_error_code(std::errc::operation_not_supported);
+#endif
+    }
+    acc.listen(asio::socket_base::max_listen_connections, ec);
+    return ec;
   }
 
   void close(const std::error_code& err) {
@@ -181,17 +352,43 @@ private:
     }
     m_shutting_down = true;
     m_entity_common.set_stopped(); // in case of internal call to close
-    // the following copy is important, since the notify_me modifies the 
-    // m_io_handlers container
-    auto iohs = m_io_handlers;
-    for (auto& i : iohs) {
-      i->stop_io();
+    // each tcp_io handler is stopped from its own executor (which may belong to another
+    // io_context), the registry entries are then removed by notify_me on the entity
+    // executor; a dispatch may run inline, so the handlers are copied out first
+    std::vector<tcp_io_shared_ptr> iops;
+    iops.reserve(m_io_handlers.size());
+    for (const auto& e : m_io_handlers) {
+      if (e.m_iop) {
+        iops.push_back(e.m_iop);
+      }
     }
-    // m_io_handlers.clear(); // the stop_io on each tcp_io handler should clear the container
-    std::error_code ec;
-    m_acceptor.close(ec);
-    if (ec) {
-      m_entity_common.call_error_cb(tcp_io_shared_ptr(), ec);
+    for (auto& iop : iops) {
+      auto ex = iop->get_executor();
+      asio::dispatch(ex, [iop = std::move(iop)] () {
+          iop->stop_io();
+        }
+      );
+    }
+    if (m_io_pool) {
+      m_io_pool->close(); // release pooled objects, the entity cannot be restarted
+    }
+    m_resume_timer.cancel();
+    m_resolver.cancel();
+    auto self = shared_from_this();
+    for (auto& acc : m_acceptors) {
+      // a listening socket is only closed from its own executor, any errors are 
+      // reported from the entity executor
+      asio::dispatch(acc.get_executor(), [this, self, &acc] () {
+          std::error_code ec;
+          acc.close(ec);
+          if (ec) {
+            asio::dispatch(m_ioc, [this, self, ec] () {
+                m_entity_common.call_error_cb(tcp_io_shared_ptr(), ec);
+              }
+            );
+          }
+        }
+      );
     }
     m_entity_common.call_error_cb(tcp_io_shared_ptr(), 
           std::make_error_code(net_ip_errc::tcp_acceptor_closed));
@@ -199,39 +396,192 @@ private:
 
 private:
 
-  void start_accept() {
-    using namespace std::placeholders;
-
+  // invoked from the executor of the listening socket, which is not the entity executor
+  // when SO_REUSEPORT sharding is in use
+  void start_accept(std::size_t idx) {
     if (m_shutting_down) {
       return;
     }
     auto self = shared_from_this();
-    m_acceptor.async_accept( [this, self] 
+    if (m_conn_iocs.empty()) {
+      m_acceptors[idx].async_accept( [this, self, idx] 
+              (const std::error_code& err, asio::ip::tcp::socket sock) {
+          handle_accept(err, std::move(sock), idx, idx);
+        }
+      );
+      return;
+    }
+    // single listening socket, on the entity executor, accepted socket uses the
+    // io_context chosen from the pool
+    auto ioc_idx = select_conn_io_context();
+    m_acceptors[idx].async_accept(m_conn_iocs[ioc_idx].get(), [this, self, idx, ioc_idx] 
             (const std::error_code& err, asio::ip::tcp::socket sock) {
-        if (err || m_shutting_down ) {
+        handle_accept(err, std::move(sock), idx, ioc_idx);
+      }
+    );
+  }
+
+  void handle_accept(const std::error_code& err, asio::ip::tcp::socket sock,
+                     std::size_t acc_idx, std::size_t ioc_idx) {
+    if (err || m_shutting_down ) {
+      return;
+    }
+    // when pausing is possible the next accept is decided after the admission check
+    bool gated = admission_enabled() && 
+                 m_excess_policy == excess_connection_policy::pause_accepting;
+    // the connection container and callbacks are only accessed through the entity
+    // executor; with a single listening socket this is invoked inline
+    asio::dispatch(m_ioc, [this, self = shared_from_this(), s = std::move(sock), 
+                           acc_idx, ioc_idx, gated] () mutable {
+        add_io_handler(std::move(s), ioc_idx);
+        if (gated) {
+          arm_listener(acc_idx);
+        }
+      }
+    );
+    if (!gated) {
+      start_accept(acc_idx);
+    }
+  }
+
+  // the following admission control methods are only invoked from the entity executor
+
+  bool admission_enabled() const noexcept {
+    return m_max_conns > 0u || m_accept_rate > 0.0;
+  }
+
+  void refill_accept_tokens() {
+    if (m_accept_rate <= 0.0) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - m_last_refill;
+    m_last_refill = now;
+    m_accept_tokens = std::min(m_accept_burst, m_accept_tokens + elapsed.count() * m_accept_rate);
+  }
+
+  bool can_accept() {
+    refill_accept_tokens();
+    return (m_max_conns == 0u || m_io_handlers.size() < m_max_conns) &&
+           (m_accept_rate <= 0.0 || m_accept_tokens >= 1.0);
+  }
+
+  bool take_accept_token() {
+    if (!can_accept()) {
+      return false;
+    }
+    if (m_accept_rate > 0.0) {
+      m_accept_tokens -= 1.0;
+    }
+    return true;
+  }
+
+  // start the next accept on a listening socket, or pause it if admission limits are reached
+  void arm_listener(std::size_t idx) {
+    if (m_shutting_down) {
+      return;
+    }
+    if (m_excess_policy == excess_connection_policy::pause_accepting && 
+        admission_enabled() && !can_accept()) {
+      if (!m_paused[idx]) {
+        m_paused[idx] = true;
+        m_entity_common.call_error_cb(tcp_io_shared_ptr(), 
+              std::make_error_code(net_ip_errc::tcp_acceptor_accept_deferred));
+      }
+      schedule_resume();
+      return;
+    }
+    m_paused[idx] = false;
+    // each async_accept must be initiated from the listening socket's own executor
+    asio::dispatch(m_acceptors[idx].get_executor(), 
+                   [this, self = shared_from_this(), idx] () { start_accept(idx); } );
+  }
+
+  void resume_listeners() {
+    for (std::size_t i = 0u; i < m_paused.size(); ++i) {
+      if (m_paused[i]) {
+        arm_listener(i);
+      }
+    }
+  }
+
+  // a pause due to the connection limit is resumed when a connection closes, a pause
+  // due to the accept rate is resumed when the next token is available
+  void schedule_resume() {
+    if (m_resume_timer_set || m_accept_rate <= 0.0 || m_accept_tokens >= 1.0) {
+      return;
+    }
+    std::chrono::duration<double> wait ((1.0 - m_accept_tokens) / m_accept_rate);
+    m_resume_timer_set = true;
+    m_resume_timer.expires_after(
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(wait));
+    m_resume_timer.async_wait([this, self = shared_from_this()] (const std::error_code& err) {
+        m_resume_timer_set = false;
+        if (err || m_shutting_down) {
           return;
         }
-        tcp_io_shared_ptr iop = std::make_shared<tcp_io>(std::move(sock), 
-          tcp_io::entity_notifier_cb(std::bind(&tcp_acceptor::notify_me, shared_from_this(), _1, _2)));
-        m_io_handlers.push_back(iop);
-        // make sure app doesn't do any strangeness during callback
-        // even if another accept completes, post order should invoke callback before next
-        // accept handler is invoked
-        asio::post(m_ioc, [this, self, iop] () {
-            m_entity_common.call_io_state_chg_cb(iop, m_io_handlers.size(), true);
-          }
-        );
-        start_accept();
+        resume_listeners();
+      }
+    );
+  }
+
+  std::size_t select_conn_io_context() {
+    if (m_conn_dispatch == connection_dispatch::least_connections) {
+      return static_cast<std::size_t>(std::distance(m_conn_counts.cbegin(), 
+               std::min_element(m_conn_counts.cbegin(), m_conn_counts.cend())));
+    }
+    auto i = m_next_conn_ioc;
+    m_next_conn_ioc = (m_next_conn_ioc + 1u) % m_conn_iocs.size();
+    return i;
+  }
+
+  void add_io_handler(asio::ip::tcp::socket sock, std::size_t ioc_idx) {
+    if (m_shutting_down) {
+      return; // socket closed on destruction
+    }
+    if (admission_enabled() && !take_accept_token()) {
+      // always the case for the accept and close policy, while the pause policy only
+      // gets here if multiple listening sockets completed an accept at the same time
+      std::error_code ec;
+      sock.close(ec);
+      m_entity_common.call_error_cb(tcp_io_shared_ptr(), 
+            std::make_error_code(net_ip_errc::tcp_acceptor_connection_rejected));
+      return;
+    }
+    // the registry key is captured by the notifier, so removal doesn't require a search
+    auto key = m_io_handlers.insert(io_handler_entry{tcp_io_shared_ptr(), ioc_idx});
+    tcp_io::entity_notifier_cb cb = [self = shared_from_this(), key] 
+                                        (std::error_code err, tcp_io_shared_ptr p) {
+      self->notify_me(err, p, key);
+    };
+    tcp_io_shared_ptr iop = m_io_pool ? m_io_pool->acquire(std::move(sock), std::move(cb)) :
+                                        std::make_shared<tcp_io>(std::move(sock), std::move(cb));
+    m_io_handlers.find(key)->m_iop = iop;
+    ++m_conn_counts[ioc_idx];
+    // make sure app doesn't do any strangeness during callback; the count is captured 
+    // now since with multiple listeners other accepts may complete before the post runs
+    asio::post(m_ioc, [this, self = shared_from_this(), iop, num = m_io_handlers.size()] () {
+        m_entity_common.call_io_state_chg_cb(iop, num, true);
       }
     );
   }
 
-  // this code invoked via a posted function object, allowing the TCP IO handler
-  // to completely shut down 
-  void notify_me(std::error_code err, tcp_io_shared_ptr iop) {
-    std::erase_if (m_io_handlers, [iop] (auto sp) { return iop == sp; } );
-    m_entity_common.call_error_cb(iop, err);
-    m_entity_common.call_io_state_chg_cb(iop, m_io_handlers.size(), false);
+  // invoked when the TCP IO handler has completely shut down, which may be from
+  // the thread running the IO handler executor
+  void notify_me(std::error_code err, tcp_io_shared_ptr iop, io_handler_map::key_type key) {
+    asio::dispatch(m_ioc, [this, self = shared_from_this(), err, iop, key] () {
+        auto e = m_io_handlers.find(key);
+        if (e) {
+          --m_conn_counts[e->m_ioc_idx];
+          m_io_handlers.erase(key);
+        }
+        m_entity_common.call_error_cb(iop, err);
+        m_entity_common.call_io_state_chg_cb(iop, m_io_handlers.size(), false);
+        if (admission_enabled()) {
+          resume_listeners();
+        }
+      }
+    );
   }
 
 };
@@ -30,6 +30,7 @@
 #include <memory>
 #include <chrono>
 #include <future>
+#include <algorithm> // std::max
 
 #include <cstddef> // for std::size_t
 
@@ -40,6 +41,8 @@
 
 #include "net_ip/endpoints_resolver.hpp"
 #include "net_ip/tcp_connector_timeout.hpp"
+#include "net_ip/tcp_connector_options.hpp"
+#include "net_ip/socket_option.hpp"
 
 // TCP connector has the most complicated states of any of the net entity detail
 // objects. The states transition from stopped to resolving addresses to connecting
@@ -55,6 +58,10 @@ namespace chops {
 namespace net {
 namespace detail {
 
+#if defined(TCP_FASTOPEN_CONNECT)
+using fast_open_connect_option = int_socket_option<IPPROTO_TCP, TCP_FASTOPEN_CONNECT>;
+#endif
+
 class tcp_connector : public std::enable_shared_from_this<tcp_connector> {
 public:
   using endpoint_type = asio::ip::tcp::endpoint;
@@ -64,6 +71,7 @@ private:
   using resolver_results = asio::ip::basic_resolver_results<asio::ip::tcp>;
   using endpoints = std::vector<endpoint_type>;
   using endpoints_iter = endpoints::const_iterator;
+  using sockets = std::vector<asio::ip::tcp::socket>;
 
 private:
   enum conn_state { stopped, resolving, connecting, connected, timeout, closing };
@@ -78,46 +86,82 @@ private:
   std::string                   m_remote_host;
   std::string                   m_remote_port;
   bool                          m_reconn_on_err;
+  bool                          m_re_resolve;
   tcp_connector_timeout_func    m_timeout_func;
   std::size_t                   m_conn_attempts;
   conn_state                    m_state;
+  bool                          m_fast_open;
+  bool                          m_happy_eyeballs;
+  std::chrono::milliseconds     m_attempt_delay;
+  std::chrono::milliseconds     m_connect_deadline;
+  // incremented for each connect attempt, and when a happy eyeballs race or deadline
+  // ends an attempt, so completion handlers from an earlier attempt are discarded
+  std::size_t                   m_attempt_gen;
+  // happy eyeballs connect attempts, m_race_sockets has one entry per endpoint attempted
+  // so far
+  asio::steady_timer            m_race_timer;
+  sockets                       m_race_sockets;
+  std::size_t                   m_race_pending;
+  std::error_code               m_race_err;
 
 public:
   template <typename Iter>
   tcp_connector(asio::io_context& ioc, 
                 Iter beg, Iter end,
                 tcp_connector_timeout_func tout_func,
-                bool reconn_on_err) :
+                bool reconn_on_err,
+                const tcp_connector_options& opts = tcp_connector_options()) :
       m_entity_common(),
       m_socket(ioc),
       m_io_handler(),
-      m_resolver(ioc),
+      m_resolver(ioc, opts.endpoints_cache),
       m_endpoints(beg, end),
       m_timer(ioc),
       m_remote_host(),
       m_remote_port(),
       m_reconn_on_err(reconn_on_err),
+      m_re_resolve(opts.re_resolve_on_reconnect),
       m_timeout_func(tout_func),
       m_conn_attempts(0u),
-      m_state(stopped)
+      m_state(stopped),
+      m_fast_open(opts.fast_open),
+      m_happy_eyeballs(opts.happy_eyeballs),
+      m_attempt_delay(opts.attempt_delay),
+      m_connect_deadline(opts.connect_deadline),
+      m_attempt_gen(0u),
+      m_race_timer(ioc),
+      m_race_sockets(),
+      m_race_pending(0u),
+      m_race_err()
     { }
 
   tcp_connector(asio::io_context& ioc,
                 std::string_view remote_port, std::string_view remote_host, 
                 tcp_connector_timeout_func tout_func,
-                bool reconn_on_err) :
+                bool reconn_on_err,
+                const tcp_connector_options& opts = tcp_connector_options()) :
       m_entity_common(),
       m_socket(ioc),
       m_io_handler(),
-      m_resolver(ioc),
+      m_resolver(ioc, opts.endpoints_cache),
       m_endpoints(),
       m_timer(ioc),
       m_remote_host(remote_host),
       m_remote_port(remote_port),
       m_reconn_on_err(reconn_on_err),
+      m_re_resolve(opts.re_resolve_on_reconnect),
       m_timeout_func(tout_func),
       m_conn_attempts(0u),
-      m_state(stopped)
+      m_state(stopped),
+      m_fast_open(opts.fast_open),
+      m_happy_eyeballs(opts.happy_eyeballs),
+      m_attempt_delay(opts.attempt_delay),
+      m_connect_deadline(opts.connect_deadline),
+      m_attempt_gen(0u),
+      m_race_timer(ioc),
+      m_race_sockets(),
+      m_race_pending(0u),
+      m_race_err()
     { }
 
 private:
@@ -139,20 +183,18 @@ public:
   template <typename F>
   std::size_t visit_io_output(F&& func) {
     auto self = shared_from_this();
-    std::promise<std::size_t> prom;
-    auto fut = prom.get_future();
-    // send to executor for concurrency protection
-    asio::post(m_socket.get_executor(), [this, self, &func, p = std::move(prom)] () mutable {
-        if (m_io_handler && m_io_handler->is_io_started()) {
-          func(basic_io_output<tcp_io>(m_io_handler));
-          p.set_value(1u);
-        }
-        else {
-          p.set_value(0u);
-        }
-      }
-    );
-    return fut.get();
+    // run in executor for concurrency protection
+    return run_in_executor<std::size_t>(m_socket.get_executor(), 
+             [this, self, &func] () { return do_visit_io_output(func); } );
+  }
+
+  // non-blocking, the completion handler is invoked with the visit count
+  template <typename F, typename CH>
+  void visit_io_output(F&& func, CH&& completion) {
+    auto self = shared_from_this();
+    post_to_executor(m_socket.get_executor(), 
+             [this, self, f = std::forward<F>(func)] () mutable { return do_visit_io_output(f); },
+             std::forward<CH>(completion));
   }
 
   template <typename F1, typename F2>
@@ -163,19 +205,44 @@ public:
              [this, self] () { return do_start(); } );
   }
 
+  template <typename F1, typename F2, typename CH>
+  std::error_code start(F1&& io_state_chg, F2&& err_cb, CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.start(std::forward<F1>(io_state_chg), std::forward<F2>(err_cb),
+                                 m_socket.get_executor(),
+             [this, self] () { return do_start(); }, std::forward<CH>(completion) );
+  }
+
   std::error_code stop() {
     auto self = shared_from_this();
     return m_entity_common.stop(m_socket.get_executor(),
-             [this, self] () {
-               close(std::make_error_code(net_ip_errc::tcp_connector_stopped));
-               return std::error_code();
-             }
-    );
+             [this, self] () { return do_stop(); } );
+  }
+
+  template <typename CH>
+  std::error_code stop(CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.stop(m_socket.get_executor(),
+             [this, self] () { return do_stop(); }, std::forward<CH>(completion) );
   }
 
 
 private:
 
+  template <typename F>
+  std::size_t do_visit_io_output(F& func) {
+    if (m_io_handler && m_io_handler->is_io_started()) {
+      func(basic_io_output<tcp_io>(m_io_handler));
+      return 1u;
+    }
+    return 0u;
+  }
+
+  std::error_code do_stop() {
+    close(std::make_error_code(net_ip_errc::tcp_connector_stopped));
+    return { };
+  }
+
   void clear_strings() noexcept {
     m_remote_host.clear(); // no longer need the string contents
     m_remote_host.shrink_to_fit();
@@ -184,32 +251,88 @@ private:
   }
 
   std::error_code do_start() {
+#if !defined(TCP_FASTOPEN_CONNECT)
+    if (m_fast_open) {
+      m_entity_common.set_stopped();
+      return std::make_error_code(std::errc::operation_not_supported);
+    }
+#endif
     // empty endpoints container is the indication that a resolve is needed
     if (m_endpoints.empty()) {
-      m_state = resolving;
-      m_entity_common.call_error_cb(tcp_io_shared_ptr(),
-                                    std::make_error_code(net_ip_errc::tcp_connector_resolving_addresses));
-      auto self = shared_from_this();
-      m_resolver.make_endpoints(false, m_remote_host, m_remote_port,
-        [this, self] 
-             (std::error_code err, resolver_results res) {
-          if (err || m_state != resolving) {
-            m_state = stopped;
+      start_resolve(m_timeout_func);
+      return { };
+    }
+    clear_strings();
+    order_endpoints();
+    start_connect(m_timeout_func);
+    return { };
+  }
+
+  // the remote host name and port are kept if re-resolving on reconnects, an empty port 
+  // indicates the connector was created with endpoints
+  void reconnect(tcp_connector_timeout_func tout_func) {
+    if (m_re_resolve && !m_remote_port.empty()) {
+      start_resolve(tout_func);
+      return;
+    }
+    start_connect(tout_func);
+  }
+
+  void start_resolve(tcp_connector_timeout_func tout_func) {
+    m_state = resolving;
+    m_entity_common.call_error_cb(tcp_io_shared_ptr(),
+                                  std::make_error_code(net_ip_errc::tcp_connector_resolving_addresses));
+    auto self = shared_from_this();
+    m_resolver.make_endpoints(false, m_remote_host, m_remote_port,
+      [this, self, tout_func] 
+           (std::error_code err, resolver_results res) {
+        if (m_state != resolving) {
+          return; // closed while resolving
+        }
+        if (err) {
+          if (m_endpoints.empty()) {
             close(err);
             return;
           }
+          // a failed re-resolution falls back to the previous endpoints
+          m_entity_common.call_error_cb(tcp_io_shared_ptr(), err);
+        }
+        else {
+          m_endpoints.clear();
           for (const auto& e : res) {
             m_endpoints.push_back(e.endpoint());
           }
-          clear_strings();
-          start_connect(m_timeout_func);
+          if (!m_re_resolve) {
+            clear_strings();
+          }
+          order_endpoints();
         }
-      );
-      return { };
+        start_connect(tout_func);
+      }
+    );
+  }
+
+  // RFC 8305 ordering for happy eyeballs, alternating address families starting with 
+  // the family of the first endpoint
+  void order_endpoints() {
+    if (!m_happy_eyeballs || m_endpoints.empty()) {
+      return;
+    }
+    auto first_family = m_endpoints.front().protocol();
+    endpoints first;
+    endpoints second;
+    for (const auto& e : m_endpoints) {
+      (e.protocol() == first_family ? first : second).push_back(e);
+    }
+    m_endpoints.clear();
+    for (std::size_t i = 0u; i < std::max(first.size(), second.size()); ++i) {
+      if (i < first.size()) {
+        m_endpoints.push_back(first[i]);
+      }
+      if (i < second.size()) {
+        m_endpoints.push_back(second[i]);
+      }
     }
-    clear_strings();
-    start_connect(m_timeout_func);
-    return { };
   }
 
   void close(const std::error_code& err) {
@@ -231,6 +354,8 @@ private:
       }
       case connecting: {
         // socket close should cancel any connect attempts
+        end_race();
+        m_timer.cancel(); // connect deadline
         break;
       }
       case connected: {
@@ -268,18 +393,160 @@ private:
   void start_connect(tcp_connector_timeout_func tout_func) {
     m_state = connecting;
     ++m_conn_attempts;
+    ++m_attempt_gen;
     m_entity_common.call_error_cb(tcp_io_shared_ptr(),
                                   std::make_error_code(net_ip_errc::tcp_connector_connecting));
+    if (m_connect_deadline.count() > 0) {
+      start_deadline(tout_func);
+    }
+    if (m_endpoints.empty()) {
+      handle_connect(std::make_error_code(std::errc::address_not_available), 
+                     m_endpoints.cend(), tout_func);
+      return;
+    }
+    if (m_happy_eyeballs && m_endpoints.size() > 1u) {
+      start_race(tout_func);
+      return;
+    }
+    connect_endpoint(m_endpoints.cbegin(), tout_func);
+  }
+
+  void open_socket(asio::ip::tcp::socket& sock, const endpoint_type& endp, std::error_code& ec) {
+    sock.close(ec);
+    sock.open(endp.protocol(), ec);
+#if defined(TCP_FASTOPEN_CONNECT)
+    if (!ec && m_fast_open) {
+      sock.set_option(fast_open_connect_option(1), ec);
+    }
+#endif
+  }
+
+  // each endpoint is tried in turn, equivalent to asio::async_connect with an endpoint
+  // sequence, except that socket options can be set before each connect
+  void connect_endpoint(endpoints_iter iter, tcp_connector_timeout_func tout_func) {
+    std::error_code ec;
+    open_socket(m_socket, *iter, ec);
+    if (ec) {
+      next_endpoint(ec, iter, tout_func);
+      return;
+    }
     auto self = shared_from_this();
-    asio::async_connect(m_socket, m_endpoints.cbegin(), m_endpoints.cend(),
-          [this, self, tout_func] 
-                (const std::error_code& err, endpoints_iter iter) {
+    m_socket.async_connect(*iter, [this, self, iter, gen = m_attempt_gen, tout_func] 
+                                        (const std::error_code& err) {
+        if (gen != m_attempt_gen || m_state != connecting) {
+          return;
+        }
+        if (err) {
+          next_endpoint(err, iter, tout_func);
+          return;
+        }
         handle_connect(err, iter, tout_func);
       }
     );
   }
 
-  void handle_connect (const std::error_code& err, endpoints_iter /* iter */,
+  void next_endpoint(const std::error_code& err, endpoints_iter iter,
+                     tcp_connector_timeout_func tout_func) {
+    if (++iter != m_endpoints.cend()) {
+      connect_endpoint(iter, tout_func);
+      return;
+    }
+    handle_connect(err, iter, tout_func);
+  }
+
+  void start_race(tcp_connector_timeout_func tout_func) {
+    m_race_sockets.clear();
+    m_race_sockets.reserve(m_endpoints.size());
+    m_race_pending = 0u;
+    m_race_err = std::error_code();
+    race_attempt(tout_func);
+  }
+
+  // start a connect attempt on the next endpoint, and if there are endpoints remaining,
+  // the timer for the attempt after that
+  void race_attempt(tcp_connector_timeout_func tout_func) {
+    auto self = shared_from_this();
+    while (m_race_sockets.size() < m_endpoints.size()) {
+      auto idx = m_race_sockets.size();
+      auto& sock = m_race_sockets.emplace_back(m_socket.get_executor());
+      std::error_code ec;
+      open_socket(sock, m_endpoints[idx], ec);
+      if (ec) {
+        m_race_err = ec;
+        continue;
+      }
+      ++m_race_pending;
+      sock.async_connect(m_endpoints[idx], [this, self, idx, gen = m_attempt_gen, tout_func] 
+                                                  (const std::error_code& err) {
+          handle_race_connect(err, idx, gen, tout_func);
+        }
+      );
+      if (m_race_sockets.size() < m_endpoints.size()) {
+        m_race_timer.expires_after(m_attempt_delay);
+        m_race_timer.async_wait([this, self, gen = m_attempt_gen, tout_func] 
+                                      (const std::error_code& err) {
+            if (err || gen != m_attempt_gen || m_state != connecting) {
+              return;
+            }
+            race_attempt(tout_func);
+          }
+        );
+      }
+      return;
+    }
+    if (m_race_pending == 0u) { // every attempt has failed
+      end_race();
+      handle_connect(m_race_err, m_endpoints.cend(), tout_func);
+    }
+  }
+
+  void handle_race_connect(const std::error_code& err, std::size_t idx, std::size_t gen,
+                           tcp_connector_timeout_func tout_func) {
+    if (gen != m_attempt_gen || m_state != connecting) {
+      return;
+    }
+    --m_race_pending;
+    if (err) {
+      // a failed attempt starts the next one without waiting for the delay
+      m_race_err = err;
+      race_attempt(tout_func);
+      return;
+    }
+    m_socket = std::move(m_race_sockets[idx]);
+    end_race();
+    handle_connect(err, m_endpoints.cbegin() + idx, tout_func);
+  }
+
+  // the m_timer retry wait is only used after the connect attempt completes, so the
+  // same timer enforces the deadline
+  void start_deadline(tcp_connector_timeout_func tout_func) {
+    m_timer.expires_after(m_connect_deadline);
+    auto self = shared_from_this();
+    m_timer.async_wait([this, self, gen = m_attempt_gen, tout_func] (const std::error_code& err) {
+        if (err || gen != m_attempt_gen || m_state != connecting) {
+          return;
+        }
+        end_race();
+        std::error_code ec;
+        m_socket.close(ec); // the cancelled connect completion is discarded
+        handle_connect(std::make_error_code(net_ip_errc::tcp_connector_connect_deadline),
+                       m_endpoints.cend(), tout_func);
+      }
+    );
+  }
+
+  // cancels the remaining attempts, their completion handlers are discarded
+  void end_race() {
+    ++m_attempt_gen;
+    m_race_timer.cancel();
+    std::error_code ec;
+    for (auto& sock : m_race_sockets) {
+      sock.close(ec);
+    }
+    m_race_sockets.clear();
+  }
+
+  void handle_connect (const std::error_code& err, endpoints_iter iter,
                        tcp_connector_timeout_func tout_func) {
     using namespace std::placeholders;
 
@@ -310,13 +577,15 @@ private:
             close(err);
             return;
           }
-          start_connect(tout_func);
+          reconnect(tout_func);
         }
       );
       return;
     }
+    m_timer.cancel(); // connect deadline
     m_io_handler = std::make_shared<tcp_io>(std::move(m_socket), 
-      tcp_io::entity_notifier_cb(std::bind(&tcp_connector::notify_me, shared_from_this(), _1, _2)));
+      tcp_io::entity_notifier_cb(std::bind(&tcp_connector::notify_me, shared_from_this(), _1, _2)),
+      m_fast_open ? *iter : endpoint_type());
     m_state = connected;
     // this is only called after an async connect so no danger of invoking app code during the
     // start method call
@@ -334,7 +603,7 @@ private:
     // notify app of tcp_io object shutting down
     m_entity_common.call_io_state_chg_cb(iop, 0, false);
     if (m_state == connected && m_reconn_on_err) {
-      start_connect(m_timeout_func);
+      reconnect(m_timeout_func);
       return;
     }
     finish_close(std::make_error_code(net_ip_errc::tcp_connector_no_reconnect_attempted));
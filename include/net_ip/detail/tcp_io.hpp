@@ -25,6 +25,7 @@
 #include "asio/write.hpp"
 #include "asio/ip/tcp.hpp"
 #include "asio/buffer.hpp"
+#include "asio/dispatch.hpp"
 
 #include <memory> // std::shared_ptr, std::enable_shared_from_this
 #include <system_error>
@@ -34,8 +35,11 @@
 #include <string>
 #include <string_view>
 #include <functional> // std::function
+#include <type_traits> // std::decay_t
 
 #include "net_ip/detail/io_common.hpp"
+#include "net_ip/detail/handler_memory.hpp"
+#include "net_ip/detail/read_state.hpp"
 #include "net_ip/queue_stats.hpp"
 #include "net_ip/net_ip_error.hpp"
 
@@ -62,6 +66,10 @@ public:
 
 private:
   using byte_vec = chops::mutable_shared_buffer::byte_vec;
+  // the read chain and the write chain each own one reference to this object, which is
+  // moved from each completion handler into the next operation, so that steady-state 
+  // reads and writes do not change the reference count
+  using self_ptr = std::shared_ptr<tcp_io>;
 
 private:
 
@@ -75,12 +83,25 @@ private:
   // moving
   byte_vec                            m_byte_vec;
 
+  // message handler and message frame, stored once when IO is started so that the 
+  // read completion handlers only carry a reference to them
+  read_state_ptr                      m_read_state;
+
+  // recycled completion handler storage, one block for the read chain and one for
+  // the write chain, so that steady-state reads and writes do not allocate
+  handler_memory                      m_read_mem;
+  handler_memory                      m_write_mem;
+
 public:
 
-  tcp_io(asio::ip::tcp::socket sock, entity_notifier_cb cb) noexcept : 
+  // the remote endpoint is normally obtained from the socket when IO is started, but
+  // can be supplied by the creator (a TCP Fast Open connect is not on the wire until the
+  // first send, so the socket does not yet have a remote endpoint)
+  tcp_io(asio::ip::tcp::socket sock, entity_notifier_cb cb,
+         const endpoint_type& remote_endp = endpoint_type()) noexcept : 
     m_socket(std::move(sock)), m_io_common(), 
-    m_notifier_cb(cb), m_remote_endp(),
-    m_byte_vec() { }
+    m_notifier_cb(cb), m_remote_endp(remote_endp),
+    m_byte_vec(), m_read_state(), m_read_mem(), m_write_mem() { }
 
 private:
   // no copy or assignment semantics for this class
@@ -102,16 +123,39 @@ public:
     return m_io_common.get_output_queue_stats();
   }
 
+  asio::any_io_executor get_executor() const noexcept { return m_socket.get_executor(); }
+
+  std::size_t clear_output_queue() { return m_io_common.clear_queue(); }
+
+  void enable_output_timestamps() noexcept { m_io_common.enable_timestamps(); }
+
+  template <typename F>
+  void notify_when_drained(std::size_t max_bytes, F&& func) {
+    m_io_common.notify_when_drained(max_bytes, detail::drain_func(std::forward<F>(func)));
+  }
+
   bool is_io_started() const noexcept { return m_io_common.is_io_started(); }
 
+  // the start_io and stop_io methods can be called from any thread (e.g. the IO state 
+  // change callback of an acceptor runs on the acceptor io_context, while the connection
+  // may run on another io_context), the socket and read state are then only accessed 
+  // from the socket executor
   template <typename MH, typename MF>
   bool start_io(std::size_t header_size, MH&& msg_handler, MF&& msg_frame) {
-    if (!start_io_setup()) {
+    if (!m_io_common.set_io_started()) { // concurrency protected
       return false;
     }
-    m_byte_vec.resize(header_size);
-    start_read(asio::mutable_buffer(m_byte_vec.data(), m_byte_vec.size()), header_size,
-               std::forward<MH>(msg_handler), std::forward<MF>(msg_frame));
+    using state_type = read_state<std::decay_t<MH>, std::decay_t<MF>, std::size_t>;
+    auto st = std::make_unique<state_type>(std::forward<MH>(msg_handler), 
+                                           std::forward<MF>(msg_frame), header_size);
+    start_on_executor([this, st = std::move(st), header_size] (self_ptr self) mutable {
+        auto& st_ref = *st;
+        m_read_state = std::move(st);
+        m_byte_vec.resize(header_size);
+        start_read(asio::mutable_buffer(m_byte_vec.data(), m_byte_vec.size()), st_ref, 
+                   std::move(self));
+      }
+    );
     return true;
   }
 
@@ -123,11 +167,19 @@ public:
 
   template <typename MH>
   bool start_io(std::string_view delimiter, MH&& msg_handler) {
-    if (!start_io_setup()) {
+    if (!m_io_common.set_io_started()) { // concurrency protected
       return false;
     }
     // not sure of delimiter std::string_view lifetime, so create string
-    start_read_until(std::string(delimiter), std::forward<MH>(msg_handler));
+    using state_type = read_state<std::decay_t<MH>, no_read_data, std::string>;
+    auto st = std::make_unique<state_type>(std::forward<MH>(msg_handler), 
+                                           no_read_data(), std::string(delimiter));
+    start_on_executor([this, st = std::move(st)] (self_ptr self) mutable {
+        auto& st_ref = *st;
+        m_read_state = std::move(st);
+        start_read_until(st_ref, std::move(self));
+      }
+    );
     return true;
   }
 
@@ -149,7 +201,10 @@ public:
       ret = false;
       m_io_common.set_io_started();
     }
-    close(std::make_error_code(net_ip_errc::tcp_io_handler_stopped));
+    asio::dispatch(m_socket.get_executor(), [this, self = shared_from_this()] () {
+        close(std::make_error_code(net_ip_errc::tcp_io_handler_stopped));
+      }
+    );
     return ret;
   }
 
@@ -157,7 +212,7 @@ public:
   bool send(const chops::const_shared_buffer& buf) {
     auto ret = m_io_common.start_write(buf, 
         [this] (const chops::const_shared_buffer& b) {
-          start_write(b);
+          start_write(b, shared_from_this());
         }
       );
     return ret != io_common<const_shared_buffer>::write_status::io_stopped;
@@ -167,6 +222,50 @@ public:
     return send(buf);
   }
 
+  // R is a range of const_shared_buffer objects, all are queued under one lock and at 
+  // most one write is started
+  template <typename R>
+  std::size_t send_batch(const R& bufs) {
+    return m_io_common.start_write_batch(bufs, 
+        [] (const chops::const_shared_buffer& b) -> const chops::const_shared_buffer& {
+          return b;
+        },
+        [this] (const chops::const_shared_buffer& b) {
+          start_write(b, shared_from_this());
+        }
+      );
+  }
+
+  template <typename R>
+  std::size_t send_batch(const R& bufs, const endpoint_type&) {
+    return send_batch(bufs);
+  }
+
+public:
+  // the following methods are used by the TCP acceptor object pool; the read buffer
+  // capacity and the recycled completion handler storage are retained between 
+  // connections (the output queue is a std::queue, which does not keep its storage)
+
+  // called when the object is pulled from the pool for a newly accepted connection
+  void reuse(asio::ip::tcp::socket sock, entity_notifier_cb cb) {
+    m_socket = std::move(sock);
+    m_notifier_cb = std::move(cb);
+    m_remote_endp = endpoint_type();
+    m_byte_vec.clear();
+    m_read_state.reset();
+    m_io_common.reset_timestamps(); // enabled per connection by the application
+  }
+
+  // called when the last reference is released, returns false if the object cannot
+  // be re-used (e.g. IO processing still marked as started)
+  bool release() noexcept {
+    m_notifier_cb = nullptr; // the notifier typically refers to the owning acceptor
+    m_read_state.reset(); // don't keep application message handler state in the pool
+    std::error_code ec;
+    m_socket.close(ec);
+    return !m_io_common.is_io_started() && !m_io_common.is_write_in_progress();
+  }
+
 private:
   void close(const std::error_code& err) {
     if (!m_io_common.set_io_stopped()) {
@@ -182,9 +281,23 @@ private:
 
 private:
 
-  bool start_io_setup() {
-    if (!m_io_common.set_io_started()) { // concurrency protected
-      return false;
+  // runs func (with a reference to this object for the read chain) from the socket 
+  // executor, unless IO was stopped in the meantime
+  template <typename F>
+  void start_on_executor(F&& func) {
+    asio::dispatch(m_socket.get_executor(), 
+        [this, self = shared_from_this(), f = std::forward<F>(func)] () mutable {
+          if (!m_io_common.is_io_started() || !set_remote_endp()) {
+            return;
+          }
+          f(std::move(self));
+        }
+      );
+  }
+
+  bool set_remote_endp() {
+    if (m_remote_endp != endpoint_type()) {
+      return true;
     }
     std::error_code ec;
     m_remote_endp = m_socket.remote_endpoint(ec);
@@ -195,66 +308,67 @@ private:
     return true;
   }
 
-  template <typename MH, typename MF>
-  void start_read(asio::mutable_buffer mbuf, std::size_t hdr_size, MH&& msg_hdlr, MF&& msg_frame) {
-    auto self { shared_from_this() };
-    asio::async_read(m_socket, mbuf,
-      [this, self, hdr_size, mbuf, msg_hdlr = std::move(msg_hdlr), msg_frame = std::move(msg_frame)]
+  // ST is the read_state type, owned by m_read_state
+  template <typename ST>
+  void start_read(asio::mutable_buffer mbuf, ST& st, self_ptr self) {
+    asio::async_read(m_socket, mbuf, make_alloc_handler(m_read_mem,
+      [this, self = std::move(self), mbuf, &st] 
             (const std::error_code& err, std::size_t nb) mutable {
-        handle_read(mbuf, hdr_size, err, nb, std::move(msg_hdlr), std::move(msg_frame));
+        handle_read(mbuf, err, nb, st, std::move(self));
       }
-    );
+    ));
   }
 
-  template <typename MH, typename MF>
-  void handle_read(asio::mutable_buffer, std::size_t,
-                   const std::error_code&, std::size_t, MH&&, MF&&);
+  template <typename ST>
+  void handle_read(asio::mutable_buffer, const std::error_code&, std::size_t, ST&, self_ptr);
 
-  template <typename MH>
-  void start_read_until(std::string delim, MH&& msg_hdlr) {
-    auto self { shared_from_this() };
-    asio::async_read_until(m_socket, asio::dynamic_buffer(m_byte_vec), delim,
-      [this, self, delim, msg_hdlr = std::move(msg_hdlr)] 
+  template <typename ST>
+  void start_read_until(ST& st, self_ptr self) {
+    asio::async_read_until(m_socket, asio::dynamic_buffer(m_byte_vec), st.m_data,
+      make_alloc_handler(m_read_mem, [this, self = std::move(self), &st] 
             (const std::error_code& err, std::size_t nb) mutable {
-        handle_read_until(delim, err, nb, std::move(msg_hdlr));
+        handle_read_until(err, nb, st, std::move(self));
       }
-    );
+    ));
   }
 
-  template <typename MH>
-  void handle_read_until(std::string, const std::error_code&, std::size_t, MH&&);
+  template <typename ST>
+  void handle_read_until(const std::error_code&, std::size_t, ST&, self_ptr);
 
-  void start_write(const chops::const_shared_buffer&);
+  void start_write(const chops::const_shared_buffer&, self_ptr);
 
-  void handle_write(const std::error_code&, std::size_t);
+  void handle_write(const std::error_code&, std::size_t, self_ptr);
 
 };
 
 // method implementations, just to make the class declaration a little more readable
 
-template <typename MH, typename MF>
-void tcp_io::handle_read(asio::mutable_buffer mbuf, std::size_t hdr_size,
-                         const std::error_code& err, std::size_t /* num_bytes */,
-                         MH&& msg_hdlr, MF&& msg_frame) {
+// when the read processing finishes, the read state (and the application message handler)
+// is released; st must not be used after that point
+
+template <typename ST>
+void tcp_io::handle_read(asio::mutable_buffer mbuf, const std::error_code& err, 
+                         std::size_t /* num_bytes */, ST& st, self_ptr self) {
 
   if (err) {
+    m_read_state.reset();
     close(err);
     return;
   }
   // assert num_bytes == mbuf.size()
-  std::size_t next_read_size = msg_frame(mbuf);
+  std::size_t next_read_size = st.m_msg_frame(mbuf);
   if (next_read_size == 0u) { // msg fully received, now invoke message handler
-    if (!msg_hdlr(asio::const_buffer(m_byte_vec.data(), m_byte_vec.size()), 
-                  basic_io_output<tcp_io>(weak_from_this()), m_remote_endp)) {
-      auto self { shared_from_this() };
+    if (!st.m_msg_hdlr(asio::const_buffer(m_byte_vec.data(), m_byte_vec.size()), 
+                       basic_io_output<tcp_io>(this), m_remote_endp)) {
+      m_read_state.reset();
       // message handler not happy, tear everything down, post function object
       // instead of directly calling close to give a return message a possibility
       // of getting through
-      asio::post(m_socket.get_executor(), [this, self] () { 
+      asio::post(m_socket.get_executor(), [this, self = std::move(self)] () { 
         close(std::make_error_code(net_ip_errc::message_handler_terminated)); } );
       return;
     }
-    m_byte_vec.resize(hdr_size);
+    m_byte_vec.resize(st.m_data); // header size
     mbuf = asio::mutable_buffer(m_byte_vec.data(), m_byte_vec.size());
   }
   else {
@@ -262,47 +376,51 @@ void tcp_io::handle_read(asio::mutable_buffer mbuf, std::size_t hdr_size,
     m_byte_vec.resize(old_size + next_read_size);
     mbuf = asio::mutable_buffer(m_byte_vec.data() + old_size, next_read_size);
   }
-  start_read(mbuf, hdr_size, std::forward<MH>(msg_hdlr), std::forward<MF>(msg_frame));
+  start_read(mbuf, st, std::move(self));
 }
 
-template <typename MH>
-void tcp_io::handle_read_until(std::string delim, const std::error_code& err, 
-                               std::size_t num_bytes, MH&& msg_hdlr) {
+template <typename ST>
+void tcp_io::handle_read_until(const std::error_code& err, std::size_t num_bytes, ST& st,
+                               self_ptr self) {
 
   if (err) {
+    m_read_state.reset();
     close(err);
     return;
   }
   // beginning of m_byte_vec to num_bytes is buf, includes delimiter bytes
-  if (!msg_hdlr(asio::const_buffer(m_byte_vec.data(), num_bytes),
-                basic_io_output<tcp_io>(weak_from_this()), m_remote_endp)) {
-      auto self { shared_from_this() };
-      asio::post(m_socket.get_executor(), [this, self] () { 
+  if (!st.m_msg_hdlr(asio::const_buffer(m_byte_vec.data(), num_bytes),
+                     basic_io_output<tcp_io>(this), m_remote_endp)) {
+      m_read_state.reset();
+      asio::post(m_socket.get_executor(), [this, self = std::move(self)] () { 
         close(std::make_error_code(net_ip_errc::message_handler_terminated)); } );
     return;
   }
   m_byte_vec.erase(m_byte_vec.begin(), m_byte_vec.begin() + num_bytes);
-  start_read_until(delim, std::forward<MH>(msg_hdlr));
+  start_read_until(st, std::move(self));
 }
 
 
-inline void tcp_io::start_write(const chops::const_shared_buffer& buf) {
-  auto self { shared_from_this() };
+inline void tcp_io::start_write(const chops::const_shared_buffer& buf, self_ptr self) {
   asio::async_write(m_socket, asio::const_buffer(buf.data(), buf.size()),
-            [this, self] (const std::error_code& err, std::size_t nb) {
-      handle_write(err, nb);
+            make_alloc_handler(m_write_mem, [this, self = std::move(self)] 
+                  (const std::error_code& err, std::size_t nb) mutable {
+      handle_write(err, nb, std::move(self));
     }
-  );
+  ));
 }
 
-inline void tcp_io::handle_write(const std::error_code& err, std::size_t /* num_bytes */) {
+// if the output queue is empty the write chain ends, releasing its reference when self
+// goes out of scope
+inline void tcp_io::handle_write(const std::error_code& err, std::size_t /* num_bytes */,
+                                 self_ptr self) {
   if (err) {
     // read pops first, so usually no error is needed in write handlers
     close(err);
     return;
   }
-  m_io_common.write_next_elem([this] (const chops::const_shared_buffer& buf) {
-      start_write(buf);
+  m_io_common.write_next_elem([this, &self] (const chops::const_shared_buffer& buf) {
+      start_write(buf, std::move(self));
     }
   );
 }
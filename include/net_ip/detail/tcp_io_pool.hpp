@@ -0,0 +1,150 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Recyclable pool of @c tcp_io objects, used by the TCP acceptor to absorb
+ *  bursts of incoming connections without allocator contention.
+ *
+ *  The @c std::shared_ptr returned from @c acquire uses a deleter that returns the
+ *  @c tcp_io object to the pool instead of destroying it. The deleter only holds a
+ *  @c std::weak_ptr to the pool, so @c tcp_io objects can outlive the pool (they are
+ *  then destroyed normally).
+ *
+ *  Objects are returned to the pool from whichever thread releases the last reference,
+ *  so the free list is mutex protected.
+ *
+ *  @note For internal use only.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TCP_IO_POOL_HPP_INCLUDED
+#define TCP_IO_POOL_HPP_INCLUDED
+
+#include "asio/io_context.hpp"
+#include "asio/ip/tcp.hpp"
+
+#include <memory> // std::shared_ptr, std::weak_ptr, std::unique_ptr
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <utility> // std::move
+
+#include "net_ip/detail/tcp_io.hpp"
+#include "net_ip/queue_stats.hpp"
+
+namespace chops {
+namespace net {
+namespace detail {
+
+class tcp_io_pool : public std::enable_shared_from_this<tcp_io_pool> {
+private:
+  using tcp_io_ptr = std::unique_ptr<tcp_io>;
+  using lk_guard = std::lock_guard<std::mutex>;
+
+  struct pool_deleter {
+    std::weak_ptr<tcp_io_pool>  m_pool;
+
+    void operator()(tcp_io* p) const noexcept {
+      auto pool = m_pool.lock();
+      if (!pool) {
+        delete p;
+        return;
+      }
+      pool->recycle(tcp_io_ptr(p));
+    }
+  };
+
+private:
+  std::vector<tcp_io_ptr>   m_free;
+  std::size_t               m_max_size;
+  bool                      m_closed;
+  std::atomic_size_t        m_hits;
+  std::atomic_size_t        m_misses;
+  mutable std::mutex        m_mutex;
+
+public:
+
+  // pool objects are created with a placeholder socket, the accepted socket (and
+  // associated executor) is moved in when the object is acquired
+  tcp_io_pool(asio::io_context& ioc, std::size_t max_size) :
+      m_free(), m_max_size(max_size), m_closed(false), m_hits(0u), m_misses(0u), m_mutex() {
+    m_free.reserve(max_size);
+    for (std::size_t i = 0u; i < max_size; ++i) {
+      m_free.push_back(std::make_unique<tcp_io>(asio::ip::tcp::socket(ioc),
+                                                tcp_io::entity_notifier_cb()));
+    }
+  }
+
+private:
+  // no copy or assignment semantics for this class
+  tcp_io_pool(const tcp_io_pool&) = delete;
+  tcp_io_pool(tcp_io_pool&&) = delete;
+  tcp_io_pool& operator=(const tcp_io_pool&) = delete;
+  tcp_io_pool& operator=(tcp_io_pool&&) = delete;
+
+public:
+
+  tcp_io_shared_ptr acquire(asio::ip::tcp::socket sock, tcp_io::entity_notifier_cb cb) {
+    tcp_io_ptr p;
+    {
+      lk_guard lg(m_mutex);
+      if (!m_free.empty()) {
+        p = std::move(m_free.back());
+        m_free.pop_back();
+      }
+    }
+    if (p) {
+      ++m_hits;
+      p->reuse(std::move(sock), std::move(cb));
+    }
+    else {
+      // newly allocated objects are also returned to the pool, if there is room
+      ++m_misses;
+      p = std::make_unique<tcp_io>(std::move(sock), std::move(cb));
+    }
+    return tcp_io_shared_ptr(p.release(), pool_deleter{weak_from_this()});
+  }
+
+  // release all pooled objects, objects subsequently returned are destroyed
+  void close() {
+    std::vector<tcp_io_ptr> tmp;
+    lk_guard lg(m_mutex);
+    m_closed = true;
+    tmp.swap(m_free);
+  }
+
+  tcp_io_pool_stats get_stats() const noexcept {
+    lk_guard lg(m_mutex);
+    return tcp_io_pool_stats { m_hits.load(), m_misses.load(), m_free.size() };
+  }
+
+private:
+
+  void recycle(tcp_io_ptr p) noexcept {
+    if (!p->release()) {
+      return;
+    }
+    lk_guard lg(m_mutex);
+    if (!m_closed && m_free.size() < m_max_size) {
+      m_free.push_back(std::move(p));
+    }
+  }
+
+};
+
+using tcp_io_pool_shared_ptr = std::shared_ptr<tcp_io_pool>;
+
+} // end detail namespace
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -29,9 +29,12 @@
 #include <cstddef> // std::size_t
 #include <utility> // std::forward, std::move
 #include <functional> // std::function
+#include <type_traits> // std::decay_t
 #include <future>
 
 #include "net_ip/detail/io_common.hpp"
+#include "net_ip/detail/handler_memory.hpp"
+#include "net_ip/detail/read_state.hpp"
 #include "net_ip/detail/net_entity_common.hpp"
 
 #include "net_ip/queue_stats.hpp"
@@ -69,6 +72,9 @@ public:
 
 private:
   using byte_vec = chops::mutable_shared_buffer::byte_vec;
+  // the read chain and the write chain each own one reference to this object, moved
+  // from each completion handler into the next operation
+  using self_ptr = std::shared_ptr<udp_entity_io>;
 
 private:
 
@@ -80,6 +86,7 @@ private:
   endpoint_type                     m_default_dest_endp;
   std::string                       m_local_port_or_service;
   std::string                       m_local_intf;
+  endpoints_resolver<asio::ip::udp> m_resolver;
   bool                              m_shutting_down;
 
   // TODO: multicast stuff
@@ -89,24 +96,35 @@ private:
   byte_vec                          m_byte_vec;
   endpoint_type                     m_sender_endp;
 
+  // message handler, stored once when IO is started so that the read completion 
+  // handlers only carry a reference to it
+  read_state_ptr                    m_read_state;
+
+  // recycled completion handler storage for the read and write chains
+  handler_memory                    m_read_mem;
+  handler_memory                    m_write_mem;
+
 public:
 
   udp_entity_io(asio::io_context& ioc, 
-                const endpoint_type& local_endp) noexcept : 
+                const endpoint_type& local_endp,
+                resolver_cache_shared_ptr cache = resolver_cache_shared_ptr()) noexcept : 
     m_io_common(), m_entity_common(), m_ioc(ioc),
     m_socket(ioc), m_local_endp(local_endp), m_default_dest_endp(), 
-    m_local_port_or_service(), m_local_intf(),
+    m_local_port_or_service(), m_local_intf(), m_resolver(ioc, std::move(cache)),
     m_shutting_down(false),
-    m_byte_vec(), m_sender_endp() 
+    m_byte_vec(), m_sender_endp(), m_read_state(), m_read_mem(), m_write_mem()
     { }
 
   udp_entity_io(asio::io_context& ioc, 
-                std::string_view local_port_or_service, std::string_view local_intf) noexcept :
+                std::string_view local_port_or_service, std::string_view local_intf,
+                resolver_cache_shared_ptr cache = resolver_cache_shared_ptr()) noexcept :
     m_io_common(), m_entity_common(), m_ioc(ioc),
     m_socket(ioc), m_local_endp(), m_default_dest_endp(), 
     m_local_port_or_service(local_port_or_service), m_local_intf(local_intf),
+    m_resolver(ioc, std::move(cache)),
     m_shutting_down(false),
-    m_byte_vec(), m_sender_endp() 
+    m_byte_vec(), m_sender_endp(), m_read_state(), m_read_mem(), m_write_mem()
     { }
 
 private:
@@ -133,26 +151,35 @@ public:
   template <typename F>
   std::size_t visit_io_output(F&& func) {
     auto self = shared_from_this();
-    std::promise<std::size_t> prom;
-    auto fut = prom.get_future();
-    // send to executor for concurrency protection
-    asio::post(m_socket.get_executor(), [this, self, &func, p = std::move(prom)] () mutable {
-        if (m_io_common.is_io_started()) {
-          func(basic_io_output<udp_entity_io>(weak_from_this()));
-          p.set_value(1u);
-        }
-        else {
-          p.set_value(0u);
-        }
-      }
-    );
-    return fut.get();
+    // run in executor for concurrency protection
+    return run_in_executor<std::size_t>(m_socket.get_executor(), 
+             [this, self, &func] () { return do_visit_io_output(func); } );
+  }
+
+  // non-blocking, the completion handler is invoked with the visit count
+  template <typename F, typename CH>
+  void visit_io_output(F&& func, CH&& completion) {
+    auto self = shared_from_this();
+    post_to_executor(m_socket.get_executor(), 
+             [this, self, f = std::forward<F>(func)] () mutable { return do_visit_io_output(f); },
+             std::forward<CH>(completion));
   }
 
   output_queue_stats get_output_queue_stats() const noexcept {
     return m_io_common.get_output_queue_stats();
   }
 
+  asio::any_io_executor get_executor() const noexcept { return m_socket.get_executor(); }
+
+  std::size_t clear_output_queue() { return m_io_common.clear_queue(); }
+
+  void enable_output_timestamps() noexcept { m_io_common.enable_timestamps(); }
+
+  template <typename F>
+  void notify_when_drained(std::size_t max_bytes, F&& func) {
+    m_io_common.notify_when_drained(max_bytes, detail::drain_func(std::forward<F>(func)));
+  }
+
   template <typename F1, typename F2>
   std::error_code start(F1&& io_state_chg, F2&& err_cb) {
     auto self = shared_from_this();
@@ -172,7 +199,7 @@ public:
     m_byte_vec.resize(max_size);
 // std::cerr << "Inside start_io AAA, ready to start read, buf resized to: " << max_size << 
 // ", local endp: " << m_local_endp << ", default dest endp: " << m_default_dest_endp << std::endl;
-    start_read(std::forward<MH>(msg_handler));
+    start_read(make_read_state(std::forward<MH>(msg_handler)), shared_from_this());
     return true;
   }
 
@@ -188,7 +215,7 @@ public:
     m_byte_vec.resize(max_size);
 // std::cerr << "Inside start_io BBB, ready to start read, buf resized to: " << max_size << 
 // ", local endp: " << m_local_endp << ", default dest endp: " << m_default_dest_endp << std::endl;
-    start_read(std::forward<MH>(msg_handler));
+    start_read(make_read_state(std::forward<MH>(msg_handler)), shared_from_this());
     return true;
   }
 
@@ -218,14 +245,25 @@ public:
     return ret;
   }
 
+  template <typename F1, typename F2, typename CH>
+  std::error_code start(F1&& io_state_chg, F2&& err_cb, CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.start(std::forward<F1>(io_state_chg), std::forward<F2>(err_cb),
+                                 m_socket.get_executor(),
+             [this, self] () { return do_start(); }, std::forward<CH>(completion) );
+  }
+
   std::error_code stop() {
     auto self = shared_from_this();
     return m_entity_common.stop(m_socket.get_executor(),
-             [this, self] () {
-               close(std::make_error_code(net_ip_errc::udp_entity_stopped));
-               return std::error_code();
-             }
-    );
+             [this, self] () { return do_stop(); } );
+  }
+
+  template <typename CH>
+  std::error_code stop(CH&& completion) {
+    auto self = shared_from_this();
+    return m_entity_common.stop(m_socket.get_executor(),
+             [this, self] () { return do_stop(); }, std::forward<CH>(completion) );
   }
 
   // io_common has concurrency protection
@@ -239,50 +277,118 @@ public:
     }
     auto ret = m_io_common.start_write(udp_queue_element(buf, endp), 
         [this] (const udp_queue_element& e) {
-          start_write(e);
+          start_write(e, shared_from_this());
         }
       );
     return ret != io_common<udp_queue_element>::write_status::io_stopped;
   }
 
+  // R is a range of const_shared_buffer objects, all are queued under one lock and at 
+  // most one write is started
+  template <typename R>
+  std::size_t send_batch(const R& bufs) {
+    return send_batch(bufs, m_default_dest_endp);
+  }
+
+  template <typename R>
+  std::size_t send_batch(const R& bufs, const endpoint_type& endp) {
+    if (endp == endpoint_type()) { // mismatch between start_io and send
+      return 0u;
+    }
+    return m_io_common.start_write_batch(bufs, 
+        [&endp] (const chops::const_shared_buffer& b) {
+          return udp_queue_element(b, endp);
+        },
+        [this] (const udp_queue_element& e) {
+          start_write(e, shared_from_this());
+        }
+      );
+  }
+
 private:
 
   template <typename MH>
-  void start_read(MH&& msg_hdlr) {
-    auto self { shared_from_this() };
+  auto& make_read_state(MH&& msg_hdlr) {
+    using state_type = read_state<std::decay_t<MH>, no_read_data, no_read_data>;
+    auto st = std::make_unique<state_type>(std::forward<MH>(msg_hdlr), 
+                                           no_read_data(), no_read_data());
+    auto& st_ref = *st;
+    m_read_state = std::move(st);
+    return st_ref;
+  }
+
+  // ST is the read_state type, owned by m_read_state
+  template <typename ST>
+  void start_read(ST& st, self_ptr self) {
     m_socket.async_receive_from(
               asio::mutable_buffer(m_byte_vec.data(), m_byte_vec.size()),
               m_sender_endp,
-                [this, self, msg_hdlr = std::move(msg_hdlr)] 
+              make_alloc_handler(m_read_mem, [this, self = std::move(self), &st] 
                   (const std::error_code& err, std::size_t nb) mutable {
-        handle_read(err, nb, std::move(msg_hdlr));
+        handle_read(err, nb, st, std::move(self));
       }
-    );
+    ));
   }
 
-  template <typename MH>
-  void handle_read(const std::error_code&, std::size_t, MH&&);
+  template <typename ST>
+  void handle_read(const std::error_code&, std::size_t, ST&, self_ptr);
 
-  void start_write(const udp_queue_element&);
+  void start_write(const udp_queue_element&, self_ptr);
 
-  void handle_write(const std::error_code&, std::size_t);
+  void handle_write(const std::error_code&, std::size_t, self_ptr);
 
 private:
 
+  template <typename F>
+  std::size_t do_visit_io_output(F& func) {
+    if (m_io_common.is_io_started()) {
+      func(basic_io_output<udp_entity_io>(this));
+      return 1u;
+    }
+    return 0u;
+  }
+
+  std::error_code do_stop() {
+    close(std::make_error_code(net_ip_errc::udp_entity_stopped));
+    return { };
+  }
+
   std::error_code do_start() {
     if (!m_local_port_or_service.empty()) {
-      endpoints_resolver<asio::ip::udp> resolver(m_ioc);
-      auto ret = resolver.make_endpoints(true, m_local_intf, m_local_port_or_service);
+      auto ret = m_resolver.try_make_endpoints(true, m_local_intf, m_local_port_or_service);
       if (!ret) {
-        close(ret.error());
-        return ret.error();
+        // a name lookup is needed, finish starting when it completes; errors are 
+        // reported through the error callback
+        auto self = shared_from_this();
+        m_resolver.make_endpoints(true, m_local_intf, m_local_port_or_service,
+          [this, self] (const std::error_code& err, asio::ip::udp::resolver::results_type res) {
+            if (m_shutting_down) {
+              return;
+            }
+            if (err) {
+              close(err);
+              return;
+            }
+            set_local_endpoint(res);
+            open_socket();
+          }
+        );
+        return { };
       }
-      m_local_endp = ret->cbegin()->endpoint();
-      m_local_port_or_service.clear();
-      m_local_port_or_service.shrink_to_fit();
-      m_local_intf.clear();
-      m_local_intf.shrink_to_fit();
+      set_local_endpoint(*ret);
     }
+    return open_socket();
+  }
+
+  void set_local_endpoint(const asio::ip::udp::resolver::results_type& res) {
+    m_local_endp = res.cbegin()->endpoint();
+    m_local_port_or_service.clear();
+    m_local_port_or_service.shrink_to_fit();
+    m_local_intf.clear();
+    m_local_intf.shrink_to_fit();
+  }
+
+  std::error_code open_socket() {
     std::error_code ec;
     m_socket.open(m_local_endp.protocol(), ec);
     if (ec) {
@@ -310,6 +416,7 @@ private:
     m_io_common.set_io_stopped();
     m_entity_common.set_stopped();
     m_io_common.clear();
+    m_resolver.cancel();
     std::error_code ec;
     m_socket.close(ec);
     m_entity_common.call_error_cb(self, std::make_error_code(net_ip_errc::udp_entity_closed));
@@ -320,42 +427,50 @@ private:
 
 // method implementations, split out just to make the class declaration a little more readable
 
-template <typename MH>
+// when the read processing finishes, the read state (and the application message handler)
+// is released; st must not be used after that point
+
+template <typename ST>
 void udp_entity_io::handle_read(const std::error_code& err, 
-                                std::size_t num_bytes, MH&& msg_hdlr) {
+                                std::size_t num_bytes, ST& st, self_ptr self) {
 
   if (err) {
+    m_read_state.reset();
     close(err);
     return;
   }
-  if (!msg_hdlr(asio::const_buffer(m_byte_vec.data(), num_bytes), 
-                basic_io_output<udp_entity_io>(weak_from_this()), m_sender_endp)) {
+  if (!st.m_msg_hdlr(asio::const_buffer(m_byte_vec.data(), num_bytes), 
+                     basic_io_output<udp_entity_io>(this), m_sender_endp)) {
+    m_read_state.reset();
     // message handler not happy, tear everything down
     close(std::make_error_code(net_ip_errc::message_handler_terminated));
     return;
   }
-  start_read(std::forward<MH>(msg_hdlr));
+  start_read(st, std::move(self));
 }
 
-inline void udp_entity_io::start_write(const udp_queue_element& e) {
-  auto self { shared_from_this() };
+inline void udp_entity_io::start_write(const udp_queue_element& e, self_ptr self) {
 // if (e.m_endp == asio::ip::udp::endpoint()) {
 // std::cerr << "Ack! Empty endpoint in UDP write" << std::endl;
 // }
   m_socket.async_send_to(asio::const_buffer(e.m_buf.data(), e.m_buf.size()), e.m_endp,
-            [this, self] (const std::error_code& err, std::size_t nb) {
-      handle_write(err, nb);
+            make_alloc_handler(m_write_mem, [this, self = std::move(self)] 
+                  (const std::error_code& err, std::size_t nb) mutable {
+      handle_write(err, nb, std::move(self));
     }
-  );
+  ));
 }
 
-inline void udp_entity_io::handle_write(const std::error_code& err, std::size_t /* num_bytes */) {
+// if the output queue is empty the write chain ends, releasing its reference when self
+// goes out of scope
+inline void udp_entity_io::handle_write(const std::error_code& err, std::size_t /* num_bytes */,
+                                        self_ptr self) {
   if (err) {
     close(err);
     return;
   }
-  m_io_common.write_next_elem([this] (const udp_queue_element& e) {
-      start_write(e);
+  m_io_common.write_next_elem([this, &self] (const udp_queue_element& e) {
+      start_write(e, std::move(self));
     }
   );
 }
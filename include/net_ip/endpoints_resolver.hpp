@@ -18,13 +18,17 @@
 
 #include "asio/ip/basic_resolver.hpp"
 #include "asio/io_context.hpp"
+#include "asio/post.hpp"
 
 #include <string_view>
 #include <string>
 #include <utility> // std::move, std::forward
+#include <optional>
 
 #include "nonstd/expected.hpp"
 
+#include "net_ip/resolver_cache.hpp"
+
 namespace chops {
 namespace net {
 
@@ -47,12 +51,20 @@ namespace net {
  *  to ensure that the memory context is still valid when the callback is invoked. A typical 
  *  idiom is to use @c std::shared_from_this as part of the function object callback member.
  *
+ *  If a @c resolver_cache is supplied, successful lookups are stored in the cache and later
+ *  lookups of the same name are satisfied from the cache (until the entry expires), without
+ *  contacting a name server.
+ *
  */
 
 template <typename Protocol>
 class endpoints_resolver {
+private:
+  using results_type = asio::ip::basic_resolver_results<Protocol>;
+
 private:
   asio::ip::basic_resolver<Protocol>  m_resolver;
+  resolver_cache_shared_ptr           m_cache;
 
 public:
 
@@ -61,8 +73,12 @@ public:
  *
  *  @param ioc @c asio::io_context used in the resolver.
  *
+ *  @param cache Optional @c resolver_cache, typically shared with other resolvers.
+ *
  */
-  explicit endpoints_resolver(asio::io_context& ioc) : m_resolver(ioc) { }
+  explicit endpoints_resolver(asio::io_context& ioc,
+                              resolver_cache_shared_ptr cache = resolver_cache_shared_ptr()) :
+    m_resolver(ioc), m_cache(std::move(cache)) { }
 
 /**
  *  @brief Create a sequence of endpoints and return them in a function object callback.
@@ -91,6 +107,8 @@ public:
  *
  *  If an error occurs, the error code is set accordingly. 
  *
+ *  If the lookup is satisfied from the cache, the callback is posted to the @c io_context.
+ *
  */
   template <typename F>
   void make_endpoints(bool local, std::string_view host_or_intf_name, 
@@ -98,17 +116,59 @@ public:
 
     // Note - std::move used instead of std::forward since an explicit move or copy
     // is needed to prevent worry about dangling references
-    if (local) {
-      m_resolver.async_resolve(host_or_intf_name, service_or_port, 
-                        asio::ip::resolver_base::flags(asio::ip::resolver_base::passive | 
-                                                 asio::ip::resolver_base::address_configured),
-                        std::move(func));
+    if (!m_cache) {
+      m_resolver.async_resolve(host_or_intf_name, service_or_port, resolve_flags(local),
+                               std::move(func));
+      return;
     }
-    else {
-      m_resolver.async_resolve(host_or_intf_name, service_or_port,
-                        std::move(func));
+    auto cached = m_cache->template find<Protocol>(local, host_or_intf_name, service_or_port);
+    if (cached) {
+      asio::post(m_resolver.get_executor(), 
+            [func = std::move(func), res = std::move(*cached)] () mutable {
+          func(std::error_code(), std::move(res));
+        }
+      );
+      return;
     }
-    return;
+    m_resolver.async_resolve(host_or_intf_name, service_or_port, resolve_flags(local),
+            [func = std::move(func), cache = m_cache, local, 
+             host = std::string(host_or_intf_name), port = std::string(service_or_port)]
+                        (const std::error_code& err, results_type res) mutable {
+          if (!err && !res.empty()) {
+            cache->insert(local, host, port, res);
+          }
+          func(err, std::move(res));
+        }
+    );
+  }
+
+/**
+ *  @brief Create a sequence of endpoints without blocking, if possible.
+ *
+ *  Endpoints are returned if the host name is empty or numeric and the port is numeric, 
+ *  or if there is an unexpired entry in the cache. Otherwise the @c std::optional is empty
+ *  and one of the @c make_endpoints methods must be used (typically the asynchronous one).
+ *
+ *  This allows the common case of numeric local endpoints to be handled immediately, without
+ *  a name server lookup or a completion handler invocation.
+ *
+ *  @return @c std::optional, containing @c asio::ip::basic_resolver_results<Protocol> on
+ *  success.
+ */
+  auto try_make_endpoints(bool local, std::string_view host_or_intf_name, 
+                          std::string_view service_or_port) -> std::optional<results_type> {
+
+    std::error_code ec;
+    auto res = m_resolver.resolve(host_or_intf_name, service_or_port,
+          resolve_flags(local) | asio::ip::resolver_base::numeric_host | 
+                                 asio::ip::resolver_base::numeric_service, ec);
+    if (!ec) {
+      return { std::move(res) };
+    }
+    if (m_cache) {
+      return m_cache->template find<Protocol>(local, host_or_intf_name, service_or_port);
+    }
+    return { };
   }
 
 /**
@@ -132,20 +192,34 @@ public:
  */
 
   auto make_endpoints(bool local, std::string_view host_or_intf_name, std::string_view service_or_port) ->
-      nonstd::expected<asio::ip::basic_resolver_results<Protocol>, std::error_code> {
+      nonstd::expected<results_type, std::error_code> {
 
+    if (m_cache) {
+      auto cached = m_cache->template find<Protocol>(local, host_or_intf_name, service_or_port);
+      if (cached) {
+        return *cached;
+      }
+    }
     std::error_code ec;
-    auto res = m_resolver.resolve(host_or_intf_name, service_or_port,
-          (local ? asio::ip::resolver_base::flags(asio::ip::resolver_base::passive | 
-                                                  asio::ip::resolver_base::address_configured) :
-                   asio::ip::resolver_base::flags()), ec);
+    auto res = m_resolver.resolve(host_or_intf_name, service_or_port, resolve_flags(local), ec);
     if (ec) {
       return nonstd::make_unexpected(ec);
     }
+    if (m_cache && !res.empty()) {
+      m_cache->insert(local, host_or_intf_name, service_or_port, res);
+    }
     return res;
 
   }
 
+private:
+
+  static asio::ip::resolver_base::flags resolve_flags(bool local) noexcept {
+    return local ? asio::ip::resolver_base::flags(asio::ip::resolver_base::passive | 
+                                                  asio::ip::resolver_base::address_configured) :
+                   asio::ip::resolver_base::flags();
+  }
+
 };
 
 }  // end net namespace
@@ -24,6 +24,7 @@
 #include <type_traits> // std::is_invocable
 #include <system_error> // std::make_error, std::error_code
 #include <string_view>
+#include <atomic>
 
 #include "nonstd/expected.hpp"
 
@@ -168,6 +169,9 @@ public:
  *  Within the function object socket options can be queried or modified or any valid
  *  socket method called.
  *
+ *  A TCP acceptor created with multiple @c SO_REUSEPORT listening sockets (see
+ *  @c tcp_acceptor_options) invokes the function object once for each listening socket.
+ *
  *  @return @c nonstd::expected - @c bool socket has been visited; on error (if no 
  *  associated IO handler), a @c std::error_code is returned.
  */
@@ -250,6 +254,88 @@ public:
       },  m_wptr);
   }
 
+/**
+ *  @brief Call an application supplied function object with all active @c basic_io_output 
+ *  objects without blocking, then invoke a completion handler with the visit count.
+ *
+ *  This is the non-blocking form of @c visit_io_output, see the blocking form for the
+ *  function object signatures. Both function objects are moved (or copied) and invoked 
+ *  later from a thread running the net entity @c io_context.
+ *
+ *  @param func Function object invoked with each active @c basic_io_output object.
+ *
+ *  @param completion Function object invoked with the number of times @c func has been 
+ *  called, with the following signature:
+ *
+ *  @code
+ *    void (std::size_t);
+ *  @endcode
+ *
+ *  @return @c nonstd::expected - on success the visit has been initiated; on error (if no 
+ *  associated net entity, or a function object mismatch), a @c std::error_code is 
+ *  returned and the completion handler is not invoked.
+ */
+  template <typename F, typename CH>
+  auto visit_io_output(F&& func, CH&& completion) const ->
+          nonstd::expected<void, std::error_code> {
+    return std::visit(detail::overloaded {
+        [&func, &completion] (const udp_wp& wp)-> nonstd::expected<void, std::error_code>  {
+          if constexpr (std::is_invocable_v<F, chops::net::udp_io_output>) {
+            return detail::wp_access_void(wp,
+                [&func, &completion] (detail::udp_entity_io_shared_ptr sp) {
+                  sp->visit_io_output(std::forward<F>(func), std::forward<CH>(completion));
+                  return std::error_code();
+                } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+        [&func, &completion] (const acc_wp& wp)-> nonstd::expected<void, std::error_code>  {
+          if constexpr (std::is_invocable_v<F, chops::net::tcp_io_output>) {
+            return detail::wp_access_void(wp,
+                [&func, &completion] (detail::tcp_acceptor_shared_ptr sp) {
+                  sp->visit_io_output(std::forward<F>(func), std::forward<CH>(completion));
+                  return std::error_code();
+                } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+        [&func, &completion] (const conn_wp& wp)-> nonstd::expected<void, std::error_code>  {
+          if constexpr (std::is_invocable_v<F, chops::net::tcp_io_output>) {
+            return detail::wp_access_void(wp,
+                [&func, &completion] (detail::tcp_connector_shared_ptr sp) {
+                  sp->visit_io_output(std::forward<F>(func), std::forward<CH>(completion));
+                  return std::error_code();
+                } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+      },  m_wptr);
+  }
+
+/**
+ *  @brief Query the IO handler object pool statistics of a TCP acceptor.
+ *
+ *  The pool is configured through the @c tcp_acceptor_options passed in to the
+ *  @c net_ip @c make_tcp_acceptor method. If no pool was configured, all counts
+ *  are 0.
+ *
+ *  @return @c nonstd::expected - on success returns @c tcp_io_pool_stats; on error
+ *  (if no associated net entity, or the net entity is not a TCP acceptor), a 
+ *  @c std::error_code is returned.
+ */
+  auto get_io_handler_pool_stats() const ->
+          nonstd::expected<tcp_io_pool_stats, std::error_code> {
+    return std::visit(detail::overloaded {
+        [] (const acc_wp& wp) -> nonstd::expected<tcp_io_pool_stats, std::error_code> {
+          return detail::wp_access<tcp_io_pool_stats>(wp,
+                 [] (detail::tcp_acceptor_shared_ptr sp) { return sp->get_io_handler_pool_stats(); } );
+        },
+        [] (const auto&) -> nonstd::expected<tcp_io_pool_stats, std::error_code> {
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::net_entity_operation_not_supported));
+        },
+      },  m_wptr);
+  }
+
 /**
  *  @brief Start network processing on the associated net entity with the application
  *  providing IO state change and error function objects.
@@ -374,6 +460,64 @@ public:
       },  m_wptr);
   }
 
+/**
+ *  @brief Start network processing on the associated net entity without blocking, 
+ *  invoking a completion handler when the start processing has run.
+ *
+ *  This is the non-blocking form of @c start, see the blocking form for a description
+ *  of the IO state change and error function objects. Starting many net entities with
+ *  the blocking form costs one round trip to the @c io_context thread for each net entity,
+ *  while this form (or @c start_all) allows all of them to be started in parallel.
+ *
+ *  @param io_state_chg_func IO state change function object.
+ *
+ *  @param err_func Error function object.
+ *
+ *  @param completion Function object invoked from a thread running the net entity 
+ *  @c io_context with the result of the start processing, with the following signature:
+ *
+ *  @code
+ *    void (std::error_code);
+ *  @endcode
+ *
+ *  @return @c nonstd::expected - on success the start has been initiated; on error (e.g. 
+ *  already started, or no associated net entity), a @c std::error_code is returned and 
+ *  the completion handler is not invoked.
+ */
+  template <typename F1, typename F2, typename CH>
+  auto start(F1&& io_state_chg_func, F2&& err_func, CH&& completion) ->
+          nonstd::expected<void, std::error_code> {
+    return std::visit(detail::overloaded {
+        [&io_state_chg_func, &err_func, &completion] (const udp_wp& wp)->nonstd::expected<void, std::error_code> {
+          if constexpr (std::is_invocable_v<F1, udp_io_interface, std::size_t, bool> &&
+                        std::is_invocable_v<F2, udp_io_interface, std::error_code>) {
+            return detail::wp_access_void(wp,
+                [&io_state_chg_func, &err_func, &completion] (detail::udp_entity_io_shared_ptr sp) 
+                  { return sp->start(io_state_chg_func, err_func, std::forward<CH>(completion)); } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+        [&io_state_chg_func, &err_func, &completion] (const acc_wp& wp)->nonstd::expected<void, std::error_code> {
+          if constexpr (std::is_invocable_v<F1, tcp_io_interface, std::size_t, bool> &&
+                        std::is_invocable_v<F2, tcp_io_interface, std::error_code>) {
+            return detail::wp_access_void(wp,
+                [&io_state_chg_func, &err_func, &completion] (detail::tcp_acceptor_shared_ptr sp) 
+                  { return sp->start(io_state_chg_func, err_func, std::forward<CH>(completion)); } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+        [&io_state_chg_func, &err_func, &completion] (const conn_wp& wp)->nonstd::expected<void, std::error_code> {
+          if constexpr (std::is_invocable_v<F1, tcp_io_interface, std::size_t, bool> &&
+                        std::is_invocable_v<F2, tcp_io_interface, std::error_code>) {
+            return detail::wp_access_void(wp,
+                [&io_state_chg_func, &err_func, &completion] (detail::tcp_connector_shared_ptr sp) 
+                  { return sp->start(io_state_chg_func, err_func, std::forward<CH>(completion)); } );
+          }
+          return nonstd::make_unexpected(std::make_error_code(net_ip_errc::functor_variant_mismatch));
+        },
+      },  m_wptr);
+  }
+
 /**
  *  @brief Stop network processing on the associated network entity.
  *
@@ -405,6 +549,43 @@ public:
       },  m_wptr);
   }
 
+/**
+ *  @brief Stop network processing on the associated network entity without blocking, 
+ *  invoking a completion handler when the stop processing has run.
+ *
+ *  @param completion Function object invoked from a thread running the net entity 
+ *  @c io_context with the following signature:
+ *
+ *  @code
+ *    void (std::error_code);
+ *  @endcode
+ *
+ *  @return @c nonstd::expected - on success the stop has been initiated; on error (e.g.
+ *  not started, or no associated net entity), a @c std::error_code is returned and the 
+ *  completion handler is not invoked.
+ */
+  template <typename CH>
+  auto stop(CH&& completion) ->
+          nonstd::expected<void, std::error_code> {
+    return std::visit(detail::overloaded {
+        [&completion] (const udp_wp& wp)->nonstd::expected<void, std::error_code> {
+          return detail::wp_access_void(wp, 
+              [&completion] (detail::udp_entity_io_shared_ptr sp) 
+                { return sp->stop(std::forward<CH>(completion)); } );
+        },
+        [&completion] (const acc_wp& wp)->nonstd::expected<void, std::error_code> {
+          return detail::wp_access_void(wp, 
+              [&completion] (detail::tcp_acceptor_shared_ptr sp) 
+                { return sp->stop(std::forward<CH>(completion)); } );
+        },
+        [&completion] (const conn_wp& wp)->nonstd::expected<void, std::error_code> {
+          return detail::wp_access_void(wp, 
+              [&completion] (detail::tcp_connector_shared_ptr sp) 
+                { return sp->stop(std::forward<CH>(completion)); } );
+        },
+      },  m_wptr);
+  }
+
 /**
  *  @brief Provide a display string of the internal type, whether for logging or
  *  debugging purposes.
@@ -518,6 +699,87 @@ inline bool operator<(const net_entity& lhs, const net_entity& rhs) noexcept {
     }, lhs.m_wptr, rhs.m_wptr);
   }
 
+namespace detail {
+
+template <typename CH>
+struct start_all_state {
+  std::atomic_size_t  m_pending;
+  std::atomic_size_t  m_started;
+  CH                  m_completion;
+
+  template <typename C>
+  explicit start_all_state(C&& completion) : 
+    m_pending(1u), m_started(0u), m_completion(std::forward<C>(completion)) { }
+
+  void done() {
+    if (m_pending.fetch_sub(1u) == 1u) {
+      m_completion(m_started.load());
+    }
+  }
+};
+
+}
+
+/**
+ *  @brief Start a range of @c net_entity objects without blocking, invoking a completion 
+ *  handler once all of them have run their start processing.
+ *
+ *  Each @c net_entity is started with the non-blocking @c start method, so the start 
+ *  processing of all net entities proceeds in parallel instead of one blocking round trip
+ *  to an @c io_context thread for each net entity.
+ *
+ *  All of the net entities must be of the same kind (TCP or UDP) so that the same IO state 
+ *  change and error function objects can be used. They are copied for each net entity.
+ *
+ *  @param beg Beginning iterator of a range of @c net_entity objects.
+ *
+ *  @param end Ending iterator of the range.
+ *
+ *  @param io_state_chg_func IO state change function object, see @c net_entity @c start.
+ *
+ *  @param err_func Error function object, see @c net_entity @c start.
+ *
+ *  @param completion Function object with the following signature, invoked once with the
+ *  number of net entities successfully started:
+ *
+ *  @code
+ *    void (std::size_t);
+ *  @endcode
+ *
+ *  The completion handler is invoked from an @c io_context thread, or from the calling 
+ *  thread if all start processing finishes (or fails to initiate) before @c start_all 
+ *  returns.
+ *
+ *  @return Number of net entities for which the start processing was initiated (net entities
+ *  already started or invalid are not counted).
+ *
+ *  @relates net_entity
+ */
+template <typename Iter, typename F1, typename F2, typename CH>
+std::size_t start_all(Iter beg, Iter end, const F1& io_state_chg_func, const F2& err_func,
+                      CH&& completion) {
+  auto st = std::make_shared<detail::start_all_state<std::decay_t<CH>>>(std::forward<CH>(completion));
+  std::size_t initiated = 0u;
+  for (; beg != end; ++beg) {
+    st->m_pending.fetch_add(1u);
+    auto r = beg->start(io_state_chg_func, err_func, [st] (std::error_code err) {
+        if (!err) {
+          st->m_started.fetch_add(1u);
+        }
+        st->done();
+      }
+    );
+    if (r) {
+      ++initiated;
+    }
+    else {
+      st->done();
+    }
+  }
+  st->done();
+  return initiated;
+}
+
 /**
  *  @brief A "do nothing" error function template that can be used in the 
  *  @c net_entity @c start method.
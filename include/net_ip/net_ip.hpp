@@ -25,6 +25,7 @@
 #include <chrono>
 #include <variant> // std::visit
 #include <type_traits> // std::enable_if
+#include <stdexcept> // std::invalid_argument
 
 #include <mutex> // std::scoped_lock, std::mutex
 
@@ -40,6 +41,9 @@
 #include "net_ip/detail/udp_entity_io.hpp"
 
 #include "net_ip/tcp_connector_timeout.hpp"
+#include "net_ip/tcp_acceptor_options.hpp"
+#include "net_ip/tcp_connector_options.hpp"
+#include "net_ip/resolver_cache.hpp"
 
 namespace chops {
 namespace net {
@@ -74,12 +78,17 @@ namespace net {
  *  name resolution (if needed), a local bind (if needed) and (for TCP) a 
  *  connect or a listen. 
  *
- *  Local host and port and interface name lookups are performed immediately 
- *  using direct (synchronous) lookups when the @c net_entity @c start method
- *  is called. Remote host and port name lookups are performed asynchronously 
- *  (since these may take longer) and are only needed for TCP connectors.
- *  If this is not acceptable, the application can perform the lookup and the 
- *  endpoint (or endpoint sequence) can be passed in through the @c make method.
+ *  Numeric local addresses and ports are converted immediately when the 
+ *  @c net_entity @c start method is called. Other name lookups (local or remote) 
+ *  are performed asynchronously, with the remainder of the start (e.g. the bind and 
+ *  listen) performed when the lookup completes; a lookup failure is then reported 
+ *  through the error callback. Lookup results can be stored in a @c resolver_cache 
+ *  (passed to the @c net_ip constructor) shared by all of the network entities created 
+ *  by the @c net_ip object, so that many entities using the same host name (or 
+ *  reconnects that re-resolve, see @c tcp_connector_options) only perform one lookup 
+ *  per time-to-live period. By default lookups are not cached.
+ *  If asynchronous lookups are not acceptable, the application can perform the lookup 
+ *  and the endpoint (or endpoint sequence) can be passed in through the @c make method.
  *
  *  State change function objects are invoked when network IO can be started as
  *  well as when an error or shutdown occurs.
@@ -123,6 +132,10 @@ class net_ip {
 private:
 
   asio::io_context&                             m_ioc;
+  // if non-empty, network entities are assigned to these io_contexts in turn
+  io_context_refs                               m_entity_iocs;
+  std::size_t                                   m_next_ioc;
+  resolver_cache_shared_ptr                     m_resolver_cache;
   mutable std::mutex                            m_mutex;
 
   std::vector<detail::tcp_acceptor_shared_ptr>  m_acceptors;
@@ -138,9 +151,38 @@ public:
  *  @brief Construct a @c net_ip object without starting any network processing.
  *
  *  @param ioc IO context for asynchronous operations.
+ *
+ *  @param cache Name lookup cache used by the network entities, which can be shared with
+ *  other @c net_ip objects; if empty (the default), lookup results are not cached unless
+ *  a cache is specified in the options of a TCP entity.
+ */
+  explicit net_ip(asio::io_context& ioc, 
+                  resolver_cache_shared_ptr cache = resolver_cache_shared_ptr()) :
+    m_ioc(ioc), m_entity_iocs(), m_next_ioc(0u), m_resolver_cache(std::move(cache)), 
+    m_acceptors(), m_connectors(), m_udp_entities() { }
+
+/**
+ *  @brief Construct a @c net_ip object that assigns the network entities it creates to
+ *  a pool of @c asio::io_context objects in turn, typically each run by a separate thread
+ *  (see @c worker_pool in the @c net_ip_component directory).
+ *
+ *  Each network entity (including the connections of a TCP acceptor, unless 
+ *  @c tcp_acceptor_options specifies otherwise) performs all of its processing through
+ *  its assigned @c asio::io_context, so callbacks for different network entities may be 
+ *  invoked concurrently.
+ *
+ *  @param iocs IO contexts for asynchronous operations, must not be empty. Each 
+ *  @c asio::io_context must be run by only one thread.
+ *
+ *  @param cache Name lookup cache, see the other constructor.
+ *
+ *  @throw std::invalid_argument if @c iocs is empty.
  */
-  explicit net_ip(asio::io_context& ioc) :
-    m_ioc(ioc), m_acceptors(), m_connectors(), m_udp_entities() { }
+  explicit net_ip(const io_context_refs& iocs, 
+                  resolver_cache_shared_ptr cache = resolver_cache_shared_ptr()) :
+    m_ioc(first_ioc(iocs)), m_entity_iocs(iocs), m_next_ioc(0u), 
+    m_resolver_cache(std::move(cache)), 
+    m_acceptors(), m_connectors(), m_udp_entities() { }
 
 private:
 
@@ -169,14 +211,18 @@ public:
  *  @param reuse_addr If @c true (default), the @c reuse_address socket option is set upon 
  *  socket open.
  *
+ *  @param opts Optional settings, such as multiple @c SO_REUSEPORT listening sockets,
+ *  see @c tcp_acceptor_options.
+ *
  *  @return @c net_entity object instantiated for a TCP acceptor.
  *
  */
-  net_entity make_tcp_acceptor (std::string_view local_port_or_service, 
+  net_entity make_tcp_acceptor (std::string_view local_port_or_service,
                                 std::string_view listen_intf = "",
-                                bool reuse_addr = true) {
-    auto p = std::make_shared<detail::tcp_acceptor>(m_ioc, local_port_or_service, 
-                                                    listen_intf, reuse_addr);
+                                bool reuse_addr = true,
+                                const tcp_acceptor_options& opts = tcp_acceptor_options()) {
+    auto p = std::make_shared<detail::tcp_acceptor>(entity_io_context(), local_port_or_service,
+                                                    listen_intf, reuse_addr, with_cache(opts));
     lg g(m_mutex);
     m_acceptors.push_back(p);
     return net_entity(p);
@@ -195,12 +241,16 @@ public:
  *  @param reuse_addr If @c true (default), the @c reuse_address socket option is set upon 
  *  socket open.
  *
+ *  @param opts Optional settings, see @c tcp_acceptor_options.
+ *
  *  @return @c net_entity object instantiated for a TCP acceptor.
  *
  */
   net_entity make_tcp_acceptor (const asio::ip::tcp::endpoint& endp,
-                                bool reuse_addr = true) {
-    auto p = std::make_shared<detail::tcp_acceptor>(m_ioc, endp, reuse_addr);
+                                bool reuse_addr = true,
+                                const tcp_acceptor_options& opts = tcp_acceptor_options()) {
+    auto p = std::make_shared<detail::tcp_acceptor>(entity_io_context(), endp, reuse_addr, 
+                                                    with_cache(opts));
     lg g(m_mutex);
     m_acceptors.push_back(p);
     return net_entity(p);
@@ -225,6 +275,8 @@ public:
  *  this flag specifies whether to start a reconnect attempt; this allows connectors that
  *  run until explicitly stopped.
  *
+ *  @param opts Optional settings, such as TCP Fast Open, see @c tcp_connector_options.
+ *
  *  @return @c net_entity object instantiated for a TCP connector.
  *
  *  @note The name and port lookup to create a sequence of remote TCP endpoints is performed
@@ -237,11 +289,13 @@ public:
   net_entity make_tcp_connector (std::string_view remote_port_or_service,
                                  std::string_view remote_host,
                                  const F& timeout_func = simple_timeout { },
-                                 bool reconn_on_err = false) {
+                                 bool reconn_on_err = false,
+                                 const tcp_connector_options& opts = tcp_connector_options()) {
 
-    auto p = std::make_shared<detail::tcp_connector>(m_ioc, remote_port_or_service, remote_host, 
+    auto p = std::make_shared<detail::tcp_connector>(entity_io_context(), 
+                                                     remote_port_or_service, remote_host, 
                                                      tcp_connector_timeout_func(timeout_func),
-                                                     reconn_on_err);
+                                                     reconn_on_err, with_cache(opts));
     lg g(m_mutex);
     m_connectors.push_back(p);
     return net_entity(p);
@@ -267,6 +321,8 @@ public:
  *  this flag specifies whether to start a reconnect attempt; this allows connectors that
  *  run until explicitly stopped.
  *
+ *  @param opts Optional settings, see @c tcp_connector_options.
+ *
  *  @return @c net_entity object instantiated for a TCP connector.
  *
  *  @note To prevent selection of this method when two @c const @c char* parameters are 
@@ -277,11 +333,12 @@ public:
   template <typename Iter, typename F = simple_timeout>
   auto make_tcp_connector (Iter beg, Iter end,
                            const F& timeout_func = simple_timeout { },
-                           bool reconn_on_err = false) ->
+                           bool reconn_on_err = false,
+                           const tcp_connector_options& opts = tcp_connector_options()) ->
         std::enable_if_t<std::is_same_v<std::decay<decltype(*beg)>, asio::ip::tcp::endpoint>, net_entity> {
-    auto p = std::make_shared<detail::tcp_connector>(m_ioc, beg, end, 
+    auto p = std::make_shared<detail::tcp_connector>(entity_io_context(), beg, end, 
                                                      tcp_connector_timeout_func(timeout_func),
-                                                     reconn_on_err);
+                                                     reconn_on_err, with_cache(opts));
     lg g(m_mutex);
     m_connectors.push_back(p);
     return net_entity(p);
@@ -300,15 +357,18 @@ public:
  *  this flag specifies whether to start a reconnect attempt; this allows connectors that
  *  run until explicitly stopped.
  *
+ *  @param opts Optional settings, see @c tcp_connector_options.
+ *
  *  @return @c net_entity object instantiated for a TCP connector.
  *
  */
   template <typename F = simple_timeout>
   net_entity make_tcp_connector (const asio::ip::tcp::endpoint& endp,
                                  const F& timeout_func = simple_timeout { },
-                                 bool reconn_on_err = false) {
+                                 bool reconn_on_err = false,
+                                 const tcp_connector_options& opts = tcp_connector_options()) {
     std::vector<asio::ip::tcp::endpoint> vec { endp };
-    return make_tcp_connector(vec.cbegin(), vec.cend(), timeout_func, reconn_on_err);
+    return make_tcp_connector(vec.cbegin(), vec.cend(), timeout_func, reconn_on_err, opts);
   }
 
 /**
@@ -340,7 +400,9 @@ public:
  */
   net_entity make_udp_unicast (std::string_view local_port_or_service, 
                                std::string_view local_intf = "") {
-    auto p = std::make_shared<detail::udp_entity_io>(m_ioc, local_port_or_service, local_intf);
+    auto p = std::make_shared<detail::udp_entity_io>(entity_io_context(), 
+                                                     local_port_or_service, local_intf,
+                                                     m_resolver_cache);
     lg g(m_mutex);
     m_udp_entities.push_back(p);
     return net_entity(p);
@@ -360,7 +422,7 @@ public:
  *
  */
   net_entity make_udp_unicast (const asio::ip::udp::endpoint& endp) {
-    auto p = std::make_shared<detail::udp_entity_io>(m_ioc, endp);
+    auto p = std::make_shared<detail::udp_entity_io>(entity_io_context(), endp, m_resolver_cache);
     lg g(m_mutex);
     m_udp_entities.push_back(p);
     return net_entity(p);
@@ -432,6 +494,45 @@ public:
     for (auto i : m_acceptors) { i->stop(); }
   }
 
+/**
+ *  @brief Return the name lookup cache used by the network entities, for example to
+ *  query the hit rate through @c get_stats or to share it with another @c net_ip object.
+ *
+ *  @return @c resolver_cache_shared_ptr, empty if lookups are not cached.
+ */
+  resolver_cache_shared_ptr get_resolver_cache() const noexcept {
+    return m_resolver_cache;
+  }
+
+private:
+
+  static asio::io_context& first_ioc(const io_context_refs& iocs) {
+    if (iocs.empty()) {
+      throw std::invalid_argument("net_ip requires at least one io_context");
+    }
+    return iocs.front().get();
+  }
+
+  asio::io_context& entity_io_context() {
+    lg g(m_mutex);
+    if (m_entity_iocs.empty()) {
+      return m_ioc;
+    }
+    return m_entity_iocs[m_next_ioc++ % m_entity_iocs.size()].get();
+  }
+
+  template <typename Opts>
+  Opts with_cache(const Opts& opts) const {
+    Opts ret(opts);
+    if (ret.no_endpoints_cache) {
+      ret.endpoints_cache.reset();
+    }
+    else if (!ret.endpoints_cache) {
+      ret.endpoints_cache = m_resolver_cache;
+    }
+    return ret;
+  }
+
 };
 
 }  // end net namespace
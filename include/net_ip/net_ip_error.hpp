@@ -52,7 +52,14 @@ enum class net_ip_errc {
   tcp_connector_timeout = 19,
   tcp_connector_no_reconnect_attempted = 20,
 
+  tcp_acceptor_accept_deferred = 21,
+  tcp_acceptor_connection_rejected = 22,
+  tcp_connector_connect_deadline = 23,
+
+  coro_reader_io_stopped = 24,
+
   functor_variant_mismatch = 30,
+  net_entity_operation_not_supported = 31,
 };
 
 namespace detail {
@@ -106,8 +113,20 @@ struct net_ip_err_category : public std::error_category {
     case net_ip_errc::tcp_connector_no_reconnect_attempted:
       return "tcp connector no reconnect attempted";
 
+    case net_ip_errc::tcp_acceptor_accept_deferred:
+      return "tcp acceptor accept deferred, admission limit reached";
+    case net_ip_errc::tcp_acceptor_connection_rejected:
+      return "tcp acceptor connection rejected, admission limit reached";
+    case net_ip_errc::tcp_connector_connect_deadline:
+      return "tcp connector connect attempt deadline expired";
+
+    case net_ip_errc::coro_reader_io_stopped:
+      return "coroutine reader IO stopped, no more messages";
+
     case net_ip_errc::functor_variant_mismatch:
       return "function object does not match internal variant";
+    case net_ip_errc::net_entity_operation_not_supported:
+      return "operation not supported by this net entity type";
     }
     return "(unknown error)";
   }
@@ -2,7 +2,7 @@
  *
  *  @ingroup net_ip_module
  *
- *  @brief Structures containing statistics gathered on internal queues.
+ *  @brief Structures containing statistics gathered on internal queues and pools.
  *
  *  @author Cliff Green
  *
@@ -17,6 +17,7 @@
 #define QUEUE_STATS_HPP_INCLUDED
 
 #include <cstddef> // std::size_t 
+#include <chrono>
 
 namespace chops {
 namespace net {
@@ -24,16 +25,43 @@ namespace net {
 /**
  *  @brief @c output_queue_stats provides information on the internal output 
  *  queue.
+ *
+ *  The two durations allow detection of slow consumers: the age of the oldest queued
+ *  buffer grows when the output queue is not draining, and the write in progress 
+ *  duration grows when the remote side has stopped reading (e.g. a stalled TCP window).
+ *  The durations require output queue time stamping, which is off by default (see 
+ *  @c basic_io_output::enable_output_timestamps), otherwise they are zero.
  */
 
 struct output_queue_stats {
 
   std::size_t output_queue_size = 0u;
   std::size_t bytes_in_output_queue = 0u;
+  // time since the oldest buffer in the output queue was queued, zero if empty or
+  // not time stamped
+  std::chrono::steady_clock::duration oldest_queued_age { };
+  // time since the write in progress was started, zero if no write in progress or
+  // not time stamped
+  std::chrono::steady_clock::duration write_in_progress_duration { };
   // std::size_t total_bufs_sent;
   // std::size_t total_bytes_sent;
 };
 
+/**
+ *  @brief @c tcp_io_pool_stats provides information on the TCP acceptor IO handler 
+ *  object pool (see @c tcp_acceptor_options).
+ *
+ *  A hit is an accepted connection that re-used a pooled IO handler, a miss is an 
+ *  accepted connection that required a new IO handler allocation.
+ */
+
+struct tcp_io_pool_stats {
+
+  std::size_t pool_hits = 0u;
+  std::size_t pool_misses = 0u;
+  std::size_t available = 0u;
+};
+
 } // end net namespace
 } // end chops namespace
 
@@ -0,0 +1,182 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Time-to-live cache of name resolution results, shared across network entities.
+ *
+ *  A @c resolver_cache supplied to a @c net_ip object is used for all of the network
+ *  entities it creates (caching is off by default), so that many connectors to the same
+ *  host only perform one name lookup per time-to-live period. Entries are keyed by
+ *  protocol, lookup type (local or remote), host and port.
+ *
+ *  The cache is safe for concurrent use from multiple threads.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef RESOLVER_CACHE_HPP_INCLUDED
+#define RESOLVER_CACHE_HPP_INCLUDED
+
+#include "asio/ip/address.hpp"
+#include "asio/ip/basic_endpoint.hpp"
+#include "asio/ip/basic_resolver_results.hpp"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <utility> // std::pair
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <memory> // std::shared_ptr
+#include <cstddef> // std::size_t
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Statistics for a @c resolver_cache.
+ *
+ *  A hit is a lookup satisfied from the cache, a miss is a lookup not satisfied from the
+ *  cache (no entry, or the entry has expired), so the hit rate is 
+ *  @c hits / (@c hits + @c misses).
+ */
+struct resolver_cache_stats {
+  std::size_t hits;
+  std::size_t misses;
+  std::size_t entries;
+};
+
+class resolver_cache {
+private:
+  using clock = std::chrono::steady_clock;
+  using addr_port = std::pair<asio::ip::address, unsigned short>;
+  using lk_guard = std::lock_guard<std::mutex>;
+
+  struct entry {
+    std::vector<addr_port>   m_addrs;
+    clock::time_point        m_expiry;
+  };
+
+private:
+  std::unordered_map<std::string, entry>  m_entries;
+  std::chrono::seconds                    m_ttl;
+  std::size_t                             m_hits;
+  std::size_t                             m_misses;
+  mutable std::mutex                      m_mutex;
+
+public:
+
+/**
+ *  @brief Construct with a time-to-live for entries.
+ *
+ *  @param ttl How long resolved endpoints are used before a new lookup is performed.
+ */
+  explicit resolver_cache(std::chrono::seconds ttl = std::chrono::seconds(60)) :
+    m_entries(), m_ttl(ttl), m_hits(0u), m_misses(0u), m_mutex() { }
+
+private:
+  // no copy or assignment semantics for this class
+  resolver_cache(const resolver_cache&) = delete;
+  resolver_cache(resolver_cache&&) = delete;
+  resolver_cache& operator=(const resolver_cache&) = delete;
+  resolver_cache& operator=(resolver_cache&&) = delete;
+
+public:
+
+/**
+ *  @brief Look up a previous resolution result.
+ *
+ *  An expired entry is removed.
+ *
+ *  @return @c std::optional, empty if there is no entry or the entry has expired.
+ */
+  template <typename Protocol>
+  std::optional<asio::ip::basic_resolver_results<Protocol>> find(bool local,
+                          std::string_view host, std::string_view service_or_port) {
+    using endpoint_t = asio::ip::basic_endpoint<Protocol>;
+
+    auto key = make_key<Protocol>(local, host, service_or_port);
+    std::vector<endpoint_t> endps;
+    {
+      lk_guard g(m_mutex);
+      auto iter = m_entries.find(key);
+      if (iter == m_entries.end()) {
+        ++m_misses;
+        return { };
+      }
+      if (iter->second.m_expiry <= clock::now()) {
+        m_entries.erase(iter);
+        ++m_misses;
+        return { };
+      }
+      ++m_hits;
+      for (const auto& ap : iter->second.m_addrs) {
+        endps.emplace_back(ap.first, ap.second);
+      }
+    }
+    return asio::ip::basic_resolver_results<Protocol>::create(endps.cbegin(), endps.cend(),
+                                 std::string(host), std::string(service_or_port));
+  }
+
+/**
+ *  @brief Store a resolution result, replacing any previous entry.
+ */
+  template <typename Protocol>
+  void insert(bool local, std::string_view host, std::string_view service_or_port,
+              const asio::ip::basic_resolver_results<Protocol>& res) {
+    entry e { { }, clock::now() + m_ttl };
+    for (const auto& r : res) {
+      e.m_addrs.emplace_back(r.endpoint().address(), r.endpoint().port());
+    }
+    auto key = make_key<Protocol>(local, host, service_or_port);
+    lk_guard g(m_mutex);
+    m_entries.insert_or_assign(std::move(key), std::move(e));
+  }
+
+/**
+ *  @brief Remove all entries, statistics are not reset.
+ */
+  void clear() {
+    lk_guard g(m_mutex);
+    m_entries.clear();
+  }
+
+/**
+ *  @brief Return hit and miss counts and the number of entries.
+ */
+  resolver_cache_stats get_stats() const {
+    lk_guard g(m_mutex);
+    return resolver_cache_stats { m_hits, m_misses, m_entries.size() };
+  }
+
+private:
+
+  template <typename Protocol>
+  static std::string make_key(bool local, std::string_view host, std::string_view service_or_port) {
+    std::string key;
+    key.reserve(host.size() + service_or_port.size() + 8u);
+    key += std::to_string(Protocol::v4().type());
+    key += (local ? "|l|" : "|r|");
+    key += host;
+    key += '|';
+    key += service_or_port;
+    return key;
+  }
+
+};
+
+using resolver_cache_shared_ptr = std::shared_ptr<resolver_cache>;
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -0,0 +1,91 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief A socket option class template for integer (and boolean) valued socket options
+ *  not directly provided by Asio.
+ *
+ *  Asio provides classes for the common socket options (e.g.
+ *  @c asio::socket_base::reuse_address). Options such as @c SO_REUSEPORT,
+ *  @c TCP_FASTOPEN, @c TCP_DEFER_ACCEPT or @c SO_BUSY_POLL are not provided, and the
+ *  classes Asio uses internally for its own options are an implementation detail. This
+ *  class template meets the Asio @c SettableSocketOption and @c GettableSocketOption
+ *  requirements for any option with an @c int value, for example:
+ *
+ *  @code
+ *    using reuse_port_option = chops::net::int_socket_option<SOL_SOCKET, SO_REUSEPORT>;
+ *    sock.set_option(reuse_port_option(1), ec);
+ *  @endcode
+ *
+ *  Boolean options (at the socket API level) are set with a value of 0 or 1.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef SOCKET_OPTION_HPP_INCLUDED
+#define SOCKET_OPTION_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <stdexcept> // std::length_error
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Socket option with an @c int value, for use with the @c set_option and
+ *  @c get_option methods of Asio sockets and acceptors.
+ *
+ *  @tparam Level Protocol level of the option, e.g. @c SOL_SOCKET or @c IPPROTO_TCP.
+ *
+ *  @tparam Name Option name, e.g. @c SO_REUSEPORT.
+ */
+template <int Level, int Name>
+class int_socket_option {
+private:
+  int   m_value;
+
+public:
+  int_socket_option() noexcept : m_value(0) { }
+
+  explicit int_socket_option(int v) noexcept : m_value(v) { }
+
+/**
+ *  @brief Return the option value, e.g. after a @c get_option call.
+ */
+  int value() const noexcept { return m_value; }
+
+  template <typename Protocol>
+  int level(const Protocol&) const noexcept { return Level; }
+
+  template <typename Protocol>
+  int name(const Protocol&) const noexcept { return Name; }
+
+  template <typename Protocol>
+  int* data(const Protocol&) noexcept { return &m_value; }
+
+  template <typename Protocol>
+  const int* data(const Protocol&) const noexcept { return &m_value; }
+
+  template <typename Protocol>
+  std::size_t size(const Protocol&) const noexcept { return sizeof(m_value); }
+
+  // called by get_option with the size returned by the operating system
+  template <typename Protocol>
+  void resize(const Protocol&, std::size_t s) {
+    if (s != sizeof(m_value)) {
+      throw std::length_error("int_socket_option resize");
+    }
+  }
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
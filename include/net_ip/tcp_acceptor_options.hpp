@@ -0,0 +1,204 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Optional configuration for a TCP acceptor network entity.
+ *
+ *  The defaults in @c tcp_acceptor_options produce the same behavior as a TCP acceptor
+ *  created without options: a single listening socket, with all accepted connections
+ *  handled by the @c asio::io_context passed in to the @c net_ip object.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TCP_ACCEPTOR_OPTIONS_HPP_INCLUDED
+#define TCP_ACCEPTOR_OPTIONS_HPP_INCLUDED
+
+#include "asio/io_context.hpp"
+
+#include "net_ip/resolver_cache.hpp"
+
+#include <vector>
+#include <functional> // std::reference_wrapper
+#include <chrono>
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief A collection of @c asio::io_context references, typically one per thread
+ *  in a thread pool.
+ */
+using io_context_refs = std::vector<std::reference_wrapper<asio::io_context> >;
+
+/**
+ *  @brief Policy for choosing the @c asio::io_context that handles a newly accepted 
+ *  connection, when a pool of @c asio::io_context objects is provided in
+ *  @c tcp_acceptor_options.
+ */
+enum class connection_dispatch {
+  round_robin,        /**< Each new connection uses the next @c asio::io_context in turn. */
+  least_connections   /**< Each new connection uses the @c asio::io_context with the 
+                           fewest open connections. */
+};
+
+/**
+ *  @brief Policy for incoming connections that exceed the TCP acceptor admission limits
+ *  (see @c tcp_acceptor_options).
+ */
+enum class excess_connection_policy {
+  pause_accepting,    /**< Stop accepting, leaving connections in the listen backlog, 
+                           until the limits allow more connections. */
+  accept_and_close    /**< Keep accepting, immediately closing connections that exceed
+                           the limits. */
+};
+
+/**
+ *  @brief Optional settings for a TCP acceptor, passed in to the @c net_ip
+ *  @c make_tcp_acceptor methods.
+ */
+struct tcp_acceptor_options {
+
+/**
+ *  @brief If non-empty, one listening socket is created per @c asio::io_context, all
+ *  bound to the same local endpoint with the @c SO_REUSEPORT socket option set.
+ *
+ *  The operating system load balances incoming connections across the listening
+ *  sockets, and each accepted connection is handled by the @c asio::io_context of
+ *  the socket that accepted it. This allows connection heavy applications to scale
+ *  message handling across threads (typically each @c asio::io_context is run by a
+ *  separate thread).
+ *
+ *  The TCP acceptor bookkeeping (the set of connections, as well as the IO state change
+ *  and error callback invocations) is still performed through the @c asio::io_context
+ *  passed in to the @c net_ip object, so the application callbacks are never invoked
+ *  concurrently. The connection count in the IO state change callback is the total
+ *  across all listening sockets.
+ *
+ *  If the platform does not support @c SO_REUSEPORT the @c start method will fail
+ *  with an @c std::errc::operation_not_supported error.
+ *
+ *  @note Message handler callbacks are invoked from the thread running the @c asio::io_context
+ *  associated with the connection, so different connections may have their message
+ *  handlers invoked concurrently.
+ */
+  io_context_refs       reuse_port_io_contexts;
+
+/**
+ *  @brief If non-empty, a single listening socket accepts connections on the 
+ *  @c asio::io_context passed in to the @c net_ip object, but each accepted connection 
+ *  is handled by an @c asio::io_context from this pool.
+ *
+ *  This distributes message handling across threads without requiring @c SO_REUSEPORT
+ *  support. The TCP acceptor bookkeeping and callbacks behave the same as described
+ *  for @c reuse_port_io_contexts.
+ *
+ *  This field is ignored if @c reuse_port_io_contexts is non-empty.
+ */
+  io_context_refs       connection_io_contexts;
+
+/**
+ *  @brief How an @c asio::io_context is chosen from @c connection_io_contexts.
+ */
+  connection_dispatch   dispatch = connection_dispatch::round_robin;
+
+/**
+ *  @brief Number of TCP IO handler objects preallocated when the TCP acceptor is created,
+ *  which is also the maximum number of objects kept for re-use after their connection 
+ *  closes.
+ *
+ *  A pooled IO handler keeps its read buffer capacity and completion handler storage 
+ *  between connections (output queue storage is not kept), reducing allocations during 
+ *  bursts of incoming connections (such as a reconnect storm after a failover). Connections 
+ *  accepted when the pool is empty allocate a new IO handler, which is returned to the pool
+ *  if there is room. If 0 (the default), no pooling is performed.
+ *
+ *  Pool hit and miss counts are available through the @c net_entity
+ *  @c get_io_handler_pool_stats method.
+ */
+  std::size_t           io_handler_pool_size = 0u;
+
+/**
+ *  @brief Maximum number of concurrent connections, 0 (the default) for no limit.
+ *
+ *  With the @c pause_accepting policy and multiple @c SO_REUSEPORT listening sockets,
+ *  each listening socket may have one accept in progress, so a connection that completes
+ *  beyond the limit is closed (as with the @c accept_and_close policy).
+ */
+  std::size_t           max_connections = 0u;
+
+/**
+ *  @brief Accept rate limit in connections per second, enforced with a token bucket, 
+ *  0.0 (the default) for no limit.
+ */
+  double                accept_rate = 0.0;
+
+/**
+ *  @brief Token bucket size for @c accept_rate, the number of connections that can be 
+ *  accepted in a burst (minimum of 1).
+ */
+  double                accept_burst = 1.0;
+
+/**
+ *  @brief What to do with connections exceeding @c max_connections or @c accept_rate.
+ *
+ *  Each time accepting is paused the error callback is invoked with 
+ *  @c net_ip_errc::tcp_acceptor_accept_deferred, and each connection closed because of 
+ *  the limits results in an error callback invocation with 
+ *  @c net_ip_errc::tcp_acceptor_connection_rejected. Applications wanting counts of these 
+ *  events can tally the error codes.
+ */
+  excess_connection_policy excess_policy = excess_connection_policy::pause_accepting;
+
+/**
+ *  @brief If greater than 0, enable TCP Fast Open on the listening socket(s) (the
+ *  @c TCP_FASTOPEN socket option), with this value as the maximum number of pending
+ *  Fast Open requests.
+ *
+ *  Connectors using Fast Open (see @c tcp_connector_options) can then carry their first
+ *  message in the SYN segment, and the message is available to the IO handler as soon as
+ *  the connection is accepted. The operating system may also require Fast Open to be enabled
+ *  system wide (e.g. the @c net.ipv4.tcp_fastopen sysctl on Linux), otherwise a normal
+ *  handshake is performed.
+ *
+ *  If the platform does not support @c TCP_FASTOPEN the @c start method will fail
+ *  with an @c std::errc::operation_not_supported error.
+ */
+  int                   fast_open_queue_len = 0;
+
+/**
+ *  @brief If greater than 0, enable deferred accept (the @c TCP_DEFER_ACCEPT socket option),
+ *  so that a connection is not accepted until data arrives or this timeout expires.
+ *
+ *  The acceptor (and the IO handler read) is then not woken for connections that have
+ *  not sent anything. This is suitable for protocols where the connecting side sends first.
+ *
+ *  If the platform does not support @c TCP_DEFER_ACCEPT the @c start method will fail
+ *  with an @c std::errc::operation_not_supported error.
+ */
+  std::chrono::seconds  defer_accept = std::chrono::seconds(0);
+
+/**
+ *  @brief Cache used for the local endpoint name lookup, typically shared across network 
+ *  entities; if empty (the default) the cache of the @c net_ip object (if any) is used.
+ */
+  resolver_cache_shared_ptr endpoints_cache;
+
+/**
+ *  @brief If @c true, the local endpoint name lookup is not cached, even if the @c net_ip
+ *  object has a cache; @c endpoints_cache is ignored.
+ */
+  bool                  no_endpoints_cache = false;
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
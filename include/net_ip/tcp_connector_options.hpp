@@ -0,0 +1,120 @@
+/** @file
+ *
+ *  @ingroup net_ip_module
+ *
+ *  @brief Optional configuration for a TCP connector network entity.
+ *
+ *  The defaults in @c tcp_connector_options produce the same behavior as a TCP connector
+ *  created without options.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TCP_CONNECTOR_OPTIONS_HPP_INCLUDED
+#define TCP_CONNECTOR_OPTIONS_HPP_INCLUDED
+
+#include <chrono>
+
+#include "net_ip/resolver_cache.hpp"
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Optional settings for a TCP connector, passed in to the @c net_ip
+ *  @c make_tcp_connector methods.
+ */
+struct tcp_connector_options {
+
+/**
+ *  @brief If @c true, connect using TCP Fast Open (the @c TCP_FASTOPEN_CONNECT socket
+ *  option), so that the first @c send on the connection is carried in the SYN segment.
+ *
+ *  The connect completes immediately, without a network round trip, and the TCP handshake
+ *  is performed when the first data is sent. Typically the application sends a request
+ *  from within the IO state change callback, which then saves a full round trip for
+ *  short-lived request / response connections. The first connect to a server obtains a
+ *  Fast Open cookie and performs a normal handshake, subsequent connects carry data in the
+ *  SYN. The server must enable Fast Open (see @c tcp_acceptor_options), otherwise a normal
+ *  handshake is performed.
+ *
+ *  Since the connect completes before the remote host is contacted, a refused connection
+ *  is reported through the IO handler (as with any other network error on an established
+ *  connection) rather than as a connect failure, and only the first endpoint of a multiple
+ *  endpoint sequence is used.
+ *
+ *  If the platform does not support @c TCP_FASTOPEN_CONNECT the @c start method will fail
+ *  with an @c std::errc::operation_not_supported error.
+ */
+  bool   fast_open = false;
+
+/**
+ *  @brief If @c true, and there are multiple remote endpoints, race staggered connect
+ *  attempts across the endpoints ("happy eyeballs", RFC 8305) instead of trying each
+ *  endpoint only after the previous one fails.
+ *
+ *  A new connect attempt is started every @c attempt_delay (or immediately when an attempt
+ *  fails), without cancelling the attempts in progress. The first attempt to succeed is
+ *  used and the others are cancelled. Endpoints are ordered to alternate between IPv6 and
+ *  IPv4 addresses, starting with the address family of the first endpoint. A single
+ *  unresponsive (e.g. blackholed) address then delays the connect by at most
+ *  @c attempt_delay, rather than the operating system connect timeout.
+ *
+ *  The sequence of attempts counts as a single connect attempt for the 
+ *  @c tcp_connector_timeout_func.
+ */
+  bool   happy_eyeballs = false;
+
+/**
+ *  @brief Delay between starting staggered connect attempts when @c happy_eyeballs is
+ *  @c true, the default is the value recommended by RFC 8305.
+ */
+  std::chrono::milliseconds attempt_delay = std::chrono::milliseconds(250);
+
+/**
+ *  @brief Maximum time for a connect attempt, 0 (the default) for no limit other than the
+ *  operating system connect timeout (which can be minutes, as SYN segments are retried).
+ *
+ *  The deadline covers the whole connect attempt, including all endpoints of a multiple
+ *  endpoint sequence. When it expires the attempt is cancelled, the error callback is 
+ *  invoked with @c net_ip_errc::tcp_connector_connect_deadline, and the attempt is handled
+ *  as any other connect failure: it is counted in the attempt number passed to the
+ *  @c tcp_connector_timeout_func, which determines whether and when to retry.
+ */
+  std::chrono::milliseconds connect_deadline = std::chrono::milliseconds(0);
+
+/**
+ *  @brief If @c true, and the connector was created with a remote host name and port, the 
+ *  name is resolved again before each reconnect, so that address changes (e.g. a DNS based
+ *  failover) are followed.
+ *
+ *  Lookups are satisfied from @c endpoints_cache while the cache entry is unexpired. If a 
+ *  lookup fails, the error callback is invoked with the error and the previously resolved
+ *  endpoints are used.
+ */
+  bool   re_resolve_on_reconnect = false;
+
+/**
+ *  @brief Cache used for the remote endpoint name lookups, typically shared across network
+ *  entities; if empty (the default) the cache of the @c net_ip object (if any) is used.
+ */
+  resolver_cache_shared_ptr endpoints_cache;
+
+/**
+ *  @brief If @c true, remote endpoint name lookups are not cached, even if the @c net_ip 
+ *  object has a cache; @c endpoints_cache is ignored.
+ */
+  bool   no_endpoints_cache = false;
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
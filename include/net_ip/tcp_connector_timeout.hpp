@@ -20,7 +20,9 @@
  *
  *  The following use cases are supported: 1) always return the same timeout (i.e. no scale factor, no 
  *  backoff); 2) scale the timeout by a multiplier or exponential factor for each connect attempt, cap the 
- *  timeout at a max timeout value; 3) stop after N connect attempts.
+ *  timeout at a max timeout value; 3) stop after N connect attempts; 4) exponential backoff with random
+ *  jitter, so that many connectors disconnected at the same time (e.g. by a server restart) spread
+ *  out their reconnect attempts instead of retrying in lockstep.
  *
  *  Other use cases can be implemented by applications providing a function object or lambda in the 
  *  @c make_tcp_connector method call.
@@ -29,7 +31,8 @@
  *  In other words, if a TCP connection is brought down due to a network error and the "re-connect on error"
  *  flag is set @c true in the @c make_tcp_connector call, then the timeout function object will start in 
  *  the initial state (as supplied). This may make a difference for function objects that need to modify 
- *  state. None of the functor classes in this header modify state.
+ *  state. The jitter functor classes in this header modify state (the random number generator), the 
+ *  other functor classes do not.
  *
  *  Copyright (c) 2019 by Cliff Green, Nathan Deutsch
  *
@@ -46,6 +49,9 @@
 #include <chrono>
 #include <optional>
 #include <functional> // std::function
+#include <cstdint> // std::uint64_t, std::uintptr_t
+#include <atomic>
+#include <algorithm> // std::min, std::max
 
 namespace chops {
 namespace net {
@@ -203,6 +209,203 @@ struct exponential_backoff_timeout {
 
 };
 
+namespace detail {
+
+/*
+ *  @brief Small, fast random number generator (xorshift64*) for timeout jitter.
+ *
+ *  Each copy is seeded independently on first use (unless an explicit seed is supplied), 
+ *  from the object address, a process wide counter and the clock, so connectors created from
+ *  the same timeout function object do not produce the same sequence.
+ */
+class jitter_prng {
+public:
+  using tick_type = typename std::chrono::milliseconds::rep;
+
+private:
+  std::uint64_t m_state;
+
+  static std::uint64_t splitmix(std::uint64_t x) noexcept {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+  }
+
+public:
+  explicit jitter_prng(std::uint64_t seed = 0u) noexcept : m_state(seed == 0u ? 0u : splitmix(seed)) { }
+
+  std::uint64_t next() noexcept {
+    if (m_state == 0u) {
+      static std::atomic<std::uint64_t> counter { 0u };
+      m_state = splitmix(reinterpret_cast<std::uintptr_t>(this) ^ splitmix(++counter) ^
+                  static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+      if (m_state == 0u) {
+        m_state = 1u;
+      }
+    }
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+    return m_state * 0x2545F4914F6CDD1Dull;
+  }
+
+  // uniform in the closed range [lo, hi]
+  tick_type uniform(tick_type lo, tick_type hi) noexcept {
+    if (hi <= lo) {
+      return lo;
+    }
+    return lo + static_cast<tick_type>(next() % static_cast<std::uint64_t>(hi - lo + 1));
+  }
+};
+
+// initial * 2^(attempts-1), capped at max
+inline typename std::chrono::milliseconds::rep capped_exponential(std::chrono::milliseconds::rep initial,
+                                                                  std::chrono::milliseconds::rep max,
+                                                                  std::size_t attempts) noexcept {
+  auto tmp = initial;
+  for (std::size_t i = 1u; i < attempts && tmp > 0 && tmp < max; ++i) {
+    tmp = (tmp > max / 2) ? max : tmp * 2;
+  }
+  return std::min(tmp, max);
+}
+
+} // end detail namespace
+
+/*
+ *  @brief Exponential backoff with "full jitter", a random timeout between 0 and the 
+ *  exponential backoff value.
+ *
+ *  The exponential backoff value is the initial timeout doubled for each connect attempt,
+ *  up to a maximum. Full jitter spreads reconnect attempts the most, at the cost of some
+ *  attempts being made almost immediately.
+ *
+ */
+struct full_jitter_timeout {
+
+  using tick_type = typename std::chrono::milliseconds::rep;
+  const tick_type m_initial_ticks;
+  const tick_type m_max_ticks;
+  detail::jitter_prng m_prng;
+
+/*
+ * @brief Construct a @c full_jitter_timeout.
+ *
+ * @param initial_timeout Backoff value for the first connect attempt.
+ *
+ * @param max_timeout Maximum backoff value.
+ *
+ * @param seed Random number generator seed, if 0 (the default) each copy of the function
+ * object is seeded differently.
+ */
+  full_jitter_timeout(std::chrono::milliseconds initial_timeout, std::chrono::milliseconds max_timeout,
+                      std::uint64_t seed = 0u) :
+    m_initial_ticks(initial_timeout.count()), m_max_ticks(max_timeout.count()), m_prng(seed) { }
+
+/*
+ *  @brief Function call interface, for use by TCP connector functionality.
+ *
+ *  This method is not directly called by application code. It is called by the TCP connector
+ *  internal functionality. See file documentation for documentation on parameters and return
+ *  value.
+ */
+  optional_millis operator()(std::size_t attempts) noexcept {
+    auto ceil = detail::capped_exponential(m_initial_ticks, m_max_ticks, attempts);
+    return optional_millis { std::chrono::milliseconds { m_prng.uniform(0, ceil) } };
+  }
+};
+
+/*
+ *  @brief Exponential backoff with "equal jitter", half of the exponential backoff value
+ *  plus a random amount up to the other half.
+ *
+ *  Equal jitter guarantees a minimum wait between attempts while still spreading out
+ *  the attempts of many connectors.
+ *
+ */
+struct equal_jitter_timeout {
+
+  using tick_type = typename std::chrono::milliseconds::rep;
+  const tick_type m_initial_ticks;
+  const tick_type m_max_ticks;
+  detail::jitter_prng m_prng;
+
+/*
+ * @brief Construct an @c equal_jitter_timeout.
+ *
+ * @param initial_timeout Backoff value for the first connect attempt.
+ *
+ * @param max_timeout Maximum backoff value.
+ *
+ * @param seed Random number generator seed, if 0 (the default) each copy of the function
+ * object is seeded differently.
+ */
+  equal_jitter_timeout(std::chrono::milliseconds initial_timeout, std::chrono::milliseconds max_timeout,
+                       std::uint64_t seed = 0u) :
+    m_initial_ticks(initial_timeout.count()), m_max_ticks(max_timeout.count()), m_prng(seed) { }
+
+/*
+ *  @brief Function call interface, for use by TCP connector functionality.
+ *
+ *  This method is not directly called by application code. It is called by the TCP connector
+ *  internal functionality. See file documentation for documentation on parameters and return
+ *  value.
+ */
+  optional_millis operator()(std::size_t attempts) noexcept {
+    auto half = detail::capped_exponential(m_initial_ticks, m_max_ticks, attempts) / 2;
+    return optional_millis { std::chrono::milliseconds { half + m_prng.uniform(0, half) } };
+  }
+};
+
+/*
+ *  @brief "Decorrelated jitter", a random timeout between the initial timeout and three
+ *  times the previous timeout, up to a maximum.
+ *
+ *  The timeout grows based on the previous (random) timeout rather than the attempt count,
+ *  so the attempts of different connectors drift apart over time. The sequence starts over
+ *  when the attempt count is 1 (i.e. after a successful connect).
+ *
+ */
+struct decorrelated_jitter_timeout {
+
+  using tick_type = typename std::chrono::milliseconds::rep;
+  const tick_type m_initial_ticks;
+  const tick_type m_max_ticks;
+  tick_type m_prev_ticks;
+  detail::jitter_prng m_prng;
+
+/*
+ * @brief Construct a @c decorrelated_jitter_timeout.
+ *
+ * @param initial_timeout Minimum timeout value, and the starting point for the sequence.
+ *
+ * @param max_timeout Maximum timeout value.
+ *
+ * @param seed Random number generator seed, if 0 (the default) each copy of the function
+ * object is seeded differently.
+ */
+  decorrelated_jitter_timeout(std::chrono::milliseconds initial_timeout, 
+                              std::chrono::milliseconds max_timeout, std::uint64_t seed = 0u) :
+    m_initial_ticks(initial_timeout.count()), m_max_ticks(max_timeout.count()),
+    m_prev_ticks(initial_timeout.count()), m_prng(seed) { }
+
+/*
+ *  @brief Function call interface, for use by TCP connector functionality.
+ *
+ *  This method is not directly called by application code. It is called by the TCP connector
+ *  internal functionality. See file documentation for documentation on parameters and return
+ *  value.
+ */
+  optional_millis operator()(std::size_t attempts) noexcept {
+    if (attempts <= 1u) {
+      m_prev_ticks = m_initial_ticks;
+    }
+    auto hi = m_prev_ticks > m_max_ticks / 3 ? m_max_ticks : m_prev_ticks * 3;
+    m_prev_ticks = std::min(m_prng.uniform(m_initial_ticks, std::max(hi, m_initial_ticks)), m_max_ticks);
+    return optional_millis { std::chrono::milliseconds { m_prev_ticks } };
+  }
+};
+
 } // end net namespace
 } // end chops namespace
 
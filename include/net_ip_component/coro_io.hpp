@@ -0,0 +1,585 @@
+/** @file
+ *
+ *  @ingroup net_ip_component_module
+ *
+ *  @brief Asio asynchronous operations (usable with C++ 20 coroutines) for reading
+ *  messages, sending with backpressure, and waiting for IO handlers to start.
+ *
+ *  The core library is callback based: a message handler is passed to @c start_io and
+ *  an IO state change function object to @c start. The classes and functions in this
+ *  file adapt those callbacks to Asio initiating functions, so that any Asio completion
+ *  token can be used. With @c asio::use_awaitable an application writes straight line
+ *  coroutine code instead of callback state machines, for example:
+ *
+ *  @code
+ *    asio::awaitable<void> echo(chops::net::tcp_io_interface io) {
+ *      chops::net::coro_reader<chops::net::tcp_io> rdr(co_await asio::this_coro::executor);
+ *      io.start_io(hdr_size, rdr.msg_handler(), msg_frame);
+ *      auto out = *io.make_io_output();
+ *      for (;;) {
+ *        auto [err, buf] = co_await rdr.async_read(asio::as_tuple(asio::use_awaitable));
+ *        if (err) {
+ *          co_return;
+ *        }
+ *        co_await chops::net::async_send(out, chops::const_shared_buffer(buf.data(), buf.size()),
+ *                                        max_bytes, asio::use_awaitable);
+ *      }
+ *    }
+ *  @endcode
+ *
+ *  @note These components are not a necessary dependency of the @c net_ip core
+ *  library, but are useful for applications written with coroutines.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef CORO_IO_HPP_INCLUDED
+#define CORO_IO_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <utility> // std::move, std::pair
+#include <memory> // std::shared_ptr, std::make_shared, std::enable_shared_from_this
+#include <optional>
+#include <system_error>
+#include <mutex>
+#include <deque>
+#include <type_traits> // std::is_same_v
+
+#include "asio/any_io_executor.hpp"
+#include "asio/any_completion_handler.hpp"
+#include "asio/async_result.hpp"
+#include "asio/associated_executor.hpp"
+#include "asio/append.hpp"
+#include "asio/post.hpp"
+#include "asio/dispatch.hpp"
+#include "asio/buffer.hpp"
+#include "asio/io_context.hpp"
+#include "asio/system_executor.hpp"
+#include "asio/error.hpp"
+
+#include "net_ip/basic_io_interface.hpp"
+#include "net_ip/basic_io_output.hpp"
+#include "net_ip/net_ip_error.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+namespace chops {
+namespace net {
+
+namespace detail {
+
+// true if a completion handler with this associated executor can be invoked directly
+// from the calling thread; the executor may be type erased more than once (e.g. an
+// awaitable's any_io_executor inside the any_completion_handler executor)
+template <typename Ex>
+bool can_complete_inline(const Ex& exec) noexcept {
+  if (auto p = exec.template target<asio::io_context::executor_type>()) {
+    return p->running_in_this_thread();
+  }
+  if constexpr (!std::is_same_v<Ex, asio::any_io_executor>) {
+    if (auto p = exec.template target<asio::any_io_executor>()) {
+      return can_complete_inline(*p);
+    }
+  }
+  return false;
+}
+
+template <typename IOT>
+class coro_reader_state {
+public:
+  using endpoint_type = typename IOT::endpoint_type;
+  using read_handler = asio::any_completion_handler<void (std::error_code, asio::const_buffer)>;
+
+private:
+  using queue_elem = std::pair<chops::const_shared_buffer, endpoint_type>;
+
+  asio::any_io_executor     m_exec;
+  std::mutex                m_mutex;
+  read_handler              m_pending;
+  std::deque<queue_elem>    m_queue;
+  chops::const_shared_buffer m_current;
+  endpoint_type             m_endp;
+  std::error_code           m_err;
+
+public:
+  explicit coro_reader_state(asio::any_io_executor exec) : m_exec(std::move(exec)) { }
+
+  // called from the message handler; if a read is waiting and can be completed from this
+  // thread the coroutine is resumed directly (dispatched through the handler's executor,
+  // which runs it before returning) with a view of the IO handler buffer (no copy),
+  // otherwise the buffer is copied
+  bool deliver(asio::const_buffer buf, const endpoint_type& endp) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (m_err) {
+      return false;
+    }
+    if (!m_pending) {
+      m_queue.emplace_back(chops::const_shared_buffer(buf.data(), buf.size()), endp);
+      return true;
+    }
+    read_handler h(std::move(m_pending));
+    m_endp = endp;
+    auto ex = asio::get_associated_executor(h, m_exec);
+    if (can_complete_inline(ex)) {
+      lk.unlock();
+      asio::dispatch(ex, asio::append(std::move(h), std::error_code(), buf));
+      return true;
+    }
+    m_current = chops::const_shared_buffer(buf.data(), buf.size());
+    asio::const_buffer view(m_current.data(), m_current.size());
+    lk.unlock();
+    complete(std::move(h), std::error_code(), view);
+    return true;
+  }
+
+  void start_read(read_handler h) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (!m_queue.empty()) {
+      m_current = std::move(m_queue.front().first);
+      m_endp = m_queue.front().second;
+      m_queue.pop_front();
+      asio::const_buffer view(m_current.data(), m_current.size());
+      lk.unlock();
+      complete(std::move(h), std::error_code(), view);
+      return;
+    }
+    std::error_code err = m_err;
+    if (!err && m_pending) {
+      err = asio::error::already_started;
+    }
+    if (err) {
+      lk.unlock();
+      complete(std::move(h), err, asio::const_buffer());
+      return;
+    }
+    m_pending = std::move(h);
+  }
+
+  // queued messages are still returned by subsequent reads, then the error
+  void close(std::error_code err) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (m_err) {
+      return;
+    }
+    m_err = err;
+    read_handler h(std::move(m_pending));
+    lk.unlock();
+    if (h) {
+      complete(std::move(h), err, asio::const_buffer());
+    }
+  }
+
+  endpoint_type remote_endpoint() const noexcept { return m_endp; }
+
+private:
+  void complete(read_handler h, std::error_code err, asio::const_buffer buf) {
+    asio::post(m_exec, asio::append(std::move(h), err, buf));
+  }
+};
+
+// closes the reader state when the last copy of a message handler is destroyed, which
+// happens when the IO handler stops
+template <typename IOT>
+struct coro_reader_closer {
+  std::shared_ptr<coro_reader_state<IOT>> m_state;
+
+  explicit coro_reader_closer(std::shared_ptr<coro_reader_state<IOT>> st) :
+    m_state(std::move(st)) { }
+  ~coro_reader_closer() {
+    m_state->close(std::make_error_code(net_ip_errc::coro_reader_io_stopped));
+  }
+};
+
+// an empty optional if the output queue holds more than max_bytes, otherwise the result
+// of the send (an error if the IO handler is no longer available or has stopped)
+template <typename IOT>
+std::optional<std::error_code> try_send(const basic_io_output<IOT>& io_out, 
+                                        const chops::const_shared_buffer& buf,
+                                        std::size_t max_bytes) {
+  auto st = io_out.get_output_queue_stats();
+  if (!st) {
+    return std::optional<std::error_code>(st.error());
+  }
+  if (st->bytes_in_output_queue > max_bytes) {
+    return std::optional<std::error_code>();
+  }
+  return std::optional<std::error_code>(io_out.send(buf) ? std::error_code() :
+                                  std::make_error_code(net_ip_errc::io_already_stopped));
+}
+
+// a send waiting for the output queue to drain is resumed by a drain notification from
+// the IO handler (delivered when a write completes), so the operation is shared between
+// the initiating call and the notification function object
+template <typename IOT, typename H>
+class send_op : public std::enable_shared_from_this<send_op<IOT, H>> {
+private:
+  basic_io_output<IOT>                 m_io_out;
+  asio::any_io_executor                m_io_exec; // used if the handler has no executor
+  chops::const_shared_buffer           m_buf;
+  std::size_t                          m_max_bytes;
+  H                                    m_handler;
+
+public:
+  send_op(basic_io_output<IOT> io_out, chops::const_shared_buffer buf, std::size_t max_bytes,
+          H&& handler) :
+    m_io_out(std::move(io_out)), m_io_exec(io_executor(m_io_out)), m_buf(std::move(buf)), 
+    m_max_bytes(max_bytes), m_handler(std::move(handler)) { }
+
+  using executor_type = asio::associated_executor_t<H, asio::any_io_executor>;
+  executor_type get_executor() const noexcept {
+    return asio::get_associated_executor(m_handler, m_io_exec);
+  }
+
+  // the notification is invoked from the IO handler thread (or immediately if the queue
+  // has already drained), the retry is performed through the handler's executor; another
+  // sender may have refilled the queue in between, in which case the wait is repeated
+  void wait() {
+    auto self = this->shared_from_this();
+    auto r = m_io_out.notify_when_drained(m_max_bytes, [self] {
+        asio::post(self->get_executor(), [self] {
+            auto err = try_send(self->m_io_out, self->m_buf, self->m_max_bytes);
+            if (err) {
+              self->done(*err);
+            }
+            else {
+              self->wait();
+            }
+          }
+        );
+      }
+    );
+    if (!r) {
+      done(r.error());
+    }
+  }
+
+private:
+  // the IO handler executor, unless the IO handler has already gone away (the wait then
+  // completes with an error)
+  static asio::any_io_executor io_executor(const basic_io_output<IOT>& io_out) {
+    auto ex = io_out.get_executor();
+    return ex ? *ex : asio::any_io_executor(asio::system_executor());
+  }
+
+  void done(std::error_code err) {
+    auto ex = get_executor();
+    asio::post(ex, asio::append(std::move(m_handler), err));
+  }
+};
+
+template <typename IOT>
+class io_state_awaiter_state {
+public:
+  using io_handler = asio::any_completion_handler<void (std::error_code, basic_io_interface<IOT>)>;
+
+private:
+  asio::any_io_executor                    m_exec;
+  std::mutex                               m_mutex;
+  io_handler                               m_pending;
+  std::deque<basic_io_interface<IOT>>      m_queue;
+  std::error_code                          m_err;
+
+public:
+  explicit io_state_awaiter_state(asio::any_io_executor exec) : m_exec(std::move(exec)) { }
+
+  void add(basic_io_interface<IOT> io) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (m_err) {
+      return;
+    }
+    if (!m_pending) {
+      m_queue.push_back(std::move(io));
+      return;
+    }
+    io_handler h(std::move(m_pending));
+    lk.unlock();
+    complete(std::move(h), std::error_code(), std::move(io));
+  }
+
+  void start_wait(io_handler h) {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (!m_queue.empty()) {
+      auto io = std::move(m_queue.front());
+      m_queue.pop_front();
+      lk.unlock();
+      complete(std::move(h), std::error_code(), std::move(io));
+      return;
+    }
+    std::error_code err = m_err;
+    if (!err && m_pending) {
+      err = asio::error::already_started;
+    }
+    if (err) {
+      lk.unlock();
+      complete(std::move(h), err, basic_io_interface<IOT>());
+      return;
+    }
+    m_pending = std::move(h);
+  }
+
+  void close() {
+    std::unique_lock<std::mutex> lk(m_mutex);
+    if (m_err) {
+      return;
+    }
+    m_err = asio::error::operation_aborted;
+    io_handler h(std::move(m_pending));
+    lk.unlock();
+    if (h) {
+      complete(std::move(h), asio::error::operation_aborted, basic_io_interface<IOT>());
+    }
+  }
+
+private:
+  void complete(io_handler h, std::error_code err, basic_io_interface<IOT> io) {
+    asio::post(m_exec, asio::append(std::move(h), err, std::move(io)));
+  }
+};
+
+} // end detail namespace
+
+/**
+ *  @brief Adapt the message handler callbacks of an IO handler to an asynchronous read
+ *  operation, so that a coroutine can @c co_await the next message.
+ *
+ *  A @c coro_reader provides a message handler (@c msg_handler) to be passed to
+ *  @c start_io, and an @c async_read initiating function which completes with the next
+ *  message (framed as specified in the @c start_io call).
+ *
+ *  Received buffers are handed over without copying when possible: if a read is waiting
+ *  when a message arrives, and the completion handler's associated executor is the
+ *  @c io_context running the IO handler (the normal case, when the coroutine is spawned
+ *  on the same @c io_context as the @c net_ip object), the coroutine is resumed directly
+ *  from the message handler with a view of the IO handler's buffer. Otherwise the message
+ *  is copied into a reference counted buffer and queued. Either way the buffer passed to
+ *  the completion handler is only valid until the next @c async_read or other suspension
+ *  of the coroutine; copy it (e.g. into a @c chops::const_shared_buffer) if it is needed
+ *  longer.
+ *
+ *  Reads do not need a heap allocation in the steady state: the type erased completion
+ *  handler storage is allocated through the handler's associated allocator, which for
+ *  Asio awaitables (and by default) is Asio's thread local recycling allocator.
+ *
+ *  When the IO handler stops (and releases the message handler) any outstanding and
+ *  subsequent reads complete with @c net_ip_errc::coro_reader_io_stopped, after any
+ *  queued messages have been returned. If the @c coro_reader is destroyed first, an
+ *  outstanding read completes with @c asio::error::operation_aborted and the message
+ *  handler returns @c false on the next message, which ends the IO processing.
+ *
+ *  Only one read can be outstanding at a time, and one @c coro_reader is used for one IO
+ *  handler.
+ *
+ *  @tparam IOT Either @c tcp_io or @c udp_io.
+ */
+template <typename IOT>
+class coro_reader {
+public:
+  using endpoint_type = typename IOT::endpoint_type;
+
+private:
+  using state_type = detail::coro_reader_state<IOT>;
+
+  std::shared_ptr<state_type>   m_state;
+
+public:
+
+/**
+ *  @brief Function object type returned by @c msg_handler, to be passed to @c start_io.
+ */
+  class coro_msg_handler {
+  private:
+    std::shared_ptr<state_type>                            m_state;
+    std::shared_ptr<detail::coro_reader_closer<IOT>>       m_closer;
+
+  public:
+    explicit coro_msg_handler(std::shared_ptr<state_type> st) :
+      m_state(st), m_closer(std::make_shared<detail::coro_reader_closer<IOT>>(st)) { }
+
+    bool operator()(asio::const_buffer buf, basic_io_output<IOT>, endpoint_type endp) {
+      return m_state->deliver(buf, endp);
+    }
+  };
+
+public:
+
+/**
+ *  @brief Construct a @c coro_reader.
+ *
+ *  @param exec Executor used to post read completions that are not resumed directly from
+ *  the message handler, normally the executor of the @c io_context used by the @c net_ip
+ *  object.
+ */
+  explicit coro_reader(asio::any_io_executor exec) :
+    m_state(std::make_shared<state_type>(std::move(exec))) { }
+
+  coro_reader(const coro_reader&) = delete;
+  coro_reader& operator=(const coro_reader&) = delete;
+
+  ~coro_reader() {
+    m_state->close(asio::error::operation_aborted);
+  }
+
+/**
+ *  @brief Return a message handler that feeds this reader, to be passed to @c start_io.
+ *
+ *  @return A function object that can be used as a message handler.
+ */
+  coro_msg_handler msg_handler() const { return coro_msg_handler(m_state); }
+
+/**
+ *  @brief Start an asynchronous read of the next message.
+ *
+ *  @param token Asio completion token, e.g. @c asio::use_awaitable. The completion
+ *  signature is @c void(std::error_code, asio::const_buffer).
+ *
+ *  @return As specified by the completion token.
+ */
+  template <typename CompletionToken>
+  auto async_read(CompletionToken&& token) {
+    return asio::async_initiate<CompletionToken, void (std::error_code, asio::const_buffer)>(
+      [] (auto handler, std::shared_ptr<state_type> st) {
+        st->start_read(typename state_type::read_handler(std::move(handler)));
+      }, token, m_state);
+  }
+
+/**
+ *  @brief Return the remote endpoint of the last message returned by @c async_read.
+ *
+ *  For TCP this is the endpoint of the connection, for UDP it is the sender of the
+ *  datagram.
+ */
+  endpoint_type remote_endpoint() const noexcept { return m_state->remote_endpoint(); }
+
+};
+
+/**
+ *  @brief Send a buffer through a @c basic_io_output, completing when the buffer has been
+ *  queued with the output queue under a backpressure limit.
+ *
+ *  If the output queue holds no more than @c max_queued_bytes the buffer is sent
+ *  immediately and the operation completes (through the completion handler's associated
+ *  executor). Otherwise the operation waits for the output queue to drain below the limit
+ *  before sending, so that a fast producer coroutine is paced by the network instead
+ *  of growing the output queue without bound.
+ *
+ *  @param io_out @c basic_io_output to send through.
+ *
+ *  @param buf Buffer to send.
+ *
+ *  @param max_queued_bytes Maximum number of bytes in the output queue for the buffer to
+ *  be sent.
+ *
+ *  @param token Asio completion token, e.g. @c asio::use_awaitable. The completion
+ *  signature is @c void(std::error_code); an error is returned if the IO handler is no
+ *  longer available or has stopped.
+ *
+ *  @return As specified by the completion token.
+ *
+ *  @note When the buffer can be sent immediately, the only allocation is for the posted
+ *  completion, which uses the handler's associated allocator (for Asio awaitables, the
+ *  thread local recycling allocator). While waiting, the operation is resumed by a drain
+ *  notification from the IO handler (see @c basic_io_output::notify_when_drained) 
+ *  instead of polling the output queue, and is allocated only then.
+ */
+template <typename IOT, typename CompletionToken>
+auto async_send(basic_io_output<IOT> io_out, chops::const_shared_buffer buf,
+                std::size_t max_queued_bytes, CompletionToken&& token) {
+  return asio::async_initiate<CompletionToken, void (std::error_code)>(
+    [] (auto handler, basic_io_output<IOT> io_out, chops::const_shared_buffer buf,
+        std::size_t max_bytes) {
+      auto err = detail::try_send(io_out, buf, max_bytes);
+      if (err) { // no wait needed, nothing is allocated other than by the post
+        asio::post(asio::append(std::move(handler), *err));
+        return;
+      }
+      std::make_shared<detail::send_op<IOT, decltype(handler)>>(std::move(io_out),
+                            std::move(buf), max_bytes, std::move(handler))->wait();
+    }, token, std::move(io_out), std::move(buf), max_queued_bytes);
+}
+
+/**
+ *  @brief Adapt the IO state change callback of a @c net_entity to an asynchronous wait
+ *  operation, so that a coroutine can @c co_await the next IO handler being ready (a TCP
+ *  connection accepted or established, or a UDP entity started).
+ *
+ *  The function object returned by @c io_state_change is passed to the @c net_entity
+ *  @c start method (possibly composed with other IO state change function objects). It
+ *  does not call @c start_io, which is left to the application once @c async_wait_io
+ *  completes. For a TCP connector this means a coroutine can @c co_await the connection
+ *  being established (and re-established after a reconnect).
+ *
+ *  Only one wait can be outstanding at a time.
+ *
+ *  @tparam IOT Either @c tcp_io or @c udp_io.
+ */
+template <typename IOT>
+class io_state_awaiter {
+private:
+  using state_type = detail::io_state_awaiter_state<IOT>;
+
+  std::shared_ptr<state_type>   m_state;
+
+public:
+
+/**
+ *  @brief Construct an @c io_state_awaiter.
+ *
+ *  @param exec Executor used to post wait completions.
+ */
+  explicit io_state_awaiter(asio::any_io_executor exec) :
+    m_state(std::make_shared<state_type>(std::move(exec))) { }
+
+  io_state_awaiter(const io_state_awaiter&) = delete;
+  io_state_awaiter& operator=(const io_state_awaiter&) = delete;
+
+  ~io_state_awaiter() { m_state->close(); }
+
+/**
+ *  @brief Return an IO state change function object that feeds this awaiter.
+ *
+ *  @return A copyable function object that can be used with the @c start method.
+ */
+  auto io_state_change() const {
+    return [st = m_state] (basic_io_interface<IOT> io, std::size_t, bool starting) {
+      if (starting) {
+        st->add(std::move(io));
+      }
+    };
+  }
+
+/**
+ *  @brief Start an asynchronous wait for the next IO handler to become ready.
+ *
+ *  @param token Asio completion token, e.g. @c asio::use_awaitable. The completion
+ *  signature is @c void(std::error_code, basic_io_interface<IOT>).
+ *
+ *  @return As specified by the completion token.
+ */
+  template <typename CompletionToken>
+  auto async_wait_io(CompletionToken&& token) {
+    return asio::async_initiate<CompletionToken,
+                                void (std::error_code, basic_io_interface<IOT>)>(
+      [] (auto handler, std::shared_ptr<state_type> st) {
+        st->start_wait(typename state_type::io_handler(std::move(handler)));
+      }, token, m_state);
+  }
+
+/**
+ *  @brief Abort an outstanding wait, and all subsequent waits, with
+ *  @c asio::error::operation_aborted.
+ */
+  void close() { m_state->close(); }
+
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
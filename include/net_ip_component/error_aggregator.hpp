@@ -0,0 +1,401 @@
+/** @file
+ *
+ *  @ingroup net_ip_component_module
+ *
+ *  @brief A lock-free error callback sink that counts errors per code, keeps a
+ *  fixed-size ring of recent error events, and delivers periodic snapshots.
+ *
+ *  The @c wait_queue based error function in @c error_delivery.hpp pushes every error
+ *  (including the informational codes a TCP connector reports on each connect attempt)
+ *  through a mutex protected queue. During periods of heavy connection churn the error
+ *  sink can become a bottleneck. The @c error_aggregator in this file is designed for
+ *  that case: recording an error is a few atomic operations, with no locks and no memory
+ *  allocation, and the application reads the aggregated data at its own pace.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef ERROR_AGGREGATOR_HPP_INCLUDED
+#define ERROR_AGGREGATOR_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+
+#include <system_error>
+#include <ostream>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <vector>
+#include <memory> // std::unique_ptr, std::make_unique
+#include <mutex>
+#include <thread> // std::this_thread::get_id
+#include <functional> // std::hash
+#include <future> // std::shared_future
+
+#include "net_ip/basic_io_interface.hpp"
+#include "net_ip/net_ip_error.hpp"
+
+#include "net_ip_component/error_delivery.hpp"
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Aggregated error data returned by @c error_aggregator::snapshot.
+ *
+ *  Counts are indexed by @c error_aggregator::code_index: each @c net_ip_errc value
+ *  has its own count, and all errors from other categories (e.g. Asio socket errors)
+ *  share one count.
+ */
+struct error_snapshot {
+  static constexpr std::size_t num_net_ip_codes = 32u; // net_ip_errc values are below 32
+  static constexpr std::size_t other_index = num_net_ip_codes;
+  static constexpr std::size_t num_counts = num_net_ip_codes + 1u;
+
+  using counts = std::array<std::size_t, num_counts>;
+
+  std::chrono::steady_clock::time_point   time_p;
+  counts                                  total_counts;    // since construction
+  counts                                  interval_counts; // since the previous snapshot
+  std::size_t                             suppressed;      // events not kept, rate limited
+  std::size_t                             interval_suppressed; // since the previous snapshot
+  std::vector<error_data>                 recent;          // since the previous snapshot,
+                                                           // oldest first
+
+  std::size_t total(net_ip_errc e) const noexcept {
+    return total_counts[static_cast<std::size_t>(e)];
+  }
+  std::size_t interval(net_ip_errc e) const noexcept {
+    return interval_counts[static_cast<std::size_t>(e)];
+  }
+};
+
+static_assert(static_cast<std::size_t>(net_ip_errc::net_entity_operation_not_supported) <
+              error_snapshot::num_net_ip_codes, "net_ip_errc values must fit in the counts");
+
+/**
+ *  @brief Per error code control of which error events are kept in the recent events
+ *  ring of an @c error_aggregator; all errors are counted regardless of the policy.
+ *
+ *  @c sample_every keeps one of every N events (1 keeps every event, 0 keeps none,
+ *  which is useful for frequent informational codes such as
+ *  @c tcp_connector_connecting). Sampling is performed per recording thread, so it is
+ *  approximate when errors are recorded from multiple threads.
+ *
+ *  @c max_per_interval limits the events kept per rate interval (a construction
+ *  parameter of the @c error_aggregator); 0 means no limit. Sampled events over the
+ *  limit are counted as suppressed.
+ */
+struct error_code_policy {
+  std::uint32_t    sample_every = 1u;
+  std::uint32_t    max_per_interval = 0u;
+};
+
+/**
+ *  @brief Lock-free aggregation of the errors delivered through error function callbacks.
+ *
+ *  Each error is counted in a per code counter. The counters are sharded by recording
+ *  thread, each shard in its own cache line, so that IO threads do not contend on the
+ *  same counters. Error events that pass the @c error_code_policy of their code are
+ *  written into a fixed-size ring of recent events, overwriting the oldest. An event
+ *  still being written when a snapshot is taken (and any later events) is reported in
+ *  the next snapshot.
+ *
+ *  The @c snapshot method (typically called periodically, see
+ *  @c periodic_error_snapshots) returns the counts, the counts since the previous
+ *  snapshot, and the events kept since the previous snapshot (at most the ring size,
+ *  the oldest are lost if more were kept). Snapshots serialize on a mutex, but never block
+ *  error recording.
+ *
+ *  All methods can be called concurrently.
+ */
+class error_aggregator {
+public:
+  static constexpr std::size_t num_shards = 8u;
+  static constexpr std::size_t default_ring_size = 256u;
+
+private:
+  using clock = std::chrono::steady_clock;
+  using rep = clock::rep;
+  static constexpr std::size_t num_counts = error_snapshot::num_counts;
+
+  struct alignas(64) shard {
+    std::array<std::atomic_size_t, num_counts>  m_counts { };
+    std::atomic_size_t                          m_suppressed { 0u };
+  };
+
+  struct code_state {
+    std::atomic<std::uint32_t>   m_sample_every { 1u };
+    std::atomic<std::uint32_t>   m_max_per_interval { 0u };
+    std::atomic<rep>             m_window_start { 0 };
+    std::atomic<std::uint32_t>   m_window_cnt { 0u };
+  };
+
+  // sequence lock per slot: odd while being written, 2 * (event index + 1) when written
+  struct ring_slot {
+    std::atomic_size_t                        m_seq { 0u };
+    std::atomic<rep>                          m_time { 0 };
+    std::atomic<const void*>                  m_ptr { nullptr };
+    std::atomic<int>                          m_val { 0 };
+    std::atomic<const std::error_category*>   m_cat { nullptr };
+  };
+
+private:
+  std::array<shard, num_shards>          m_shards;
+  std::array<code_state, num_counts>     m_codes;
+  std::size_t                            m_ring_size;
+  std::unique_ptr<ring_slot[]>           m_ring;
+  std::atomic_size_t                     m_head { 0u };
+  rep                                    m_rate_interval;
+
+  std::mutex                             m_snap_mutex;
+  error_snapshot::counts                 m_last_counts { };
+  std::size_t                            m_last_suppressed { 0u };
+  std::size_t                            m_last_head { 0u };
+
+public:
+
+/**
+ *  @brief Construct an @c error_aggregator.
+ *
+ *  @param ring_size Number of recent error events kept.
+ *
+ *  @param rate_interval Interval for the @c max_per_interval limit of an
+ *  @c error_code_policy.
+ */
+  explicit error_aggregator(std::size_t ring_size = default_ring_size,
+                            std::chrono::milliseconds rate_interval = std::chrono::seconds(1)) :
+      m_ring_size(ring_size == 0u ? 1u : ring_size),
+      m_ring(std::make_unique<ring_slot[]>(m_ring_size)),
+      m_rate_interval(std::chrono::duration_cast<clock::duration>(rate_interval).count()) { }
+
+  error_aggregator(const error_aggregator&) = delete;
+  error_aggregator& operator=(const error_aggregator&) = delete;
+
+/**
+ *  @brief Return the count index of an error code.
+ */
+  static std::size_t code_index(const std::error_code& e) noexcept {
+    auto v = e.value();
+    return (&e.category() == &get_err_category() && v >= 0 &&
+            static_cast<std::size_t>(v) < error_snapshot::num_net_ip_codes) ?
+                static_cast<std::size_t>(v) : error_snapshot::other_index;
+  }
+
+/**
+ *  @brief Set the policy for keeping events of a @c net_ip_errc code in the recent
+ *  events ring.
+ */
+  void set_code_policy(net_ip_errc e, const error_code_policy& policy) noexcept {
+    set_policy(code_index(std::make_error_code(e)), policy);
+  }
+
+/**
+ *  @brief Set the policy for keeping events of error codes from other categories in the
+ *  recent events ring.
+ */
+  void set_other_policy(const error_code_policy& policy) noexcept {
+    set_policy(error_snapshot::other_index, policy);
+  }
+
+/**
+ *  @brief Record an error, without locking or allocating memory.
+ *
+ *  @param io_ptr Address of the IO handler (see @c basic_io_interface::get_ptr), used
+ *  for logging purposes only.
+ *
+ *  @param e Error code.
+ */
+  void record(const void* io_ptr, const std::error_code& e) noexcept {
+    auto idx = code_index(e);
+    auto& sh = m_shards[this_thread_shard()];
+    auto n = sh.m_counts[idx].fetch_add(1u, std::memory_order_relaxed) + 1u;
+
+    auto& cs = m_codes[idx];
+    auto every = cs.m_sample_every.load(std::memory_order_relaxed);
+    if (every == 0u || n % every != 0u) {
+      return;
+    }
+    auto now = clock::now().time_since_epoch().count();
+    auto max = cs.m_max_per_interval.load(std::memory_order_relaxed);
+    if (max != 0u && !within_rate(cs, max, now)) {
+      sh.m_suppressed.fetch_add(1u, std::memory_order_relaxed);
+      return;
+    }
+    write_event(now, io_ptr, e);
+  }
+
+/**
+ *  @brief Return the aggregated error data.
+ *
+ *  @return @c error_snapshot, where the interval counts and recent events are relative
+ *  to the previous call of this method.
+ */
+  error_snapshot snapshot() {
+    std::scoped_lock lk { m_snap_mutex };
+    error_snapshot snap { clock::now(), { }, { }, 0u, 0u, { } };
+    for (const auto& sh : m_shards) {
+      for (std::size_t i = 0u; i < num_counts; ++i) {
+        snap.total_counts[i] += sh.m_counts[i].load(std::memory_order_relaxed);
+      }
+      snap.suppressed += sh.m_suppressed.load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0u; i < num_counts; ++i) {
+      snap.interval_counts[i] = snap.total_counts[i] - m_last_counts[i];
+    }
+    m_last_counts = snap.total_counts;
+    snap.interval_suppressed = snap.suppressed - m_last_suppressed;
+    m_last_suppressed = snap.suppressed;
+    m_last_head = read_events(snap.recent, m_last_head);
+    return snap;
+  }
+
+private:
+  static std::size_t this_thread_shard() noexcept {
+    thread_local const std::size_t shard_idx =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) % num_shards;
+    return shard_idx;
+  }
+
+  void set_policy(std::size_t idx, const error_code_policy& policy) noexcept {
+    m_codes[idx].m_sample_every.store(policy.sample_every, std::memory_order_relaxed);
+    m_codes[idx].m_max_per_interval.store(policy.max_per_interval, std::memory_order_relaxed);
+  }
+
+  // approximate fixed window limit, a window reset races with concurrent counting
+  bool within_rate(code_state& cs, std::uint32_t max, rep now) noexcept {
+    auto start = cs.m_window_start.load(std::memory_order_relaxed);
+    if ((start == 0 || now - start >= m_rate_interval) &&
+        cs.m_window_start.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+      cs.m_window_cnt.store(0u, std::memory_order_relaxed);
+    }
+    return cs.m_window_cnt.fetch_add(1u, std::memory_order_relaxed) < max;
+  }
+
+  void write_event(rep now, const void* io_ptr, const std::error_code& e) noexcept {
+    auto ev = m_head.fetch_add(1u, std::memory_order_relaxed);
+    auto& slot = m_ring[ev % m_ring_size];
+    slot.m_seq.store(2u * ev + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.m_time.store(now, std::memory_order_relaxed);
+    slot.m_ptr.store(io_ptr, std::memory_order_relaxed);
+    slot.m_val.store(e.value(), std::memory_order_relaxed);
+    slot.m_cat.store(&e.category(), std::memory_order_relaxed);
+    slot.m_seq.store(2u * (ev + 1u), std::memory_order_release);
+  }
+
+  // events from index first (adjusted to the ring contents) up to the current head are
+  // read; reading stops at the first event that is still being written, and the index of
+  // that event (or the head) is returned so it is read by the next call; a slot already
+  // overwritten by a later event (the ring wrapped) is skipped
+  std::size_t read_events(std::vector<error_data>& events, std::size_t first) const {
+    auto head = m_head.load(std::memory_order_acquire);
+    if (head - first > m_ring_size) {
+      first = head - m_ring_size;
+    }
+    events.reserve(head - first);
+    for (auto ev = first; ev < head; ++ev) {
+      const auto& slot = m_ring[ev % m_ring_size];
+      auto seq = slot.m_seq.load(std::memory_order_acquire);
+      if (seq < 2u * (ev + 1u)) { // not yet published
+        return ev;
+      }
+      if (seq != 2u * (ev + 1u)) {
+        continue;
+      }
+      auto t = slot.m_time.load(std::memory_order_relaxed);
+      auto p = slot.m_ptr.load(std::memory_order_relaxed);
+      auto v = slot.m_val.load(std::memory_order_relaxed);
+      auto c = slot.m_cat.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.m_seq.load(std::memory_order_relaxed) != seq) {
+        continue;
+      }
+      events.emplace_back(clock::time_point(clock::duration(t)), p, std::error_code(v, *c));
+    }
+    return head;
+  }
+
+};
+
+/**
+ *  @brief Create an error function object that records errors in an
+ *  @c error_aggregator.
+ */
+template <typename IOT>
+auto make_error_func_with_aggregator(error_aggregator& agg) {
+  return [&agg] (basic_io_interface<IOT> io, std::error_code e) {
+    agg.record(io.get_ptr(), e);
+  };
+}
+
+/**
+ *  @brief Take a snapshot of an @c error_aggregator every @c period until a stop signal,
+ *  passing each snapshot to a function object.
+ *
+ *  A final snapshot is taken when the stop signal becomes ready. @c std::async can be
+ *  used to invoke this function in a separate thread.
+ *
+ *  @param agg A reference to an @c error_aggregator.
+ *
+ *  @param period Time between snapshots.
+ *
+ *  @param stop A @c std::shared_future which becomes ready to stop, e.g. from a
+ *  @c std::promise<void>.
+ *
+ *  @param func Function object with a signature of @c void(const error_snapshot&).
+ *
+ *  @return The number of snapshots delivered.
+ */
+template <typename F>
+std::size_t periodic_error_snapshots(error_aggregator& agg, std::chrono::milliseconds period,
+                                     std::shared_future<void> stop, F&& func) {
+  std::size_t cnt = 0u;
+  while (stop.wait_for(period) == std::future_status::timeout) {
+    func(agg.snapshot());
+    ++cnt;
+  }
+  func(agg.snapshot());
+  return cnt + 1u;
+}
+
+/**
+ *  @brief Stream the interval counts and recent events of an @c error_snapshot into an
+ *  @c std::ostream, in the format of @c ostream_error_sink_with_wait_queue.
+ *
+ *  @param snap An @c error_snapshot.
+ *
+ *  @param os A reference to a @c std::ostream, such as @c std::cerr.
+ */
+inline void ostream_error_snapshot(const error_snapshot& snap, std::ostream& os) {
+  auto ms = [] (std::chrono::steady_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+  };
+  os << '[' << ms(snap.time_p) << "] error counts:";
+  for (std::size_t i = 0u; i < error_snapshot::num_net_ip_codes; ++i) {
+    if (snap.interval_counts[i] != 0u) {
+      os << ' ' << get_err_category().message(static_cast<int>(i)) << ": " <<
+            snap.interval_counts[i] << ',';
+    }
+  }
+  os << " other: " << snap.interval_counts[error_snapshot::other_index] <<
+        ", suppressed: " << snap.interval_suppressed << '\n';
+  for (const auto& ev : snap.recent) {
+    os << '[' << ms(ev.time_p) << "] io_addr: " << ev.io_intf_ptr << " err: " <<
+          ev.err << ", " << ev.err.message() << '\n';
+  }
+  os.flush();
+}
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -52,6 +52,9 @@ struct error_data {
 
   error_data(const void* iop, std::error_code e) : 
       time_p(std::chrono::steady_clock::now()), io_intf_ptr(iop), err(std::move(e)) { }
+
+  error_data(std::chrono::steady_clock::time_point tp, const void* iop, std::error_code e) : 
+      time_p(tp), io_intf_ptr(iop), err(std::move(e)) { }
 };
 
 /**
@@ -3,11 +3,11 @@
  *  @ingroup net_ip_component_module
  *
  *  @brief Functions that collect and deliver @c output_queue_stats from a 
- *  sequence.
+ *  sequence, and that notify when the output queues of a sequence have drained.
  *
  *  @author Cliff Green
  *
- *  Copyright (c) 2019 by Cliff Green
+ *  Copyright (c) 2019-2025 by Cliff Green
  *
  *  Distributed under the Boost Software License, Version 1.0. 
  *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
@@ -19,6 +19,12 @@
 
 #include <cstddef> // std::size_t
 #include <numeric> // std::accumulate
+#include <algorithm> // std::max
+#include <memory> // std::shared_ptr, std::make_shared
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <thread> // std::this_thread::sleep_for
 
 #include "net_ip/queue_stats.hpp"
 #include "net_ip/basic_io_output.hpp"
@@ -26,6 +32,148 @@
 namespace chops {
 namespace net {
 
+namespace detail {
+
+// counts are summed, durations are the maximum
+inline output_queue_stats add_output_queue_stats(const output_queue_stats& lhs,
+                                                 const output_queue_stats& rhs) noexcept {
+  return output_queue_stats { lhs.output_queue_size + rhs.output_queue_size,
+                              lhs.bytes_in_output_queue + rhs.bytes_in_output_queue,
+                              std::max(lhs.oldest_queued_age, rhs.oldest_queued_age),
+                              std::max(lhs.write_in_progress_duration, 
+                                       rhs.write_in_progress_duration) };
+}
+
+// fulfills a promise when all of the drain notifications have been delivered; the
+// count starts at 1 so that the promise is not fulfilled while notifications are
+// still being requested
+class drain_latch {
+private:
+  std::atomic_size_t   m_pending { 1u };
+  std::promise<void>   m_prom;
+
+public:
+  std::future<void> get_future() { return m_prom.get_future(); }
+
+  void add() noexcept { ++m_pending; }
+
+  void done() {
+    if (--m_pending == 0u) {
+      m_prom.set_value();
+    }
+  }
+};
+
+template <typename IO>
+void add_drain_notification(const std::shared_ptr<drain_latch>& latch, const IO& io,
+                            std::size_t max_bytes) {
+  latch->add();
+  if (!io.notify_when_drained(max_bytes, [latch] { latch->done(); })) {
+    latch->done(); // no IO handler, nothing to drain
+  }
+}
+
+// re-evaluate cond as output queues drain instead of in a tight loop; max_wait bounds the
+// time between evaluations, and when nothing is queued (so the condition depends on 
+// other activity) the evaluations are max_wait apart
+template <typename S, typename D, typename Cond>
+void wait_until_stats(S&& stats, D&& make_drained, Cond& cond, 
+                      std::chrono::milliseconds max_wait) {
+  std::future<void> drained;
+  auto st = stats();
+  while (!cond(st)) {
+    if (!drained.valid()) {
+      drained = make_drained();
+      // already drained (nothing queued and no write in progress)
+      if (drained.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+        drained = std::future<void>();
+        std::this_thread::sleep_for(max_wait);
+        st = stats();
+        continue;
+      }
+    }
+    if (drained.wait_for(max_wait) == std::future_status::ready) {
+      drained = std::future<void>();
+    }
+    st = stats();
+  }
+}
+
+}
+
+/**
+ *  @brief Default maximum time between evaluations of the condition in the 
+ *  @c accumulate_output_queue_stats_until functions.
+ */
+inline constexpr std::chrono::milliseconds default_stats_max_wait { 100 };
+
+/**
+ *  @brief Create a @c std::future that becomes ready when the output queues of a 
+ *  sequence of @c basic_io_output objects have drained.
+ *
+ *  A drain notification is requested from each @c basic_io_output (see 
+ *  @c basic_io_output::notify_when_drained), and the future becomes ready when all of 
+ *  them have been delivered. Notifications are triggered by write completions, so no 
+ *  polling is performed. An IO handler that is stopped (or no longer exists) is 
+ *  considered drained.
+ *
+ *  @param beg Beginning iterator of sequence of @c basic_io_output
+ *  objects.
+ *
+ *  @param end Ending iterator of sequence.
+ *
+ *  @param max_bytes Threshold of bytes remaining in each output queue; when 0 (the 
+ *  default), all queued data must be written.
+ *
+ *  @return @c std::future<void> which becomes ready when all output queues are drained.
+ */
+template <typename Iter>
+std::future<void> make_output_queue_drained_future(Iter beg, Iter end, 
+                                                   std::size_t max_bytes = 0u) {
+  auto latch = std::make_shared<detail::drain_latch>();
+  auto fut = latch->get_future();
+  for (; beg != end; ++beg) {
+    detail::add_drain_notification(latch, *beg, max_bytes);
+  }
+  latch->done();
+  return fut;
+}
+
+/**
+ *  @brief Create a @c std::future that becomes ready when the output queues of all IO 
+ *  handlers of a sequence of @c net_entity objects have drained.
+ *
+ *  The IO handlers are visited (through the @c visit_io_output method on each 
+ *  @c net_entity) when this function is called; IO handlers created afterwards are
+ *  not included.
+ *
+ *  @tparam IOT Either @c chops::net::tcp_io or @c chops::net::udp_io.
+ *
+ *  @param beg Beginning iterator of sequence of @c net_entity
+ *  objects.
+ *
+ *  @param end Ending iterator of sequence.
+ *
+ *  @param max_bytes Threshold of bytes remaining in each output queue; when 0 (the 
+ *  default), all queued data must be written.
+ *
+ *  @return @c std::future<void> which becomes ready when all output queues are drained.
+ */
+template <typename IOT, typename Iter>
+std::future<void> make_net_entity_output_queue_drained_future(Iter beg, Iter end,
+                                                              std::size_t max_bytes = 0u) {
+  auto latch = std::make_shared<detail::drain_latch>();
+  auto fut = latch->get_future();
+  for (; beg != end; ++beg) {
+    beg->visit_io_output([latch, max_bytes] (basic_io_output<IOT> io) {
+        detail::add_drain_notification(latch, io, max_bytes);
+      }
+    );
+  }
+  latch->done();
+  return fut;
+}
+
 /**
  *  @brief Accumulate @c output_queue_stats given a sequence of
  *  @c basic_io_output objects.
@@ -42,16 +190,15 @@ namespace net {
  *
  *  @param end Ending iterator of sequence.
  *
- *  @return @c output_queue_stats containing accumulated statistics.
+ *  @return @c output_queue_stats containing accumulated statistics (counts are summed,
+ *  durations are the maximum).
  */
 template <typename Iter>
 output_queue_stats accumulate_output_queue_stats(Iter beg, Iter end) {
   return std::accumulate(beg, end, output_queue_stats(),
 			  [] (const output_queue_stats& sum, const auto& io) {
           auto rhs = io.get_output_queue_stats();
-          return rhs ? output_queue_stats { sum.output_queue_size + rhs->output_queue_size,
-                                            sum.bytes_in_output_queue + rhs->bytes_in_output_queue } :
-                       sum;
+          return rhs ? detail::add_output_queue_stats(sum, *rhs) : sum;
     }
   );
 }
@@ -69,22 +216,18 @@ output_queue_stats accumulate_output_queue_stats(Iter beg, Iter end) {
  *    bool (const chops::net::output_queue_stats&)
  *  @endcode
  *
- *  It is highly recommended that a sleep or other blocking operation is performed
- *  when the condition returns @c false, otherwise a tight processing loop will
- *  occur.
+ *  When the condition returns @c false and data is queued, the calling thread blocks
+ *  until the output queues drain (see @c make_output_queue_drained_future) or 
+ *  @c max_wait elapses, then the condition is evaluated again. There is no need for
+ *  the condition to sleep.
  *
  *  For example:
  *  @code
- *  bool check_stats (const chops::net::output_queue_stats& st) {
- *    if (st.output_queue_size == 0u) {
- *      return true;
- *    }
- *    std::this_thread::sleep_for(std::chrono::milliseconds(200));
- *    return false;
- *  }
- *  // above code could also be in a lambda
  *  accumulate_output_queue_stats_until (io_vec.cbegin(), io_vec.cend(),
- *                                       check_stats);
+ *      [] (const chops::net::output_queue_stats& st) { 
+ *        return st.output_queue_size == 0u; 
+ *      }
+ *  );
  *  @endcode
  *
  *  @param beg Beginning iterator of sequence of @c basic_io_output
@@ -95,12 +238,15 @@ output_queue_stats accumulate_output_queue_stats(Iter beg, Iter end) {
  *  @param cond Condition function object invoked after each accumulation,
  *  returning @c true causes accumulation loop to finish. 
  *
+ *  @param max_wait Maximum time between evaluations of the condition.
+ *
  */
 template <typename Iter, typename Cond>
-void accumulate_output_queue_stats_until(Iter beg, Iter end, Cond&& cond) {
-  while (!cond(accumulate_output_queue_stats(beg, end))) {
-    ; // no-op, tight loop
-  }
+void accumulate_output_queue_stats_until(Iter beg, Iter end, Cond&& cond,
+               std::chrono::milliseconds max_wait = default_stats_max_wait) {
+  detail::wait_until_stats([beg, end] { return accumulate_output_queue_stats(beg, end); },
+                           [beg, end] { return make_output_queue_drained_future(beg, end); },
+                           cond, max_wait);
 }
 
 /**
@@ -115,7 +261,8 @@ void accumulate_output_queue_stats_until(Iter beg, Iter end, Cond&& cond) {
  *
  *  @param end Ending iterator of sequence.
  *
- *  @return @c output_queue_stats containing accumulated statistics.
+ *  @return @c output_queue_stats containing accumulated statistics (counts are summed,
+ *  durations are the maximum).
  *  
  */
 template <typename IOT, typename Iter>
@@ -126,13 +273,11 @@ output_queue_stats accumulate_net_entity_output_queue_stats(Iter beg, Iter end)
           ne.visit_io_output([&st] (basic_io_output<IOT> io) {
               auto r = io.get_output_queue_stats();
               if (r) {
-                st.output_queue_size += r->output_queue_size;
-                st.bytes_in_output_queue += r->bytes_in_output_queue;
+                st = detail::add_output_queue_stats(st, *r);
               }
             }
           );
-          return output_queue_stats {sum.output_queue_size + st.output_queue_size,
-                                     sum.bytes_in_output_queue + st.bytes_in_output_queue};
+          return detail::add_output_queue_stats(sum, st);
     }
   );
 }
@@ -142,7 +287,9 @@ output_queue_stats accumulate_net_entity_output_queue_stats(Iter beg, Iter end)
  *  @c net_entity objects until a condition is satisfied.
  *
  *  Given a sequence of @c net_entity objects, accumulate statistics
- *  until a supplied condition function object is satisfied.
+ *  until a supplied condition function object is satisfied. The condition is 
+ *  re-evaluated as the output queues drain, as described for 
+ *  @c accumulate_output_queue_stats_until.
  *
  *  @param beg Beginning iterator of sequence of @c net_entity
  *  objects.
@@ -152,12 +299,16 @@ output_queue_stats accumulate_net_entity_output_queue_stats(Iter beg, Iter end)
  *  @param cond Condition function object invoked after each accumulation,
  *  returning @c true causes accumulation loop to finish. 
  *
+ *  @param max_wait Maximum time between evaluations of the condition.
+ *
  */
 template <typename IOT, typename Iter, typename Cond>
-void accumulate_net_entity_output_queue_stats_until(Iter beg, Iter end, Cond&& cond) {
-  while (!cond(accumulate_net_entity_output_queue_stats<IOT>(beg, end))) {
-    ; // no-op, tight loop
-  }
+void accumulate_net_entity_output_queue_stats_until(Iter beg, Iter end, Cond&& cond,
+               std::chrono::milliseconds max_wait = default_stats_max_wait) {
+  detail::wait_until_stats(
+      [beg, end] { return accumulate_net_entity_output_queue_stats<IOT>(beg, end); },
+      [beg, end] { return make_net_entity_output_queue_drained_future<IOT>(beg, end); },
+      cond, max_wait);
 }
 
 } // end net namespace
@@ -21,13 +21,23 @@
 #define SEND_TO_ALL_HPP_INCLUDED
 
 #include <cstddef> // std::size_t
-#include <utility> // std::move
+#include <utility> // std::move, std::forward
+#include <type_traits> // std::decay_t
 
 #include <mutex>
 #include <vector>
+#include <memory> // std::shared_ptr, std::make_shared
+#include <atomic>
+#include <chrono>
+
+#include "asio/any_io_executor.hpp"
+#include "asio/execution/context.hpp"
+#include "asio/query.hpp"
+#include "asio/post.hpp"
 
 #include "net_ip/basic_io_interface.hpp"
 #include "net_ip/basic_io_output.hpp"
+#include "net_ip/queue_stats.hpp"
 
 #include "net_ip_component/output_queue_stats.hpp"
 
@@ -36,6 +46,79 @@
 namespace chops {
 namespace net {
 
+/**
+ *  @brief Limits and action for detecting a slow consumer in a @c send_to_all collection.
+ *
+ *  A subscriber (@c basic_io_output) exceeds its limits when its output queue holds more
+ *  than @c max_queued_bytes, when the oldest queued buffer is older than 
+ *  @c max_queued_age, or when the write in progress has not completed within
+ *  @c max_write_stall. A zero value disables a limit, and the default policy has no
+ *  limits. An active policy reads the output queue stats (taking the IO handler output
+ *  queue lock) on every send to the subscriber. The age and stall limits also require
+ *  output queue time stamping, which is enabled when the subscriber is added (see
+ *  @c basic_io_output::enable_output_timestamps), adding a clock read per queued buffer
+ *  and per write in the IO handler.
+ *
+ *  When a limit is exceeded at the time of a send, the @c on_limit action is taken:
+ *  @c skip does not send the buffer to the subscriber, @c conflate discards the 
+ *  subscriber's queued buffers and then sends the buffer (only the latest data is 
+ *  delivered), and @c disconnect stops the IO handler (if the subscriber was added 
+ *  through an @c io_interface) and removes the subscriber from the collection.
+ */
+struct slow_consumer_policy {
+  enum class action { skip, conflate, disconnect };
+
+  std::size_t                          max_queued_bytes = 0u;
+  std::chrono::steady_clock::duration  max_queued_age { };
+  std::chrono::steady_clock::duration  max_write_stall { };
+  action                               on_limit = action::skip;
+
+  bool is_active() const noexcept {
+    return max_queued_bytes != 0u || max_queued_age.count() != 0 || 
+           max_write_stall.count() != 0;
+  }
+
+  bool needs_timestamps() const noexcept {
+    return max_queued_age.count() != 0 || max_write_stall.count() != 0;
+  }
+
+  bool exceeded(const output_queue_stats& st) const noexcept {
+    return (max_queued_bytes != 0u && st.bytes_in_output_queue > max_queued_bytes) ||
+           (max_queued_age.count() != 0 && st.oldest_queued_age > max_queued_age) ||
+           (max_write_stall.count() != 0 && st.write_in_progress_duration > max_write_stall);
+  }
+};
+
+/**
+ *  @brief Counts of slow consumer actions taken by a @c send_to_all object.
+ */
+struct slow_consumer_stats {
+  std::size_t skipped = 0u;       // sends skipped
+  std::size_t conflated = 0u;     // output queues discarded
+  std::size_t disconnected = 0u;  // subscribers disconnected and removed
+};
+
+namespace detail {
+
+template <typename CH>
+struct send_parallel_state {
+  std::atomic_size_t  m_pending;
+  std::atomic_size_t  m_sent;
+  CH                  m_completion;
+
+  template <typename C>
+  explicit send_parallel_state(C&& completion) :
+    m_pending(1u), m_sent(0u), m_completion(std::forward<C>(completion)) { }
+
+  void done() {
+    if (m_pending.fetch_sub(1u) == 1u) {
+      m_completion(m_sent.load());
+    }
+  }
+};
+
+}
+
 /**
  *  @brief Manage a collection of @c basic_io_output objects and provide a way
  *  to send data to all. or to all except a specific object.
@@ -57,8 +140,20 @@ namespace net {
  *  A function object operator overload is provided so that a @c std::ref to a @c send_to_all
  *  object can be used in composing function objects for @c io_state_change calls.
  *
+ *  Each subscriber has a @c slow_consumer_policy, so that one stalled receiver does not 
+ *  grow its output queue (and the application's memory) without bound. The default 
+ *  policy for subscribers added through the @c io_state_change interface is specified 
+ *  at construction.
+ *
  *  This class is thread-safe for concurrent access.
  *
+ *  The collection is stored as an immutable snapshot which is atomically replaced
+ *  when a @c basic_io_output is added or removed (read-copy-update). The send methods
+ *  only load the current snapshot, so concurrent sends do not serialize on each other
+ *  and adding or removing an object does not wait for a send in progress (which may
+ *  still be sending to the previous snapshot). Adding or removing copies the collection,
+ *  which favors use cases where sends are much more frequent than membership changes.
+ *
  */
 template <typename IOT>
 class send_to_all {
@@ -68,19 +163,142 @@ private:
   using io_outs     = std::vector<io_out>;
   using io_interface = chops::net::basic_io_interface<IOT>;
 
+  // the three vectors are parallel; the io_interface is only valid for subscribers
+  // added through an io_interface and is used to disconnect a slow consumer
+  struct subscribers {
+    io_outs                             m_io_outs;
+    std::vector<slow_consumer_policy>   m_policies;
+    std::vector<io_interface>           m_io_intfs;
+  };
+  using subscribers_ptr = std::shared_ptr<const subscribers>;
+
+  // subscribers grouped by the execution context owning their IO handler, computed from
+  // a snapshot by the first parallel send after a membership change
+  struct partitions {
+    subscribers_ptr                          m_subs;
+    std::vector<asio::any_io_executor>       m_execs;
+    std::vector<std::vector<std::size_t> >   m_idxs; // indices into m_subs, per executor
+  };
+  using partitions_ptr = std::shared_ptr<const partitions>;
+
+  // the subscribers and slow consumer counts are shared with the tasks posted by 
+  // send_parallel, which may run after the send_to_all object is destroyed
+  struct shared_state {
+    std::mutex                    m_mutex; // serializes adds and removes
+    std::atomic<subscribers_ptr>  m_subs { std::make_shared<const subscribers>() };
+    std::atomic_size_t            m_skipped { 0u };
+    std::atomic_size_t            m_conflated { 0u };
+    std::atomic_size_t            m_disconnected { 0u };
+
+    subscribers_ptr snapshot() const noexcept {
+      return m_subs.load(std::memory_order_acquire);
+    }
+
+    // returns true if the subscriber was in the collection
+    bool remove(const io_out& io) {
+      lock_guard gd { m_mutex };
+      auto cur = snapshot();
+      auto subs = std::make_shared<subscribers>();
+      for (std::size_t i = 0u; i < cur->m_io_outs.size(); ++i) {
+        if ( !(io == cur->m_io_outs[i]) ) {
+          subs->m_io_outs.push_back(cur->m_io_outs[i]);
+          subs->m_policies.push_back(cur->m_policies[i]);
+          subs->m_io_intfs.push_back(cur->m_io_intfs[i]);
+        }
+      }
+      if (subs->m_io_outs.size() == cur->m_io_outs.size()) {
+        return false;
+      }
+      m_subs.store(std::move(subs), std::memory_order_release);
+      return true;
+    }
+
+    // apply the slow consumer policy, returns true if the buffer should be sent
+    bool admit(const subscribers& subs, std::size_t idx) {
+      const auto& policy = subs.m_policies[idx];
+      if (!policy.is_active()) {
+        return true;
+      }
+      const auto& io = subs.m_io_outs[idx];
+      auto st = io.get_output_queue_stats();
+      if (!st || !policy.exceeded(*st)) {
+        return true;
+      }
+      switch (policy.on_limit) {
+      case slow_consumer_policy::action::skip:
+        ++m_skipped;
+        return false;
+      case slow_consumer_policy::action::conflate:
+        io.clear_output_queue();
+        ++m_conflated;
+        return true;
+      case slow_consumer_policy::action::disconnect:
+        if (remove(io)) { // only one concurrent send disconnects
+          auto io_intf = subs.m_io_intfs[idx];
+          io_intf.stop_io();
+          ++m_disconnected;
+        }
+        return false;
+      }
+      return true;
+    }
+  };
+  using shared_state_ptr = std::shared_ptr<shared_state>;
+
 private:
-  mutable std::mutex    m_mutex;
-  io_outs               m_io_outs;
+  shared_state_ptr                      m_state { std::make_shared<shared_state>() };
+  mutable std::atomic<partitions_ptr>   m_parts { };
+  slow_consumer_policy                  m_default_policy;
 
 public:
+/**
+ *  @brief Construct a @c send_to_all object.
+ *
+ *  @param default_policy Slow consumer policy for subscribers added through the 
+ *  @c io_state_change interface or without an explicit policy; the default has no limits.
+ */
+  explicit send_to_all(const slow_consumer_policy& default_policy = slow_consumer_policy()) :
+    m_default_policy(default_policy) { }
+
 /**
  *  @brief Add a @c basic_io_output object to the collection.
  *
  *  @param io @c basic_io_output object to be added.
  */
   void add_io_output(io_out io) {
-    lock_guard gd { m_mutex };
-    m_io_outs.push_back(io);
+    add(io, m_default_policy, io_interface());
+  }
+
+/**
+ *  @brief Add a @c basic_io_output object to the collection with a specific slow
+ *  consumer policy.
+ *
+ *  Since there is no @c io_interface, a @c disconnect action only removes the 
+ *  @c basic_io_output from the collection.
+ *
+ *  @param io @c basic_io_output object to be added.
+ *
+ *  @param policy Slow consumer policy for this subscriber.
+ */
+  void add_io_output(io_out io, const slow_consumer_policy& policy) {
+    add(io, policy, io_interface());
+  }
+
+/**
+ *  @brief Add the @c basic_io_output of an @c io_interface to the collection with a 
+ *  specific slow consumer policy.
+ *
+ *  A @c disconnect action stops IO on the @c io_interface.
+ *
+ *  @param io @c io_interface of the subscriber.
+ *
+ *  @param policy Slow consumer policy for this subscriber.
+ */
+  void add_io_interface(io_interface io, const slow_consumer_policy& policy) {
+    auto ret = io.make_io_output();
+    if (ret) {
+      add(*ret, policy, io);
+    }
   }
 
 /**
@@ -89,8 +307,7 @@ public:
  *  @param io @c basic_io_output object to be removed.
  */
   void remove_io_output(io_out io) {
-    lock_guard gd { m_mutex };
-    std::erase_if (m_io_outs, [io] (auto out) { return io == out; } );
+    m_state->remove(io);
   }
 
 /**
@@ -107,7 +324,7 @@ public:
     }
     
     if (starting) {
-      add_io_output(*ret);
+      add(*ret, m_default_policy, io);
     }
     else {
       remove_io_output(*ret);
@@ -121,9 +338,11 @@ public:
  *  @param buf Reference counted buffer to send.
  */
   void send(chops::const_shared_buffer buf) const {
-    lock_guard gd { m_mutex };
-    for (const auto& io : m_io_outs) {
-      io.send(buf);
+    auto subs = snapshot();
+    for (std::size_t i = 0u; i < subs->m_io_outs.size(); ++i) {
+      if (m_state->admit(*subs, i)) {
+        subs->m_io_outs[i].send(buf);
+      }
     }
   }
 
@@ -136,10 +355,10 @@ public:
  *  @param cur_io @c basic_io_output object to skip.
  */
   void send(chops::const_shared_buffer buf, io_out cur_io) const { // TG
-    lock_guard gd { m_mutex };
-    for (const auto& io : m_io_outs) {
-      if ( !(cur_io == io) ) {
-        io.send(buf);
+    auto subs = snapshot();
+    for (std::size_t i = 0u; i < subs->m_io_outs.size(); ++i) {
+      if ( !(cur_io == subs->m_io_outs[i]) && m_state->admit(*subs, i) ) {
+        subs->m_io_outs[i].send(buf);
       }
     }
   }
@@ -193,12 +412,114 @@ public:
     send(chops::const_shared_buffer(std::move(buf)), cur_io);
   }
 
+/**
+ *  @brief Send a reference counted buffer to all @c basic_io_output objects, with the
+ *  sends performed in parallel by the threads running the IO handlers.
+ *
+ *  The @c basic_io_output objects are grouped by the @c asio::io_context owning the 
+ *  associated IO handler (e.g. when the @c net_ip object was constructed with a pool of
+ *  @c io_context objects). One task per @c io_context is posted, and each task sends 
+ *  the buffer to the @c basic_io_output objects of its own @c io_context. The calling 
+ *  thread only posts the tasks, so this call returns quickly no matter how many 
+ *  @c basic_io_output objects are in the collection.
+ *
+ *  The grouping is computed once per membership change and reused by subsequent 
+ *  parallel sends.
+ *
+ *  @param buf Reference counted buffer to send, shared by all of the sends.
+ *
+ *  @param completion Function object with the following signature, invoked once with 
+ *  the number of @c basic_io_output objects that accepted the buffer:
+ *
+ *  @code
+ *    void (std::size_t);
+ *  @endcode
+ *
+ *  The completion handler is invoked from the @c io_context thread finishing last, or 
+ *  from the calling thread if there are no @c basic_io_output objects to send to.
+ *
+ *  @return Number of tasks posted (one per @c io_context).
+ *
+ *  The tasks share ownership of the collection snapshot and the slow consumer counts,
+ *  so the @c send_to_all object can be destroyed before the tasks have run.
+ *
+ *  @note The IO handler type must provide a @c get_executor method (as the TCP and UDP
+ *  IO handlers do).
+ */
+  template <typename CH>
+  std::size_t send_parallel(chops::const_shared_buffer buf, CH&& completion) const {
+    auto parts = get_partitions();
+    auto st = std::make_shared<detail::send_parallel_state<std::decay_t<CH>>>(
+                        std::forward<CH>(completion));
+    for (std::size_t i = 0u; i < parts->m_execs.size(); ++i) {
+      st->m_pending.fetch_add(1u);
+      asio::post(parts->m_execs[i], [state = m_state, parts, i, buf, st] {
+          std::size_t cnt = 0u;
+          for (auto idx : parts->m_idxs[i]) {
+            if (state->admit(*parts->m_subs, idx) && 
+                parts->m_subs->m_io_outs[idx].send(buf)) {
+              ++cnt;
+            }
+          }
+          st->m_sent.fetch_add(cnt);
+          st->done();
+        }
+      );
+    }
+    st->done();
+    return parts->m_execs.size();
+  }
+
+/**
+ *  @brief Send a range of reference counted buffers to all @c basic_io_output
+ *  objects.
+ *
+ *  Each @c basic_io_output queues the whole range under one lock acquisition, see
+ *  @c basic_io_output::send_batch.
+ *
+ *  @param bufs Range of @c chops::const_shared_buffer objects.
+ *
+ *  @return Total number of buffers accepted, summed over all @c basic_io_output objects.
+ */
+  template <typename R>
+  std::size_t send_batch(const R& bufs) const {
+    auto subs = snapshot();
+    std::size_t cnt = 0u;
+    for (std::size_t i = 0u; i < subs->m_io_outs.size(); ++i) {
+      if (m_state->admit(*subs, i)) {
+        cnt += subs->m_io_outs[i].send_batch(bufs);
+      }
+    }
+    return cnt;
+  }
+
+/**
+ *  @brief Send a range of reference counted buffers to all @c basic_io_output
+ *  objects except @c cur_io.
+ *
+ *  @param bufs Range of @c chops::const_shared_buffer objects.
+ *
+ *  @param cur_io @c basic_io_output object to skip.
+ *
+ *  @return Total number of buffers accepted, summed over all @c basic_io_output objects.
+ */
+  template <typename R>
+  std::size_t send_batch(const R& bufs, io_out cur_io) const {
+    auto subs = snapshot();
+    std::size_t cnt = 0u;
+    for (std::size_t i = 0u; i < subs->m_io_outs.size(); ++i) {
+      if ( !(cur_io == subs->m_io_outs[i]) && m_state->admit(*subs, i) ) {
+        cnt += subs->m_io_outs[i].send_batch(bufs);
+      }
+    }
+    return cnt;
+  }
+
 /**
  *  @brief Return the number of @c basic_io_output objects in the collection.
  */
   std::size_t size() const noexcept {
-    lock_guard gd { m_mutex };
-    return m_io_outs.size();
+    return snapshot()->m_io_outs.size();
   }
 
 /**
@@ -207,8 +528,64 @@ public:
  *  @return @c output_queue_stats object containing total counts.
  */
   auto get_total_output_queue_stats() const noexcept {
-    lock_guard gd { m_mutex };
-    return accumulate_output_queue_stats(m_io_outs.cbegin(), m_io_outs.cend());
+    auto subs = snapshot();
+    return accumulate_output_queue_stats(subs->m_io_outs.cbegin(), subs->m_io_outs.cend());
+  }
+
+/**
+ *  @brief Return the counts of slow consumer actions taken.
+ *
+ *  @return @c slow_consumer_stats object.
+ */
+  slow_consumer_stats get_slow_consumer_stats() const noexcept {
+    return slow_consumer_stats { m_state->m_skipped.load(), m_state->m_conflated.load(), 
+                                 m_state->m_disconnected.load() };
+  }
+
+private:
+  subscribers_ptr snapshot() const noexcept {
+    return m_state->snapshot();
+  }
+
+  void add(io_out io, const slow_consumer_policy& policy, io_interface io_intf) {
+    if (policy.needs_timestamps()) {
+      io.enable_output_timestamps();
+    }
+    lock_guard gd { m_state->m_mutex };
+    auto subs = std::make_shared<subscribers>(*snapshot());
+    subs->m_io_outs.push_back(io);
+    subs->m_policies.push_back(policy);
+    subs->m_io_intfs.push_back(io_intf);
+    m_state->m_subs.store(std::move(subs), std::memory_order_release);
+  }
+
+  partitions_ptr get_partitions() const {
+    auto subs = snapshot();
+    auto parts = m_parts.load(std::memory_order_acquire);
+    if (parts && parts->m_subs == subs) {
+      return parts;
+    }
+    auto new_parts = std::make_shared<partitions>();
+    new_parts->m_subs = subs;
+    std::vector<const asio::execution_context*> ctxs;
+    for (std::size_t idx = 0u; idx < subs->m_io_outs.size(); ++idx) {
+      auto ex = subs->m_io_outs[idx].get_executor();
+      if (!ex) {
+        continue; // IO handler no longer exists
+      }
+      const auto* ctx = &asio::query(*ex, asio::execution::context);
+      std::size_t i = 0u;
+      for (; i < ctxs.size() && ctxs[i] != ctx; ++i) { }
+      if (i == ctxs.size()) {
+        ctxs.push_back(ctx);
+        new_parts->m_execs.push_back(*ex);
+        new_parts->m_idxs.emplace_back();
+      }
+      new_parts->m_idxs[i].push_back(idx);
+    }
+    // a concurrent parallel send may store an equivalent result, either one is fine
+    m_parts.store(new_parts, std::memory_order_release);
+    return new_parts;
   }
 };
 
@@ -216,4 +593,3 @@ public:
 } // end chops namespace
 
 #endif
-
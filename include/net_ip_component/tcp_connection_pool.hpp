@@ -0,0 +1,412 @@
+/** @file
+ *
+ *  @ingroup net_ip_component_module
+ *
+ *  @brief A pool of TCP connectors to the same destination, with the connection for each
+ *  send chosen by load, in turn, or by key.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TCP_CONNECTION_POOL_HPP_INCLUDED
+#define TCP_CONNECTION_POOL_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <utility> // std::move
+#include <memory> // std::shared_ptr, std::make_shared
+#include <functional> // std::hash
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <mutex>
+#include <atomic>
+#include <vector>
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+#include "net_ip/io_type_decls.hpp"
+#include "net_ip/queue_stats.hpp"
+#include "net_ip/tcp_connector_timeout.hpp"
+#include "net_ip/tcp_connector_options.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Policy for choosing the connection used by the @c tcp_connection_pool @c send
+ *  methods.
+ */
+enum class pool_send_policy {
+  least_loaded,   /**< Send on the connection with the fewest bytes in its output queue. */
+  round_robin     /**< Send on each connection in turn. */
+};
+
+/**
+ *  @brief Statistics for one connection of a @c tcp_connection_pool.
+ */
+struct pool_member_stats {
+  bool               connected;   /**< Whether the connection is currently up. */
+  std::size_t        connects;    /**< Number of times the connection has been established. */
+  std::size_t        sends;       /**< Number of buffers sent through the pool on this connection. */
+  std::size_t        bytes_sent;  /**< Number of bytes sent through the pool on this connection. */
+  output_queue_stats queue_stats; /**< Current output queue statistics, zero if not connected. */
+};
+
+/**
+ *  @brief Manage a fixed number of TCP connectors to the same destination, sending each
+ *  buffer on one of the connections.
+ *
+ *  Multiple TCP connections to one upstream allow more throughput than a single connection
+ *  (e.g. when a single connection is limited by the TCP window, or the upstream handles each
+ *  connection on a separate thread). This class creates the TCP connectors through a
+ *  @c net_ip object, tracks which connections are up, and chooses a connection for each
+ *  send:
+ *
+ *  - @c send uses the @c pool_send_policy, either the connection with the smallest
+ *  @c bytes_in_output_queue or each connection in turn.
+ *  - @c send_by_key always uses the same connection for the same key (while the connection
+ *  is up), which keeps the buffers for a key in order.
+ *
+ *  The connectors are created with reconnect on error enabled, so a connection that fails
+ *  is re-established according to the timeout function. Sends skip connections that are
+ *  down; if the chosen connection goes down during the send, the other connections that
+ *  are up are tried in turn, and a send only fails if none of them accepts the buffer.
+ *
+ *  Incoming data is handled by the application IO state change function object passed in
+ *  to @c start, which is invoked for each connection of the pool (typically it calls
+ *  @c start_io).
+ *
+ *  This class is thread-safe for concurrent access.
+ *
+ *  The connections that are up are stored as an immutable snapshot which is atomically
+ *  replaced when a connection goes up or down (read-copy-update, as in @c send_to_all),
+ *  and the per connection counts are atomic. Sends only load the current snapshot, so
+ *  concurrent sends do not serialize on each other or on a pool wide lock.
+ *
+ */
+class tcp_connection_pool {
+private:
+  using lock_guard  = std::scoped_lock<std::mutex>;
+
+  // one entry per connection in pool order, empty if the connection is down
+  using io_outs     = std::vector<std::optional<tcp_io_output> >;
+  using io_outs_ptr = std::shared_ptr<const io_outs>;
+
+  struct member_counts {
+    std::atomic_size_t    m_connects { 0u };
+    std::atomic_size_t    m_sends { 0u };
+    std::atomic_size_t    m_bytes_sent { 0u };
+  };
+
+  // shared with the IO state change function objects, which may be invoked after the
+  // pool is destroyed
+  struct pool_state {
+    std::mutex                   m_mutex; // serializes connection up and down changes
+    std::atomic<io_outs_ptr>     m_io_outs;
+    std::vector<member_counts>   m_counts;
+    pool_send_policy             m_policy;
+    std::atomic_size_t           m_next { 0u };
+
+    pool_state(std::size_t num_conns, pool_send_policy policy) :
+      m_io_outs(std::make_shared<const io_outs>(num_conns)), m_counts(num_conns),
+      m_policy(policy) { }
+
+    io_outs_ptr snapshot() const noexcept {
+      return m_io_outs.load(std::memory_order_acquire);
+    }
+  };
+
+private:
+  net_ip&                       m_nip;
+  std::vector<net_entity>       m_entities;
+  std::shared_ptr<pool_state>   m_state;
+
+public:
+
+/**
+ *  @brief Construct the pool, creating (but not starting) the TCP connectors.
+ *
+ *  @param nip @c net_ip object used to create the TCP connectors, which must outlive
+ *  the pool.
+ *
+ *  @param num_conns Number of connections in the pool.
+ *
+ *  @param remote_port_or_service Port number or service name on remote host.
+ *
+ *  @param remote_host Remote host name or IP address.
+ *
+ *  @param policy How @c send chooses the connection.
+ *
+ *  @param timeout_func @c tcp_connector_timeout_func for connect and reconnect attempts,
+ *  see @c net_ip @c make_tcp_connector.
+ *
+ *  @param opts Optional settings for each TCP connector.
+ */
+  template <typename F = simple_timeout>
+  tcp_connection_pool(net_ip& nip, std::size_t num_conns,
+                      std::string_view remote_port_or_service, std::string_view remote_host,
+                      pool_send_policy policy = pool_send_policy::least_loaded,
+                      const F& timeout_func = simple_timeout { },
+                      const tcp_connector_options& opts = tcp_connector_options()) :
+      m_nip(nip), m_entities(), m_state(std::make_shared<pool_state>(num_conns, policy)) {
+    m_entities.reserve(num_conns);
+    for (std::size_t i = 0u; i < num_conns; ++i) {
+      m_entities.push_back(
+          m_nip.make_tcp_connector(remote_port_or_service, remote_host, timeout_func, true, opts));
+    }
+  }
+
+/**
+ *  @brief Stop the TCP connectors and remove them from the @c net_ip object.
+ */
+  ~tcp_connection_pool() {
+    stop();
+    for (auto& ent : m_entities) {
+      m_nip.remove(ent);
+    }
+  }
+
+private:
+  // no copy or assignment semantics for this class
+  tcp_connection_pool(const tcp_connection_pool&) = delete;
+  tcp_connection_pool(tcp_connection_pool&&) = delete;
+  tcp_connection_pool& operator=(const tcp_connection_pool&) = delete;
+  tcp_connection_pool& operator=(tcp_connection_pool&&) = delete;
+
+public:
+
+/**
+ *  @brief Start all of the TCP connectors.
+ *
+ *  @param io_state_chg_func IO state change function object, invoked for each connection
+ *  with the same signature as the @c net_entity @c start method. It must be copyable,
+ *  one copy is made per connection.
+ *
+ *  @param err_func Error function object, see @c net_entity @c start, copied per connection.
+ *
+ *  @return @c std::error_code of the first TCP connector that failed to start, if any.
+ */
+  template <typename F1, typename F2>
+  std::error_code start(const F1& io_state_chg_func, const F2& err_func) {
+    std::error_code ret;
+    for (std::size_t i = 0u; i < m_entities.size(); ++i) {
+      auto r = m_entities[i].start(
+        [st = m_state, i, io_state_chg_func] (tcp_io_interface io, std::size_t num, bool starting) mutable {
+          if (!starting) { // stop sending before the application sees the connection go down
+            set_io_output(*st, i, std::optional<tcp_io_output>());
+          }
+          io_state_chg_func(io, num, starting);
+          if (starting) { // the application has typically started IO processing
+            auto r = io.make_io_output();
+            set_io_output(*st, i, r ? std::optional<tcp_io_output>(*r) : std::optional<tcp_io_output>());
+          }
+        },
+        err_func);
+      if (!r && !ret) {
+        ret = r.error();
+      }
+    }
+    return ret;
+  }
+
+/**
+ *  @brief Stop all of the TCP connectors.
+ */
+  void stop() {
+    for (auto& ent : m_entities) {
+      ent.stop();
+    }
+  }
+
+/**
+ *  @brief Send a reference counted buffer on one of the connections, chosen by the
+ *  @c pool_send_policy.
+ *
+ *  @param buf Reference counted buffer to send.
+ *
+ *  @return @c false if no connection is up.
+ */
+  bool send(const chops::const_shared_buffer& buf) const {
+    auto& st = *m_state;
+    auto outs = st.snapshot();
+    auto n = outs->size();
+    std::size_t start = st.m_next.fetch_add(1u, std::memory_order_relaxed);
+    std::optional<std::size_t> sel;
+    std::size_t min_bytes = 0u;
+    for (std::size_t j = 0u; j < n; ++j) {
+      auto idx = (start + j) % n;
+      const auto& io_out = (*outs)[idx];
+      if (!io_out) {
+        continue;
+      }
+      if (st.m_policy == pool_send_policy::round_robin) {
+        sel = idx;
+        break;
+      }
+      auto qs = io_out->get_output_queue_stats();
+      auto bytes = qs ? qs->bytes_in_output_queue : 0u;
+      if (!sel || bytes < min_bytes) {
+        sel = idx;
+        min_bytes = bytes;
+      }
+    }
+    if (!sel) {
+      return false;
+    }
+    // the selected connection may have gone down since the snapshot was taken
+    return send_on_member(st, *outs, *sel, buf) || send_on_any(st, *outs, start, *sel, buf);
+  }
+
+/**
+ *  @brief Copy the bytes into a reference counted buffer and send it on one of the
+ *  connections, chosen by the @c pool_send_policy.
+ *
+ *  @return @c false if no connection is up.
+ */
+  bool send(const void* buf, std::size_t sz) const {
+    return send(chops::const_shared_buffer(buf, sz));
+  }
+
+/**
+ *  @brief Move a writable reference counted buffer into an immutable reference counted
+ *  buffer and send it on one of the connections, chosen by the @c pool_send_policy.
+ *
+ *  @return @c false if no connection is up.
+ */
+  bool send(chops::mutable_shared_buffer&& buf) const {
+    return send(chops::const_shared_buffer(std::move(buf)));
+  }
+
+/**
+ *  @brief Send a reference counted buffer on the connection associated with a key.
+ *
+ *  The key is hashed with @c std::hash to choose a connection, so buffers with the same key
+ *  are sent in order on the same connection. If that connection is down, the next connection
+ *  that is up is used (consistently, until the connection is re-established).
+ *
+ *  @param key Key value, for example a session or stream identifier.
+ *
+ *  @param buf Reference counted buffer to send.
+ *
+ *  @return @c false if no connection is up.
+ */
+  template <typename K>
+  bool send_by_key(const K& key, const chops::const_shared_buffer& buf) const {
+    auto outs = m_state->snapshot();
+    return send_on_any(*m_state, *outs, std::hash<K>{}(key), outs->size(), buf);
+  }
+
+/**
+ *  @brief Copy the bytes into a reference counted buffer and send it on the connection
+ *  associated with a key.
+ *
+ *  @return @c false if no connection is up.
+ */
+  template <typename K>
+  bool send_by_key(const K& key, const void* buf, std::size_t sz) const {
+    return send_by_key(key, chops::const_shared_buffer(buf, sz));
+  }
+
+/**
+ *  @brief Move a writable reference counted buffer into an immutable reference counted
+ *  buffer and send it on the connection associated with a key.
+ *
+ *  @return @c false if no connection is up.
+ */
+  template <typename K>
+  bool send_by_key(const K& key, chops::mutable_shared_buffer&& buf) const {
+    return send_by_key(key, chops::const_shared_buffer(std::move(buf)));
+  }
+
+/**
+ *  @brief Return the number of connections in the pool.
+ */
+  std::size_t size() const noexcept {
+    return m_entities.size();
+  }
+
+/**
+ *  @brief Return the number of connections that are currently up.
+ */
+  std::size_t num_connected() const noexcept {
+    auto outs = m_state->snapshot();
+    std::size_t cnt = 0u;
+    for (const auto& io_out : *outs) {
+      cnt += io_out ? 1u : 0u;
+    }
+    return cnt;
+  }
+
+/**
+ *  @brief Return statistics for each connection, in pool order.
+ */
+  std::vector<pool_member_stats> get_member_stats() const {
+    auto outs = m_state->snapshot();
+    std::vector<pool_member_stats> ret;
+    ret.reserve(outs->size());
+    for (std::size_t i = 0u; i < outs->size(); ++i) {
+      const auto& io_out = (*outs)[i];
+      const auto& cnts = m_state->m_counts[i];
+      output_queue_stats qs { };
+      if (io_out) {
+        auto r = io_out->get_output_queue_stats();
+        qs = r ? *r : qs;
+      }
+      ret.push_back(pool_member_stats { io_out.has_value(), cnts.m_connects.load(),
+                                        cnts.m_sends.load(), cnts.m_bytes_sent.load(), qs } );
+    }
+    return ret;
+  }
+
+private:
+
+  static void set_io_output(pool_state& st, std::size_t idx, std::optional<tcp_io_output> io_out) {
+    lock_guard gd { st.m_mutex };
+    if (io_out) {
+      ++st.m_counts[idx].m_connects;
+    }
+    auto outs = std::make_shared<io_outs>(*st.snapshot());
+    (*outs)[idx] = std::move(io_out);
+    st.m_io_outs.store(std::move(outs), std::memory_order_release);
+  }
+
+  // try each connection that is up, in pool order from start, except skip_idx; returns
+  // true on the first one that accepts the buffer
+  static bool send_on_any(pool_state& st, const io_outs& outs, std::size_t start, 
+                          std::size_t skip_idx, const chops::const_shared_buffer& buf) {
+    auto n = outs.size();
+    for (std::size_t j = 0u; j < n; ++j) {
+      auto idx = (start + j) % n;
+      if (idx != skip_idx && outs[idx] && send_on_member(st, outs, idx, buf)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool send_on_member(pool_state& st, const io_outs& outs, std::size_t idx,
+                             const chops::const_shared_buffer& buf) {
+    if (!outs[idx]->send(buf)) {
+      return false;
+    }
+    auto& cnts = st.m_counts[idx];
+    cnts.m_sends.fetch_add(1u, std::memory_order_relaxed);
+    cnts.m_bytes_sent.fetch_add(buf.size(), std::memory_order_relaxed);
+    return true;
+  }
+
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -0,0 +1,366 @@
+/** @file
+ *
+ *  @ingroup net_ip_component_module
+ *
+ *  @brief A class template that routes published buffers to the @c basic_io_output
+ *  objects subscribed to a topic.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TOPIC_ROUTER_HPP_INCLUDED
+#define TOPIC_ROUTER_HPP_INCLUDED
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <utility> // std::move
+
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <memory> // std::shared_ptr, std::make_shared
+#include <map>
+#include <unordered_map>
+#include <algorithm> // std::find, std::any_of
+
+#include "net_ip/basic_io_interface.hpp"
+#include "net_ip/basic_io_output.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief Route published buffers to the @c basic_io_output objects subscribed to a
+ *  topic.
+ *
+ *  Where @c send_to_all sends to every @c basic_io_output in a collection, a
+ *  @c topic_router keeps a subscriber collection per topic, and a publish only sends
+ *  to the subscribers of one topic. A @c basic_io_output can subscribe to any number of
+ *  topics, typically from within a message handler (which is passed the
+ *  @c basic_io_output of the incoming message).
+ *
+ *  Each publish sends one reference counted buffer to all of the topic subscribers, so
+ *  there is at most one buffer copy per publish no matter how many subscribers.
+ *
+ *  A function object operator overload is provided so that a @c std::ref to a
+ *  @c topic_router object can be used in composing function objects for
+ *  @c io_state_change calls. When an IO handler stops, its @c basic_io_output is
+ *  unsubscribed from all topics.
+ *
+ *  The subscribers of a topic are stored as an immutable, compact array which is
+ *  replaced when a subscriber is added or removed. A publish looks up the topic, copies
+ *  the (reference counted) pointer to the array under a shared lock, then sends without
+ *  holding any lock. Publishing does not allocate memory (other than whatever the IO
+ *  handler needs to queue the buffer), and concurrent publishes do not serialize on each
+ *  other. A publish concurrent with an unsubscribe may still send to the unsubscribed
+ *  @c basic_io_output.
+ *
+ *  This class is thread-safe for concurrent access.
+ *
+ *  @tparam IOT IO handler type, e.g. @c tcp_io or @c udp_entity_io.
+ *
+ *  @tparam T Topic id type, which must be hashable and equality comparable.
+ *
+ */
+template <typename IOT, typename T = std::uint64_t>
+class topic_router {
+public:
+  using topic_type   = T;
+
+private:
+  using io_out       = chops::net::basic_io_output<IOT>;
+  using io_outs      = std::vector<io_out>;
+  using io_outs_ptr  = std::shared_ptr<const io_outs>;
+  using io_interface = chops::net::basic_io_interface<IOT>;
+  using read_lock    = std::shared_lock<std::shared_mutex>;
+  using write_lock   = std::scoped_lock<std::shared_mutex>;
+
+  // stable when the IO handler is destroyed, unlike operator< and operator==
+  struct owner_less {
+    bool operator() (const io_out& lhs, const io_out& rhs) const noexcept {
+      return lhs.owner_before(rhs);
+    }
+  };
+  static bool same_owner(const io_out& lhs, const io_out& rhs) noexcept {
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+  }
+
+private:
+  mutable std::shared_mutex                               m_mutex;
+  std::unordered_map<topic_type, io_outs_ptr>             m_topics;
+  // reverse index, used to unsubscribe a stopped IO handler from all of its topics
+  std::map<io_out, std::vector<topic_type>, owner_less>   m_subs;
+
+public:
+
+  topic_router() = default;
+
+/**
+ *  @brief Subscribe a @c basic_io_output object to a topic.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param io @c basic_io_output object to be added to the topic subscribers.
+ *
+ *  @return @c true if subscribed, @c false if already subscribed to the topic.
+ */
+  bool subscribe(const topic_type& topic, io_out io) {
+    write_lock gd { m_mutex };
+    auto& cur = m_topics[topic];
+    if (cur && std::any_of(cur->cbegin(), cur->cend(), 
+                           [&io] (const io_out& o) { return same_owner(io, o); })) {
+      return false;
+    }
+    auto outs = cur ? std::make_shared<io_outs>(*cur) : std::make_shared<io_outs>();
+    outs->push_back(io);
+    cur = std::move(outs);
+    m_subs[io].push_back(topic);
+    return true;
+  }
+
+/**
+ *  @brief Unsubscribe a @c basic_io_output object from a topic.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param io @c basic_io_output object to be removed from the topic subscribers.
+ *
+ *  @return @c true if unsubscribed, @c false if not subscribed to the topic.
+ */
+  bool unsubscribe(const topic_type& topic, io_out io) {
+    write_lock gd { m_mutex };
+    auto iter = m_subs.find(io);
+    if (iter == m_subs.end()) {
+      return false;
+    }
+    auto& topics = iter->second;
+    auto t_iter = std::find(topics.begin(), topics.end(), topic);
+    if (t_iter == topics.end()) {
+      return false;
+    }
+    topics.erase(t_iter);
+    if (topics.empty()) {
+      m_subs.erase(iter);
+    }
+    remove_from_topic(topic, io);
+    return true;
+  }
+
+/**
+ *  @brief Unsubscribe a @c basic_io_output object from all topics.
+ *
+ *  @param io @c basic_io_output object to be removed.
+ *
+ *  @return Number of topics the @c basic_io_output was unsubscribed from.
+ */
+  std::size_t unsubscribe_all(io_out io) {
+    write_lock gd { m_mutex };
+    auto iter = m_subs.find(io);
+    if (iter == m_subs.end()) {
+      return 0u;
+    }
+    for (const auto& topic : iter->second) {
+      remove_from_topic(topic, io);
+    }
+    auto cnt = iter->second.size();
+    m_subs.erase(iter);
+    return cnt;
+  }
+
+/**
+ *  @brief Interface for @c io_state_change parameter of @c start
+ *  method.
+ *
+ *  Subscriptions are made by the application (e.g. in a message handler), so nothing
+ *  is done when an IO handler starts. When an IO handler stops, it is unsubscribed
+ *  from all topics.
+ *
+ *  See documentation of @c net_entity for @c start callback
+ *  parameters.
+ */
+  void operator() (io_interface io, std::size_t, bool starting) {
+    if (starting) {
+      return;
+    }
+    auto ret = io.make_io_output();
+    if (ret) {
+      unsubscribe_all(*ret);
+    }
+  }
+
+/**
+ *  @brief Publish a reference counted buffer to all subscribers of a topic.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param buf Reference counted buffer to send.
+ *
+ *  @return Number of subscribers that accepted the buffer.
+ */
+  std::size_t publish(const topic_type& topic, chops::const_shared_buffer buf) const {
+    auto outs = subscribers(topic);
+    std::size_t cnt = 0u;
+    if (outs) {
+      for (const auto& io : *outs) {
+        cnt += io.send(buf) ? 1u : 0u;
+      }
+    }
+    return cnt;
+  }
+
+/**
+ *  @brief Publish a reference counted buffer to all subscribers of a topic except
+ *  @c cur_io.
+ *
+ *  This is useful when a message published by one subscriber is forwarded to the
+ *  other subscribers of the topic.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param buf Reference counted buffer to send.
+ *
+ *  @param cur_io @c basic_io_output object to skip.
+ *
+ *  @return Number of subscribers that accepted the buffer.
+ */
+  std::size_t publish(const topic_type& topic, chops::const_shared_buffer buf,
+                      io_out cur_io) const {
+    auto outs = subscribers(topic);
+    std::size_t cnt = 0u;
+    if (outs) {
+      for (const auto& io : *outs) {
+        if (!same_owner(cur_io, io)) {
+          cnt += io.send(buf) ? 1u : 0u;
+        }
+      }
+    }
+    return cnt;
+  }
+
+/**
+ *  @brief Copy the bytes, create a reference counted buffer, then publish it to all
+ *  subscribers of a topic.
+ *
+ *  The buffer is only created if the topic has subscribers.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param buf Pointer to @c char or @c std::byte array (other types can be
+ *  used but will be treated as bytes).
+ *
+ *  @param sz Number of bytes to send.
+ *
+ *  @return Number of subscribers that accepted the buffer.
+ */
+  std::size_t publish(const topic_type& topic, const void* buf, std::size_t sz) const {
+    return has_subscribers(topic) ? publish(topic, chops::const_shared_buffer(buf, sz)) : 0u;
+  }
+
+/**
+ *  @brief Copy the bytes, create a reference counted buffer, then publish it to all
+ *  subscribers of a topic except @c cur_io.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param buf Pointer to @c char or @c std::byte array.
+ *
+ *  @param sz Number of bytes to send.
+ *
+ *  @param cur_io @c basic_io_output object to skip.
+ *
+ *  @return Number of subscribers that accepted the buffer.
+ */
+  std::size_t publish(const topic_type& topic, const void* buf, std::size_t sz,
+                      io_out cur_io) const {
+    return has_subscribers(topic) ?
+             publish(topic, chops::const_shared_buffer(buf, sz), cur_io) : 0u;
+  }
+
+/**
+ *  @brief Move the buffer from a writable reference counted buffer to an
+ *  immutable reference counted buffer, then publish it to all subscribers of a topic.
+ *
+ *  @param topic Topic id.
+ *
+ *  @param buf Reference counted buffer to send.
+ *
+ *  @return Number of subscribers that accepted the buffer.
+ */
+  std::size_t publish(const topic_type& topic, chops::mutable_shared_buffer&& buf) const {
+    return publish(topic, chops::const_shared_buffer(std::move(buf)));
+  }
+
+/**
+ *  @brief Return the number of subscribers of a topic.
+ */
+  std::size_t num_subscribers(const topic_type& topic) const {
+    auto outs = subscribers(topic);
+    return outs ? outs->size() : 0u;
+  }
+
+/**
+ *  @brief Return whether a topic has any subscribers.
+ */
+  bool has_subscribers(const topic_type& topic) const {
+    return num_subscribers(topic) != 0u;
+  }
+
+/**
+ *  @brief Return the number of topics with at least one subscriber.
+ */
+  std::size_t num_topics() const {
+    read_lock gd { m_mutex };
+    return m_topics.size();
+  }
+
+/**
+ *  @brief Return the number of @c basic_io_output objects subscribed to at least one
+ *  topic.
+ */
+  std::size_t size() const {
+    read_lock gd { m_mutex };
+    return m_subs.size();
+  }
+
+private:
+  io_outs_ptr subscribers(const topic_type& topic) const {
+    read_lock gd { m_mutex };
+    auto iter = m_topics.find(topic);
+    return iter == m_topics.end() ? io_outs_ptr() : iter->second;
+  }
+
+  // m_mutex must be held for writing
+  void remove_from_topic(const topic_type& topic, const io_out& io) {
+    auto iter = m_topics.find(topic);
+    if (iter == m_topics.end()) {
+      return;
+    }
+    const auto& cur = *(iter->second);
+    if (cur.size() == 1u) {
+      m_topics.erase(iter);
+      return;
+    }
+    auto outs = std::make_shared<io_outs>();
+    outs->reserve(cur.size() - 1u);
+    for (const auto& o : cur) {
+      if (!same_owner(io, o)) {
+        outs->push_back(o);
+      }
+    }
+    iter->second = std::move(outs);
+  }
+};
+
+} // end net namespace
+} // end chops namespace
+
+#endif
+
@@ -20,17 +20,154 @@
 #define WORKER_HPP_INCLUDED
 
 #include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstddef> // std::size_t
+#include <cstdint> // std::int64_t, std::uint64_t
+#include <system_error>
 
 #include <exception>
 #include <iostream>
 
+#if defined(__linux__)
+#include <sys/socket.h> // SO_BUSY_POLL
+#endif
+
 #include "asio/io_context.hpp"
 #include "asio/any_io_executor.hpp"
 #include "asio/executor_work_guard.hpp"
 
+#include "net_ip/socket_option.hpp"
+
 namespace chops {
 namespace net {
 
+/**
+ *  @brief Run loop counters for a @c worker or one thread of a @c worker_pool.
+ *
+ *  The work time is the time spent in handlers found ready when the thread polls the
+ *  @c asio::io_context. A handler run immediately after the thread wakes from blocking is
+ *  counted in @c handlers but not in @c busy, so for a lightly loaded thread that blocks 
+ *  the utilization is a lower bound; under load (when handlers are queued), or when 
+ *  spinning, it is accurate.
+ */
+struct worker_thread_stats {
+  std::size_t               handlers;  /**< Number of handlers run. */
+  std::chrono::nanoseconds  busy;      /**< Time spent running handlers. */
+  std::chrono::nanoseconds  spin;      /**< Time spent polling without finding work. */
+  std::size_t               blocks;    /**< Number of times the thread blocked waiting for work. */
+  std::chrono::nanoseconds  elapsed;   /**< Time since the thread started (until it ended). */
+  bool                      pinned;    /**< Whether the thread was pinned to a CPU. */
+
+/**
+ *  @brief Return the fraction of elapsed time spent running handlers, 0.0 to 1.0.
+ */
+  double utilization() const noexcept {
+    return elapsed.count() > 0 ?
+             static_cast<double>(busy.count()) / static_cast<double>(elapsed.count()) : 0.0;
+  }
+};
+
+#if defined(SO_BUSY_POLL)
+using busy_poll_option = int_socket_option<SOL_SOCKET, SO_BUSY_POLL>;
+#endif
+
+/**
+ *  @brief Set the @c SO_BUSY_POLL socket option, so that the kernel busy polls the device
+ *  queue for up to @c usecs on blocking receives and @c poll calls for the socket.
+ *
+ *  This complements the busy polling run loop (see @c worker::start_busy_poll) for
+ *  network devices that support it. Typically it is set from the IO state change callback,
+ *  through the @c basic_io_interface @c visit_socket method. Raising the value above the
+ *  system default (the @c net.core.busy_read sysctl on Linux) may require privileges.
+ *
+ *  @param sock Any Asio socket.
+ *
+ *  @param usecs Busy poll time, 0 to disable.
+ *
+ *  @return @c std::error_code, @c std::errc::operation_not_supported if the platform 
+ *  does not support @c SO_BUSY_POLL.
+ */
+template <typename Socket>
+std::error_code set_busy_poll_option(Socket& sock, std::chrono::microseconds usecs) {
+#if defined(SO_BUSY_POLL)
+  std::error_code ec;
+  sock.set_option(busy_poll_option(static_cast<int>(usecs.count())), ec);
+  return ec;
+#else
+  return std::make_error_code(std::errc::operation_not_supported);
+#endif
+}
+
+namespace detail {
+
+struct run_counters {
+  std::atomic<std::uint64_t>   m_handlers { 0u };
+  std::atomic<std::int64_t>    m_busy_ns { 0 };
+  std::atomic<std::int64_t>    m_spin_ns { 0 };
+  std::atomic<std::uint64_t>   m_blocks { 0u };
+  std::atomic<std::int64_t>    m_start_ns { 0 };
+  std::atomic<std::int64_t>    m_end_ns { 0 };
+  std::atomic_bool             m_pinned { false };
+
+  static std::int64_t now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  worker_thread_stats get_stats() const noexcept {
+    auto start = m_start_ns.load();
+    auto end = m_end_ns.load();
+    auto elapsed = start == 0 ? 0 : (end == 0 ? now_ns() : end) - start;
+    return worker_thread_stats { static_cast<std::size_t>(m_handlers.load()),
+                                 std::chrono::nanoseconds(m_busy_ns.load()),
+                                 std::chrono::nanoseconds(m_spin_ns.load()),
+                                 static_cast<std::size_t>(m_blocks.load()),
+                                 std::chrono::nanoseconds(elapsed),
+                                 m_pinned.load() };
+  }
+};
+
+// equivalent to io_context::run, but polling for ready handlers so the time spent running 
+// them can be measured; when no handlers are ready, polling continues for the spin budget
+// before blocking, avoiding the wakeup latency of the blocking wait
+inline void run_io_context(asio::io_context& ioc, run_counters& cnt, 
+                           std::chrono::nanoseconds spin_budget) {
+  cnt.m_start_ns = run_counters::now_ns();
+  auto idle_start = cnt.m_start_ns.load();
+  for (;;) {
+    auto t0 = run_counters::now_ns();
+    auto n = ioc.poll();
+    auto t1 = run_counters::now_ns();
+    if (n > 0u) {
+      cnt.m_busy_ns += t1 - t0;
+      cnt.m_handlers += n;
+      idle_start = t1;
+      continue;
+    }
+    if (ioc.stopped()) {
+      break;
+    }
+    cnt.m_spin_ns += t1 - t0;
+    if (t1 - idle_start < spin_budget.count()) {
+      // lets other threads (e.g. the peer of a request / response exchange) run when 
+      // there are more spinning threads than cores
+      std::this_thread::yield();
+      continue;
+    }
+    ++cnt.m_blocks;
+    n = ioc.run_one(); // wait for work
+    if (n == 0u) {
+      break;
+    }
+    cnt.m_handlers += n;
+    idle_start = run_counters::now_ns();
+  }
+  cnt.m_end_ns = run_counters::now_ns();
+}
+
+} // end detail namespace
+
 /**
  *  @brief Convenience class that combines an executor work guard and a thread,
  *  invoking asynchronous operations as per the Asio documentation.
@@ -43,9 +180,10 @@ private:
   asio::io_context                                           m_ioc;
   asio::executor_work_guard<asio::io_context::executor_type> m_wg;
   std::thread                                                m_run_thr;
+  detail::run_counters                                       m_counters;
 
 public:
-  worker() : m_ioc(), m_wg(asio::make_work_guard(m_ioc)), m_run_thr() { }
+  worker() : m_ioc(), m_wg(asio::make_work_guard(m_ioc)), m_run_thr(), m_counters() { }
 
 /**
  *  @brief Provide access to the @c io_context.
@@ -73,6 +211,46 @@ public:
     );
   }
 
+/**
+ *  @brief Start the thread, using a low latency run loop that busy polls for ready handlers
+ *  instead of blocking in the operating system event wait.
+ *
+ *  Blocking in the event wait (e.g. @c epoll) costs several microseconds of wakeup latency
+ *  per event. The busy polling run loop keeps polling the @c io_context while idle, and
+ *  only blocks after @c spin_budget passes without any handlers being ready, so a burst of
+ *  events (such as a request / response exchange) is handled without wakeups, at the cost
+ *  of a CPU core while spinning. Work and spin time are available through 
+ *  @c get_thread_stats.
+ *
+ *  The latency benefit requires a core for each spinning thread. The loop yields between
+ *  polls, so that with more spinning threads than cores a spinning thread gives up its 
+ *  scheduler time slice instead of delaying the thread that has work.
+ *
+ *  @param spin_budget Idle time spent polling before blocking; a very large value spins 
+ *  continuously.
+ */
+  void start_busy_poll(std::chrono::microseconds spin_budget) {
+    m_run_thr = std::thread([this, spin_budget] () {
+        try {
+          detail::run_io_context(m_ioc, m_counters, spin_budget);
+        }
+        catch (const std::exception& e) {
+          std::cerr << "std::exception caught in worker::start_busy_poll: " << e.what() << std::endl;
+        }
+        catch (...) {
+          std::cerr << "Unknown exception caught in worker::start_busy_poll" << std::endl;
+        }
+      }
+    );
+  }
+
+/**
+ *  @brief Return the run loop counters, only collected if started with @c start_busy_poll.
+ */
+  worker_thread_stats get_thread_stats() const noexcept {
+    return m_counters.get_stats();
+  }
+
 /**
  *  @brief Shutdown the executor and join the thread, abandoning any outstanding operations or handlers.
  */
@@ -0,0 +1,283 @@
+/** @file
+ *
+ *  @ingroup net_ip_component_module
+ *
+ *  @brief Multi-threaded executor and work guard class, with optional CPU affinity and
+ *  thread naming.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef WORKER_POOL_HPP_INCLUDED
+#define WORKER_POOL_HPP_INCLUDED
+
+#include <thread>
+#include <vector>
+#include <memory> // std::unique_ptr
+#include <string>
+#include <chrono>
+#include <cstddef> // std::size_t
+#include <algorithm> // std::max, std::min
+#include <functional> // std::ref
+
+#include <exception>
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "asio/io_context.hpp"
+#include "asio/executor_work_guard.hpp"
+
+#include "net_ip/tcp_acceptor_options.hpp" // io_context_refs
+
+#include "net_ip_component/worker.hpp"
+
+namespace chops {
+namespace net {
+
+/**
+ *  @brief How the threads of a @c worker_pool are associated with @c asio::io_context
+ *  objects.
+ */
+enum class worker_pool_layout {
+  io_context_per_thread,  /**< Each thread runs its own @c asio::io_context. */
+  shared_io_context       /**< All threads run one @c asio::io_context. */
+};
+
+/**
+ *  @brief Settings for a @c worker_pool.
+ */
+struct worker_pool_options {
+
+/**
+ *  @brief Number of threads, minimum of 1.
+ */
+  std::size_t          num_threads = 1u;
+
+/**
+ *  @brief Association between threads and @c asio::io_context objects.
+ *
+ *  @note The network entities of the @c net_ip library do not use strands, so an
+ *  @c asio::io_context used by a network entity must only be run by one thread. Use the
+ *  @c io_context_per_thread layout to spread network entities across threads, the
+ *  @c shared_io_context layout is suitable for application work that is safe to run
+ *  concurrently.
+ */
+  worker_pool_layout   layout = worker_pool_layout::io_context_per_thread;
+
+/**
+ *  @brief If non-empty, thread @c i is pinned to CPU @c cpus[i % cpus.size()].
+ *
+ *  CPU affinity is only supported on Linux, elsewhere it is ignored; whether a thread was
+ *  pinned is available in @c worker_thread_stats.
+ */
+  std::vector<int>     cpus;
+
+/**
+ *  @brief If non-empty, each thread is named with this prefix followed by a dash and the
+ *  thread index, for debuggers and system tools (Linux only, truncated to 15 characters).
+ */
+  std::string          thread_name_prefix;
+
+/**
+ *  @brief Idle time each thread spends polling for ready handlers before blocking, 0 (the
+ *  default) to block as soon as no handlers are ready; see @c worker::start_busy_poll.
+ */
+  std::chrono::microseconds spin_budget = std::chrono::microseconds(0);
+};
+
+/**
+ *  @brief Convenience class that combines executor work guards and multiple threads, the
+ *  multi-threaded counterpart of @c worker.
+ *
+ *  The @c start, @c stop and @c reset methods have the same semantics as in @c worker,
+ *  applied to every thread. A @c net_ip object can be constructed with the
+ *  @c get_io_contexts container, in which case network entities are assigned to the
+ *  @c asio::io_context objects (and therefore threads) in turn:
+ *
+ *  @code
+ *    chops::net::worker_pool wp(chops::net::worker_pool_options { 4u });
+ *    wp.start();
+ *    chops::net::net_ip my_nip(wp.get_io_contexts());
+ *    // ...
+ *    wp.reset(); // or wp.stop();
+ *  @endcode
+ *
+ *  @note This class is not a necessary dependency of the @c net_ip library, but
+ *  is provided for convenience in many use cases.
+ */
+class worker_pool {
+private:
+  using work_guard = asio::executor_work_guard<asio::io_context::executor_type>;
+
+private:
+  worker_pool_options                            m_opts;
+  std::vector<std::unique_ptr<asio::io_context>> m_iocs;
+  std::vector<work_guard>                        m_wgs;
+  std::vector<detail::run_counters>              m_counters;
+  std::vector<std::thread>                       m_run_thrs;
+
+public:
+
+/**
+ *  @brief Construct the @c asio::io_context objects, without starting any threads.
+ *
+ *  @param opts Number of threads, layout, CPU affinity and thread naming.
+ */
+  explicit worker_pool(const worker_pool_options& opts = worker_pool_options()) :
+      m_opts(opts), m_iocs(), m_wgs(),
+      m_counters(std::max(opts.num_threads, std::size_t(1u))), m_run_thrs() {
+    m_opts.num_threads = m_counters.size();
+    bool shared = m_opts.layout == worker_pool_layout::shared_io_context;
+    std::size_t num_iocs = shared ? 1u : m_opts.num_threads;
+    for (std::size_t i = 0u; i < num_iocs; ++i) {
+      // a concurrency hint of 1 allows Asio to avoid locking when a single thread runs
+      // the io_context
+      m_iocs.push_back(shared ? std::make_unique<asio::io_context>() :
+                                std::make_unique<asio::io_context>(1));
+      m_wgs.push_back(asio::make_work_guard(*m_iocs.back()));
+    }
+  }
+
+private:
+  // no copy or assignment semantics for this class
+  worker_pool(const worker_pool&) = delete;
+  worker_pool(worker_pool&&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+  worker_pool& operator=(worker_pool&&) = delete;
+
+public:
+
+/**
+ *  @brief Provide access to the first (or only) @c io_context.
+ *
+ *  @return Reference to a @c asio::io_context.
+ */
+  asio::io_context& get_io_context() { return *m_iocs.front(); }
+
+/**
+ *  @brief Provide access to the @c io_context run by a thread.
+ *
+ *  @param thr_idx Thread index, less than @c size.
+ *
+ *  @return Reference to a @c asio::io_context.
+ */
+  asio::io_context& get_io_context(std::size_t thr_idx) { return *m_iocs[thr_idx % m_iocs.size()]; }
+
+/**
+ *  @brief Return references to all of the @c io_context objects, one per thread for the
+ *  @c io_context_per_thread layout, otherwise one.
+ *
+ *  The container can be passed to the @c net_ip constructor, or used in
+ *  @c tcp_acceptor_options.
+ */
+  io_context_refs get_io_contexts() {
+    io_context_refs refs;
+    for (auto& ioc : m_iocs) {
+      refs.push_back(std::ref(*ioc));
+    }
+    return refs;
+  }
+
+/**
+ *  @brief Return the number of threads.
+ */
+  std::size_t size() const noexcept { return m_counters.size(); }
+
+/**
+ *  @brief Start the threads that invoke the underlying asynchronous operations.
+ */
+  void start() {
+    for (std::size_t i = 0u; i < m_counters.size(); ++i) {
+      m_run_thrs.emplace_back([this, i] () {
+          try {
+            setup_thread(i);
+            detail::run_io_context(get_io_context(i), m_counters[i], m_opts.spin_budget);
+          }
+          catch (const std::exception& e) {
+            std::cerr << "std::exception caught in worker_pool::start: " << e.what() << std::endl;
+          }
+          catch (...) {
+            std::cerr << "Unknown exception caught in worker_pool::start" << std::endl;
+          }
+        }
+      );
+    }
+  }
+
+/**
+ *  @brief Shutdown the executors and join the threads, abandoning any outstanding operations
+ *  or handlers.
+ */
+  void stop() {
+    for (auto& ioc : m_iocs) {
+      ioc->stop();
+    }
+    join();
+  }
+
+/**
+ *  @brief Reset the internal work guards and join the threads, waiting for outstanding
+ *  operations or handlers to complete.
+ */
+  void reset() {
+    for (auto& wg : m_wgs) {
+      wg.reset();
+    }
+    join();
+  }
+
+/**
+ *  @brief Return utilization counters for each thread, in thread index order.
+ */
+  std::vector<worker_thread_stats> get_thread_stats() const {
+    std::vector<worker_thread_stats> ret;
+    for (const auto& c : m_counters) {
+      ret.push_back(c.get_stats());
+    }
+    return ret;
+  }
+
+private:
+
+  void join() {
+    for (auto& thr : m_run_thrs) {
+      if (thr.joinable()) {
+        thr.join();
+      }
+    }
+  }
+
+  void setup_thread(std::size_t idx) {
+#if defined(__linux__)
+    if (!m_opts.thread_name_prefix.empty()) {
+      auto name = m_opts.thread_name_prefix + "-" + std::to_string(idx);
+      name.resize(std::min(name.size(), std::size_t(15u)));
+      pthread_setname_np(pthread_self(), name.c_str());
+    }
+    if (!m_opts.cpus.empty()) {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(m_opts.cpus[idx % m_opts.cpus.size()], &cpu_set);
+      m_counters[idx].m_pinned =
+          pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+#endif
+  }
+
+};
+
+}  // end net namespace
+}  // end chops namespace
+
+#endif
+
@@ -15,8 +15,14 @@
 
 #include <memory> // std::shared_ptr
 #include <set>
+#include <vector>
 #include <cstddef> // std::size_t
 #include <span>
+#include <functional> // std::function
+#include <iostream>
+
+#include "asio/buffer.hpp"
+#include "asio/ip/udp.hpp"
 
 #include "net_ip/queue_stats.hpp"
 #include "net_ip/basic_io_interface.hpp"
@@ -71,6 +77,41 @@ void basic_io_output_test_sends() {
   io_out.send(chops::mutable_shared_buffer(), endp_t());
   REQUIRE(ioh->send_called);
 
+  std::vector<chops::const_shared_buffer> bufs { buf, buf };
+  REQUIRE (io_out.send_batch(bufs) == 2u);
+  REQUIRE (io_out.send_batch(bufs, endp_t()) == 2u);
+  REQUIRE (chops::net::basic_io_output<IOT>().send_batch(bufs) == 0u);
+
+}
+
+template <typename IOT>
+void basic_io_output_test_pinned() {
+
+  auto ioh = std::make_shared<IOT>();
+  chops::net::basic_io_output<IOT> io_out(ioh);
+  chops::net::basic_io_output<IOT> pinned_out(ioh.get());
+  REQUIRE (pinned_out.is_valid());
+  REQUIRE (pinned_out == io_out);
+  REQUIRE_FALSE (pinned_out < io_out);
+  REQUIRE_FALSE (io_out < pinned_out);
+
+  REQUIRE (pinned_out.get_output_queue_stats());
+  REQUIRE (pinned_out.send(chops::mutable_shared_buffer()));
+  REQUIRE (ioh->send_called);
+
+  // copies and moves of a pinned object are unpinned, tracking the IO handler lifetime
+  auto copy_out = pinned_out;
+  chops::net::basic_io_output<IOT> move_out(std::move(pinned_out));
+  chops::net::basic_io_output<IOT> assign_out { };
+  assign_out = copy_out;
+  REQUIRE (copy_out == io_out);
+  REQUIRE (move_out == io_out);
+  REQUIRE (assign_out == io_out);
+  ioh.reset();
+  REQUIRE_FALSE (copy_out.is_valid());
+  REQUIRE_FALSE (move_out.is_valid());
+  REQUIRE_FALSE (assign_out.is_valid());
+  REQUIRE_FALSE (copy_out.send(chops::mutable_shared_buffer()));
 }
 
 template <typename IOT>
@@ -134,5 +175,70 @@ TEST_CASE ( "Basic io output test, io_handler_mock used for IO handler type",
   basic_io_output_test_construction<chops::test::io_handler_mock>();
   basic_io_output_test_sends<chops::test::io_handler_mock>();
   basic_io_output_test_compare<chops::test::io_handler_mock>();
+  basic_io_output_test_pinned<chops::test::io_handler_mock>();
 }
 
+// records the strong reference count seen by each send; a pinned basic_io_output sends
+// through a raw pointer (count unchanged), an unpinned one promotes its std::weak_ptr
+// for the duration of the send (count incremented, then decremented)
+struct refcount_ioh : public std::enable_shared_from_this<refcount_ioh> {
+  using endpoint_type = asio::ip::udp::endpoint;
+
+  std::size_t sends = 0u;
+  std::size_t promotions = 0u;
+
+  bool send(chops::const_shared_buffer) {
+    ++sends;
+    promotions += static_cast<std::size_t>(weak_from_this().use_count() - 1);
+    return true;
+  }
+};
+
+using refcount_output = chops::net::basic_io_output<refcount_ioh>;
+using refcount_endp = refcount_ioh::endpoint_type;
+
+// invoke a message handler the way the IO handlers do, with a pinned basic_io_output
+// prvalue, returning the number of weak_ptr promotions per message
+template <typename MH>
+std::size_t promotions_per_msg(MH& msg_hdlr) {
+  constexpr std::size_t num_msgs = 100u;
+  auto ioh = std::make_shared<refcount_ioh>();
+  for (std::size_t i = 0u; i < num_msgs; ++i) {
+    msg_hdlr(asio::const_buffer(), refcount_output(ioh.get()), refcount_endp());
+  }
+  REQUIRE (ioh->sends == num_msgs);
+  return ioh->promotions / num_msgs;
+}
+
+TEST_CASE ( "Basic io output test, pinned output with lambda and std::function message handlers",
+            "[basic_io_output] [pinned]" ) {
+
+  chops::const_shared_buffer buf(chops::mutable_shared_buffer(8u));
+  auto by_val = [buf] (asio::const_buffer, refcount_output out, refcount_endp) {
+    return out.send(buf);
+  };
+  auto by_ref = [buf] (asio::const_buffer, const refcount_output& out, refcount_endp) {
+    return out.send(buf);
+  };
+  using func_type = std::function<bool (asio::const_buffer, refcount_output, refcount_endp)>;
+  func_type func_by_val(by_val);
+  func_type func_by_ref(by_ref);
+
+  auto lambda_cnt = promotions_per_msg(by_val);
+  auto func_cnt = promotions_per_msg(func_by_val);
+  auto func_ref_cnt = promotions_per_msg(func_by_ref);
+
+  // each promotion is two atomic reference count operations, and an unpinned copy adds
+  // two more (weak_from_this and the weak_ptr destructor)
+  std::cerr << "weak_ptr promotions per message, lambda: " << lambda_cnt <<
+               ", std::function: " << func_cnt <<
+               ", std::function with const reference parameter: " << func_ref_cnt << std::endl;
+  std::cerr << "atomic reference count operations per message, lambda: " << lambda_cnt * 4u <<
+               ", std::function: " << func_cnt * 4u <<
+               ", std::function with const reference parameter: " << func_ref_cnt * 4u <<
+               std::endl;
+
+  REQUIRE (lambda_cnt == 0u);
+  REQUIRE (func_cnt == 1u); // std::function move constructs the parameter, unpinning it
+  REQUIRE (func_ref_cnt == 0u);
+}
@@ -0,0 +1,210 @@
+/** @file
+ *
+ * @brief Test scenarios for @c handler_memory and related detail classes, including
+ * counting heap allocations per message for steady-state TCP and UDP reads and writes.
+ *
+ * @author Cliff Green
+ *
+ * @copyright (c) 2025 by Cliff Green
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/ip/tcp.hpp"
+#include "asio/ip/udp.hpp"
+#include "asio/io_context.hpp"
+
+#include <system_error> // std::error_code
+#include <cstddef> // std::size_t
+#include <cstdlib> // std::malloc, std::free
+#include <new> // std::bad_alloc
+#include <memory> // std::make_shared
+#include <utility> // std::move
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <iostream>
+
+#include "net_ip/detail/handler_memory.hpp"
+#include "net_ip/detail/tcp_io.hpp"
+#include "net_ip/detail/udp_entity_io.hpp"
+
+#include "net_ip/basic_io_output.hpp"
+#include "net_ip/io_type_decls.hpp"
+
+#include "net_ip_component/worker.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+// count every global heap allocation in this test executable
+std::atomic<std::size_t> alloc_cnt { 0u };
+
+void* operator new(std::size_t sz) {
+  alloc_cnt.fetch_add(1u, std::memory_order_relaxed);
+  if (void* p = std::malloc(sz == 0u ? 1u : sz)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+constexpr int warmup_msgs = 20;
+constexpr int measured_msgs = 500;
+constexpr std::size_t msg_size = 16u;
+
+const char* test_addr = "127.0.0.1";
+constexpr unsigned short tcp_test_port = 30451;
+constexpr unsigned short udp_test_port = 30452;
+
+// ping-pong message handler for either side of a connection; the initiating side records
+// the allocation count after a warmup period and again after the measured messages
+template <typename IOT>
+struct ping_pong_hdlr {
+  chops::const_shared_buffer             m_buf;
+  std::shared_ptr<std::promise<double>>  m_prom;
+  int                                    m_cnt = 0;
+  std::size_t                            m_start_allocs = 0u;
+
+  template <typename E>
+  bool operator()(asio::const_buffer, chops::net::basic_io_output<IOT> io_out, E) {
+    if (m_prom) {
+      ++m_cnt;
+      if (m_cnt == warmup_msgs) {
+        m_start_allocs = alloc_cnt.load();
+      }
+      else if (m_cnt == warmup_msgs + measured_msgs) {
+        m_prom->set_value(static_cast<double>(alloc_cnt.load() - m_start_allocs) / measured_msgs);
+        return true;
+      }
+    }
+    io_out.send(m_buf);
+    return true;
+  }
+};
+
+TEST_CASE ( "Handler memory and allocator",
+            "[handler_memory]" ) {
+
+  chops::net::detail::handler_memory mem;
+  chops::net::detail::handler_allocator<int> alloc(mem);
+
+  REQUIRE_FALSE (mem.in_use());
+  auto before = alloc_cnt.load();
+  int* p1 = alloc.allocate(4u);
+  REQUIRE (mem.in_use());
+  int* p2 = alloc.allocate(4u); // block in use, from the heap
+  REQUIRE (p1 != p2);
+  alloc.deallocate(p2, 4u);
+  REQUIRE (alloc_cnt.load() == before + 1u);
+  alloc.deallocate(p1, 4u);
+  REQUIRE_FALSE (mem.in_use());
+
+  REQUIRE (alloc.allocate(4u) == p1); // block is reused
+  alloc.deallocate(p1, 4u);
+
+  // too big for the block
+  char* big = chops::net::detail::handler_allocator<char>(alloc).allocate(
+                                  chops::net::detail::handler_memory_size + 1u);
+  REQUIRE_FALSE (mem.in_use());
+  chops::net::detail::handler_allocator<char>(alloc).deallocate(big, 0u);
+
+  chops::net::detail::handler_memory mem2;
+  REQUIRE (alloc == chops::net::detail::handler_allocator<double>(alloc));
+  REQUIRE (alloc != chops::net::detail::handler_allocator<int>(mem2));
+
+  int val = 0;
+  auto h = chops::net::detail::make_alloc_handler(mem, [&val] (int i) { val = i; } );
+  h(42);
+  REQUIRE (val == 42);
+  REQUIRE (h.get_allocator() == alloc);
+}
+
+TEST_CASE ( "Tcp IO handler, allocations per message in steady state",
+            "[handler_memory] [tcp_io]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  asio::ip::tcp::endpoint endp(asio::ip::make_address(test_addr), tcp_test_port);
+  asio::ip::tcp::acceptor acc(ioc, endp);
+  asio::ip::tcp::socket conn_sock(ioc);
+  conn_sock.connect(endp);
+  auto acc_sock = acc.accept();
+
+  auto notify = [] (std::error_code, chops::net::detail::tcp_io_shared_ptr) { };
+  auto conn_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(conn_sock), notify);
+  auto acc_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(acc_sock), notify);
+
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+  auto prom = std::make_shared<std::promise<double>>();
+  auto fut = prom->get_future();
+
+  REQUIRE (acc_iop->start_io(msg_size,
+                             ping_pong_hdlr<chops::net::detail::tcp_io> { buf, { } }));
+  REQUIRE (conn_iop->start_io(msg_size,
+                              ping_pong_hdlr<chops::net::detail::tcp_io> { buf, prom }));
+  REQUIRE (conn_iop->send(buf));
+
+  auto allocs_per_msg = fut.get();
+  std::cout << "TCP steady-state allocations per message: " << allocs_per_msg << std::endl;
+  REQUIRE (allocs_per_msg == 0.0);
+
+  conn_iop->stop_io();
+  acc_iop->stop_io();
+  wk.reset();
+}
+
+TEST_CASE ( "Udp IO handler, allocations per message in steady state",
+            "[handler_memory] [udp_entity_io]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  asio::ip::udp::endpoint endp1(asio::ip::make_address(test_addr), udp_test_port);
+  asio::ip::udp::endpoint endp2(asio::ip::make_address(test_addr), udp_test_port+1);
+
+  auto iop1 = std::make_shared<chops::net::detail::udp_entity_io>(ioc, endp1);
+  auto iop2 = std::make_shared<chops::net::detail::udp_entity_io>(ioc, endp2);
+
+  auto start_entity = [] (chops::net::detail::udp_entity_io_shared_ptr iop) {
+    std::promise<void> started;
+    auto started_fut = started.get_future();
+    iop->start([&started] (chops::net::udp_io_interface, std::size_t, bool starting) {
+                   if (starting) {
+                     started.set_value();
+                   }
+                 },
+               [] (chops::net::udp_io_interface, std::error_code) { } );
+    started_fut.get();
+  };
+  start_entity(iop1);
+  start_entity(iop2);
+
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+  auto prom = std::make_shared<std::promise<double>>();
+  auto fut = prom->get_future();
+
+  REQUIRE (iop2->start_io(endp1, msg_size,
+                          ping_pong_hdlr<chops::net::detail::udp_entity_io> { buf, { } }));
+  REQUIRE (iop1->start_io(endp2, msg_size,
+                          ping_pong_hdlr<chops::net::detail::udp_entity_io> { buf, prom }));
+  REQUIRE (iop1->send(buf));
+
+  auto allocs_per_msg = fut.get();
+  std::cout << "UDP steady-state allocations per message: " << allocs_per_msg << std::endl;
+  REQUIRE (allocs_per_msg == 0.0);
+
+  iop1->stop();
+  iop2->stop();
+  wk.reset();
+}
+
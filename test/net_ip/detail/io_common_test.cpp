@@ -96,6 +96,95 @@ void io_common_api_test(const E& elem) {
   check_queue_stats(iocommon, 0u, 0u);
   REQUIRE_FALSE (iocommon.is_write_in_progress());
 
+  // batch writes, first element written directly, rest queued, only one write started
+  auto ident = [] (const E& e) { return e; };
+  int write_cnt = 0;
+  auto count_write = [&write_cnt] (const E&) { ++write_cnt; };
+  std::vector<E> batch { elem, elem, elem };
+  REQUIRE (iocommon.start_write_batch(std::vector<E> { }, ident, count_write) == 0u);
+  REQUIRE_FALSE (iocommon.is_write_in_progress());
+  REQUIRE (iocommon.start_write_batch(batch, ident, count_write) == 3u);
+  REQUIRE (write_cnt == 1);
+  REQUIRE (iocommon.is_write_in_progress());
+  check_queue_stats(iocommon, 2u, 2u*elem.size());
+  REQUIRE (iocommon.start_write_batch(batch, ident, count_write) == 3u);
+  REQUIRE (write_cnt == 1);
+  check_queue_stats(iocommon, 5u, 5u*elem.size());
+  REQUIRE (iocommon.set_io_stopped());
+  REQUIRE (iocommon.start_write_batch(batch, ident, count_write) == 0u);
+  check_queue_stats(iocommon, 0u, 0u);
+  REQUIRE (write_cnt == 1);
+
+  // queue age and write duration are zero until time stamps are enabled
+  constexpr std::chrono::milliseconds age_wait { 5 };
+  REQUIRE (iocommon.set_io_started());
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  std::this_thread::sleep_for(age_wait);
+  auto qs = iocommon.get_output_queue_stats();
+  REQUIRE (qs.output_queue_size == 1u);
+  REQUIRE (qs.oldest_queued_age.count() == 0);
+  REQUIRE (qs.write_in_progress_duration.count() == 0);
+  iocommon.clear();
+
+  // queue age and write duration, then clear only the queued elements
+  iocommon.enable_timestamps();
+  REQUIRE (iocommon.get_output_queue_stats().write_in_progress_duration.count() == 0);
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  std::this_thread::sleep_for(age_wait);
+  qs = iocommon.get_output_queue_stats();
+  REQUIRE (qs.oldest_queued_age >= age_wait);
+  REQUIRE (qs.write_in_progress_duration >= qs.oldest_queued_age);
+  REQUIRE (iocommon.clear_queue() == 2u);
+  check_queue_stats(iocommon, 0u, 0u);
+  REQUIRE (iocommon.get_output_queue_stats().oldest_queued_age.count() == 0);
+  REQUIRE (iocommon.is_write_in_progress());
+  iocommon.write_next_elem(empty_write_func<E>);
+  REQUIRE_FALSE (iocommon.is_write_in_progress());
+
+  // drain notifications, delivered immediately if drained, else when a write completes
+  int drained_all = 0;
+  int drained_thresh = 0;
+  iocommon.notify_when_drained(0u, [&drained_all] { ++drained_all; });
+  REQUIRE (drained_all == 1);
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.notify_when_drained(0u, [&drained_all] { ++drained_all; });
+  iocommon.notify_when_drained(elem.size(), [&drained_thresh] { ++drained_thresh; });
+  REQUIRE (drained_all == 1);
+  REQUIRE (drained_thresh == 0);
+  iocommon.write_next_elem(empty_write_func<E>);
+  REQUIRE (drained_thresh == 1);
+  REQUIRE (drained_all == 1);
+  iocommon.write_next_elem(empty_write_func<E>);
+  REQUIRE (drained_all == 1); // last write still in progress
+  iocommon.write_next_elem(empty_write_func<E>);
+  REQUIRE (drained_all == 2);
+  REQUIRE (drained_thresh == 1);
+  // pending notifications are delivered when the queue is cleared at shutdown
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.notify_when_drained(0u, [&drained_all] { ++drained_all; });
+  REQUIRE (drained_all == 2);
+  REQUIRE (iocommon.set_io_stopped());
+  iocommon.clear();
+  REQUIRE (drained_all == 3);
+  iocommon.notify_when_drained(0u, [&drained_all] { ++drained_all; });
+  REQUIRE (drained_all == 4);
+
+  // time stamps are off again after a reset, as for a re-used IO handler
+  iocommon.reset_timestamps();
+  REQUIRE (iocommon.set_io_started());
+  iocommon.start_write(elem, empty_write_func<E>);
+  iocommon.start_write(elem, empty_write_func<E>);
+  std::this_thread::sleep_for(age_wait);
+  qs = iocommon.get_output_queue_stats();
+  REQUIRE (qs.oldest_queued_age.count() == 0);
+  REQUIRE (qs.write_in_progress_duration.count() == 0);
+  iocommon.clear();
+
 }
 
 constexpr int Wait = 5;
@@ -18,6 +18,9 @@
 #include <utility> // std::move
 #include <functional> // std::ref
 #include <cstddef> // std::size_t
+#include <future>
+
+#include "asio/post.hpp"
 
 #include "net_ip/detail/net_entity_common.hpp"
 #include "net_ip/basic_io_interface.hpp"
@@ -119,6 +122,33 @@ void net_entity_common_test() {
   INFO (r.message());
   REQUIRE_FALSE (ne.is_started());
 
+  // non-blocking start and stop
+  detail::net_entity_common<IOT> ne2 { };
+  std::promise<std::error_code> prom1;
+  auto fut1 = prom1.get_future();
+  r = ne2.start(std::ref(io_state_chg), std::ref(err_cb), ioc.get_executor(), start_stop,
+                [&prom1] (std::error_code err) { prom1.set_value(err); } );
+  REQUIRE_FALSE (r);
+  REQUIRE_FALSE (fut1.get());
+  REQUIRE (ne2.is_started());
+  r = ne2.start(std::ref(io_state_chg), std::ref(err_cb), ioc.get_executor(), start_stop,
+                [] (std::error_code) { } );
+  REQUIRE (r);
+
+  // blocking stop called from within the executor runs directly instead of deadlocking
+  std::promise<std::error_code> prom2;
+  auto fut2 = prom2.get_future();
+  bool in_exec = false;
+  asio::post(ioc, [&ne2, &ioc, &prom2, &in_exec] () {
+      in_exec = detail::running_in_executor(ioc.get_executor());
+      prom2.set_value(ne2.stop(ioc.get_executor(), start_stop));
+    }
+  );
+  REQUIRE_FALSE (fut2.get());
+  REQUIRE (in_exec);
+  REQUIRE (ne2.is_stopped());
+  REQUIRE_FALSE (detail::running_in_executor(ioc.get_executor()));
+
   wk.reset();
 
 }
@@ -61,11 +61,20 @@ void output_queue_test(const std::vector<E>& data_vec, int multiplier) {
   auto t = add_to_q(data_vec, outq, 1);
   qs = outq.get_queue_stats();
   REQUIRE_FALSE (qs.output_queue_size == 0u);
+  REQUIRE (qs.oldest_queued_age.count() == 0); // not time stamped by default
 
-  outq.clear();
+  REQUIRE (outq.clear() == t);
+  outq.set_timestamps(true);
+  t = add_to_q(data_vec, outq, 1);
+  qs = outq.get_queue_stats();
+  REQUIRE_FALSE (qs.output_queue_size == 0u);
+  REQUIRE (qs.oldest_queued_age.count() >= 0);
+
+  REQUIRE (outq.clear() == t);
   qs = outq.get_queue_stats();
   REQUIRE (qs.output_queue_size == 0u);
   REQUIRE (qs.bytes_in_output_queue == 0u);
+  REQUIRE (qs.oldest_queued_age.count() == 0);
 }
 
 TEST_CASE ( "Output_queue test, single element, multiplier 1", 
@@ -0,0 +1,148 @@
+/** @file
+ *
+ * @brief Test scenarios for @c slot_map detail class.
+ *
+ * The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
+ * @author Cliff Green
+ *
+ * @copyright (c) 2025 by Cliff Green
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <vector>
+#include <memory> // std::shared_ptr, std::make_shared
+#include <algorithm> // std::shuffle, std::erase_if
+#include <random>
+#include <string> // std::to_string
+#include <cstddef> // std::size_t
+#include <ranges> // std::views::iota
+
+#include "net_ip/detail/slot_map.hpp"
+
+using int_map = chops::net::detail::slot_map<int>;
+
+TEST_CASE ( "Slot map insert, find, erase", "[slot_map]" ) {
+
+  int_map sm;
+  REQUIRE (sm.empty());
+  REQUIRE_FALSE (sm.find(int_map::invalid_key));
+
+  auto k1 = sm.insert(11);
+  auto k2 = sm.insert(22);
+  auto k3 = sm.insert(33);
+  REQUIRE (sm.size() == 3u);
+  REQUIRE (*sm.find(k1) == 11);
+  REQUIRE (*sm.find(k2) == 22);
+  REQUIRE (*sm.find(k3) == 33);
+
+  REQUIRE (sm.erase(k1));
+  REQUIRE_FALSE (sm.erase(k1));
+  REQUIRE_FALSE (sm.find(k1));
+  REQUIRE (sm.size() == 2u);
+  // remaining keys are stable after elements are moved
+  REQUIRE (*sm.find(k2) == 22);
+  REQUIRE (*sm.find(k3) == 33);
+
+  auto k4 = sm.insert(44); // re-uses the slot from k1
+  REQUIRE (k4 != k1);
+  REQUIRE_FALSE (sm.find(k1));
+  REQUIRE (*sm.find(k4) == 44);
+
+  int sum = 0;
+  for (auto i : sm) {
+    sum += i;
+  }
+  REQUIRE (sum == 22 + 33 + 44);
+
+  sm.clear();
+  REQUIRE (sm.empty());
+  REQUIRE_FALSE (sm.find(k2));
+  REQUIRE_FALSE (sm.find(k3));
+  REQUIRE_FALSE (sm.find(k4));
+  auto k5 = sm.insert(55);
+  REQUIRE (*sm.find(k5) == 55);
+  REQUIRE (sm.size() == 1u);
+}
+
+TEST_CASE ( "Slot map random churn", "[slot_map] [churn]" ) {
+
+  int_map sm;
+  std::vector<int_map::key_type> keys;
+  std::mt19937 gen(42);
+
+  for (int i : std::views::iota(0, 1000)) {
+    keys.push_back(sm.insert(i));
+  }
+  for (int i : std::views::iota(0, 5000)) {
+    std::uniform_int_distribution<std::size_t> dist(0u, keys.size() - 1u);
+    auto idx = dist(gen);
+    REQUIRE (sm.erase(keys[idx]));
+    keys[idx] = keys.back();
+    keys.pop_back();
+    keys.push_back(sm.insert(i));
+    keys.push_back(sm.insert(i));
+    REQUIRE (sm.size() == keys.size());
+    if (keys.size() > 2000u) {
+      for (auto k : keys) {
+        REQUIRE (sm.erase(k));
+      }
+      keys.clear();
+      REQUIRE (sm.empty());
+      keys.push_back(sm.insert(i));
+    }
+  }
+  for (auto k : keys) {
+    REQUIRE (sm.find(k));
+  }
+}
+
+// simulates the TCP acceptor connection registry: a burst of connects followed
+// by a disconnect storm in random order
+template <typename C, typename Ins, typename Del>
+void churn(std::size_t num_conns, C& cont, Ins ins, Del del) {
+  using key_type = decltype(ins(cont, std::shared_ptr<int>()));
+  std::vector<key_type> keys;
+  keys.reserve(num_conns);
+  for (std::size_t i = 0u; i < num_conns; ++i) {
+    keys.push_back(ins(cont, std::make_shared<int>(static_cast<int>(i))));
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (auto& k : keys) {
+    del(cont, k);
+  }
+}
+
+TEST_CASE ( "Slot map connect / disconnect churn benchmark", "[.] [benchmark] [slot_map]" ) {
+
+  using sp_map = chops::net::detail::slot_map<std::shared_ptr<int>>;
+  auto ins = [] (sp_map& sm, std::shared_ptr<int> p) { return sm.insert(p); };
+  auto del = [] (sp_map& sm, sp_map::key_type k) { sm.erase(k); };
+
+  for (std::size_t n : { 10'000u, 100'000u, 500'000u }) {
+    BENCHMARK ( "slot_map churn, " + std::to_string(n) + " connections" ) {
+      sp_map sm;
+      churn(n, sm, ins, del);
+      return sm.size();
+    };
+  }
+
+  // the previous registry, for comparison, quadratic so only the smallest size
+  using sp_vec = std::vector<std::shared_ptr<int>>;
+  auto vins = [] (sp_vec& v, std::shared_ptr<int> p) { v.push_back(p); return p; };
+  auto vdel = [] (sp_vec& v, std::shared_ptr<int> p) {
+    std::erase_if(v, [p] (const auto& sp) { return sp == p; } );
+  };
+  BENCHMARK ( "vector erase_if churn, 10000 connections" ) {
+    sp_vec v;
+    churn(10'000u, v, vins, vdel);
+    return v.size();
+  };
+}
+
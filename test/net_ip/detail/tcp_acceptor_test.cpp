@@ -30,10 +30,12 @@
 #include <utility> // std::move
 #include <thread>
 #include <future>
+#include <atomic>
 #include <chrono>
 #include <functional> // std::ref, std::cref
 #include <string_view>
 #include <vector>
+#include <algorithm> // std::min
 #include <ranges> // std::views::iota
 
 #include <cassert>
@@ -45,6 +47,7 @@
 
 #include "net_ip/io_type_decls.hpp"
 #include "net_ip/endpoints_resolver.hpp"
+#include "net_ip/tcp_acceptor_options.hpp"
 
 #include "shared_test/msg_handling.hpp"
 #include "shared_test/msg_handling_start_funcs.hpp"
@@ -313,6 +316,93 @@ void acceptor_test (const vec_buf& var_msg_vec, const vec_buf& fixed_msg_vec,
 
 }
 
+// the acceptor entity bookkeeping is on the first worker, connections are handled by 
+// the io_contexts in the options
+void acceptor_options_test (const vec_buf& var_msg_vec, int num_conns,
+                            const chops::net::tcp_acceptor_options& opts) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::err_wait_q err_wq;
+  auto err_fut = std::async(std::launch::async,
+        chops::net::ostream_error_sink_with_wait_queue,
+        std::ref(err_wq), std::ref(std::cerr));
+
+  {
+    INFO ("Variable length message tests with acceptor options starting");
+
+    auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                  std::string_view(test_port), std::string_view(), true, opts);
+    test_counter recv_cnt = 0;
+    acc_ptr->start( [&recv_cnt] (chops::net::tcp_io_interface io, std::size_t num, bool starting ) {
+        if (starting) {
+          auto r = tcp_start_io(io, true, std::string_view(), recv_cnt);
+          assert (r);
+        }
+      },
+      chops::net::make_error_func_with_wait_queue<chops::net::tcp_io>(err_wq)
+    );
+    REQUIRE(acc_ptr->is_started());
+
+    auto conn_cnt = start_var_data_funcs(var_msg_vec, ioc, true, 0, num_conns,
+                                         std::string_view(), make_empty_variable_len_msg());
+    acc_ptr->stop();
+    REQUIRE_FALSE(acc_ptr->is_started());
+
+    std::size_t total_msgs = num_conns * var_msg_vec.size();
+    REQUIRE (total_msgs == recv_cnt);
+    REQUIRE (total_msgs == conn_cnt);
+
+    auto ps = acc_ptr->get_io_handler_pool_stats();
+    if (opts.io_handler_pool_size > 0u) {
+      REQUIRE ((ps.pool_hits + ps.pool_misses) == static_cast<std::size_t>(num_conns));
+      // preallocated objects are always available for the first connections
+      REQUIRE (ps.pool_hits >= std::min(opts.io_handler_pool_size, static_cast<std::size_t>(num_conns)));
+    }
+    else {
+      REQUIRE ((ps.pool_hits + ps.pool_misses) == 0u);
+    }
+  }
+
+  {
+    INFO ("Connection count tests with acceptor options starting");
+
+    auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                  std::string_view(test_port), std::string_view(), true, opts);
+    std::promise<std::size_t> prom;
+    auto start_fut = prom.get_future();
+    acc_ptr->start( [num_conns, &prom] (chops::net::tcp_io_interface io, std::size_t num, bool starting ) {
+        if (starting) {
+          auto r = io.start_io(); // send only, so the connection is visible to visit_io_output
+          assert (r);
+          if (num == static_cast<std::size_t>(num_conns)) {
+            prom.set_value(num);
+          }
+        }
+      },
+      chops::net::make_error_func_with_wait_queue<chops::net::tcp_io>(err_wq)
+    );
+    auto conn_fut = std::async(std::launch::async, start_read_only_funcs, std::ref(ioc), num_conns);
+    // the count is the total across all io_contexts
+    REQUIRE (start_fut.get() == static_cast<std::size_t>(num_conns));
+    REQUIRE (acc_ptr->visit_io_output([] (chops::net::tcp_io_output) { }) == 
+             static_cast<std::size_t>(num_conns));
+    acc_ptr->stop();
+    conn_fut.get();
+    REQUIRE_FALSE(acc_ptr->is_started());
+  }
+
+  while (!err_wq.empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  err_wq.request_stop();
+  err_fut.get();
+
+  wk.reset();
+}
+
 TEST_CASE ( "Tcp acceptor test, var len msgs, one-way, interval 50, 1 connector", 
            "[tcp_acc] [var_len_msg] [one_way] [interval_50] [connectors_1]" ) {
 
@@ -452,3 +542,231 @@ TEST_CASE ( "Tcp acceptor test,  LF msgs, two-way, interval 0, 25 connectors, ma
                   std::string_view("\n"), make_empty_lf_text_msg() );
 
 }
+
+#if defined(SO_REUSEPORT)
+TEST_CASE ( "Tcp acceptor test, SO_REUSEPORT listeners, var len msgs, two-way, 20 connectors", 
+           "[tcp_acc] [reuse_port] [var_len_msg] [two_way] [connectors_20]" ) {
+
+  chops::net::worker wk1;
+  chops::net::worker wk2;
+  chops::net::worker wk3;
+  wk1.start();
+  wk2.start();
+  wk3.start();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.reuse_port_io_contexts = { std::ref(wk1.get_io_context()), std::ref(wk2.get_io_context()),
+                                  std::ref(wk3.get_io_context()) };
+  acceptor_options_test ( make_msg_vec (make_variable_len_msg, "Sharded!", 'S', 10*num_msgs),
+                          20, opts );
+
+  wk1.reset();
+  wk2.reset();
+  wk3.reset();
+
+}
+#endif
+
+TEST_CASE ( "Tcp acceptor test, io_context pool, round robin, var len msgs, two-way, 20 connectors", 
+           "[tcp_acc] [io_context_pool] [round_robin] [var_len_msg] [two_way] [connectors_20]" ) {
+
+  chops::net::worker wk1;
+  chops::net::worker wk2;
+  wk1.start();
+  wk2.start();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.connection_io_contexts = { std::ref(wk1.get_io_context()), std::ref(wk2.get_io_context()) };
+  opts.dispatch = chops::net::connection_dispatch::round_robin;
+  acceptor_options_test ( make_msg_vec (make_variable_len_msg, "Round and round!", 'R', 10*num_msgs),
+                          20, opts );
+
+  wk1.reset();
+  wk2.reset();
+
+}
+
+TEST_CASE ( "Tcp acceptor test, io_context pool, least connections, var len msgs, two-way, 20 connectors", 
+           "[tcp_acc] [io_context_pool] [least_connections] [var_len_msg] [two_way] [connectors_20]" ) {
+
+  chops::net::worker wk1;
+  chops::net::worker wk2;
+  chops::net::worker wk3;
+  wk1.start();
+  wk2.start();
+  wk3.start();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.connection_io_contexts = { std::ref(wk1.get_io_context()), std::ref(wk2.get_io_context()),
+                                  std::ref(wk3.get_io_context()) };
+  opts.dispatch = chops::net::connection_dispatch::least_connections;
+  acceptor_options_test ( make_msg_vec (make_variable_len_msg, "Least loaded!", 'L', 10*num_msgs),
+                          20, opts );
+
+  wk1.reset();
+  wk2.reset();
+  wk3.reset();
+
+}
+
+TEST_CASE ( "Tcp acceptor test, io handler pool, var len msgs, two-way, 20 connectors", 
+           "[tcp_acc] [io_handler_pool] [var_len_msg] [two_way] [connectors_20]" ) {
+
+  chops::net::tcp_acceptor_options opts;
+  opts.io_handler_pool_size = 8u;
+  acceptor_options_test ( make_msg_vec (make_variable_len_msg, "Recycled!", 'P', 10*num_msgs),
+                          20, opts );
+
+  opts.io_handler_pool_size = 40u;
+  acceptor_options_test ( make_msg_vec (make_variable_len_msg, "Recycled, more!", 'M', 10*num_msgs),
+                          20, opts );
+}
+
+struct admission_counts {
+  std::atomic_size_t deferred = 0u;
+  std::atomic_size_t rejected = 0u;
+};
+
+auto make_admission_err_func(admission_counts& cnts) {
+  return [&cnts] (chops::net::tcp_io_interface, std::error_code err) {
+    if (err == std::make_error_code(chops::net::net_ip_errc::tcp_acceptor_accept_deferred)) {
+      ++cnts.deferred;
+    }
+    else if (err == std::make_error_code(chops::net::net_ip_errc::tcp_acceptor_connection_rejected)) {
+      ++cnts.rejected;
+    }
+  };
+}
+
+TEST_CASE ( "Tcp acceptor test, admission control, max connections, accept and close", 
+           "[tcp_acc] [admission] [max_connections] [accept_and_close]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.max_connections = 3u;
+  opts.excess_policy = chops::net::excess_connection_policy::accept_and_close;
+
+  auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                std::string_view(test_port), std::string_view(), true, opts);
+  admission_counts cnts;
+  std::promise<std::size_t> prom;
+  auto start_fut = prom.get_future();
+  acc_ptr->start( [&prom] (chops::net::tcp_io_interface io, std::size_t num, bool starting ) {
+      if (starting && num == 3u) {
+        prom.set_value(num);
+      }
+    },
+    make_admission_err_func(cnts)
+  );
+  auto conn_fut = std::async(std::launch::async, start_read_only_funcs, std::ref(ioc), 3);
+  REQUIRE (start_fut.get() == 3u);
+
+  // connections beyond the limit are closed by the acceptor
+  for (int i : std::views::iota(0, 2)) {
+    asio::ip::tcp::socket sock(ioc);
+    perform_connect(sock, ioc);
+    REQUIRE (read_until_err(sock));
+  }
+  REQUIRE (cnts.rejected == 2u);
+  REQUIRE (cnts.deferred == 0u);
+
+  acc_ptr->stop();
+  conn_fut.get();
+  wk.reset();
+}
+
+TEST_CASE ( "Tcp acceptor test, admission control, max connections, pause accepting", 
+           "[tcp_acc] [admission] [max_connections] [pause_accepting]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.max_connections = 2u;
+  opts.excess_policy = chops::net::excess_connection_policy::pause_accepting;
+
+  auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                std::string_view(test_port), std::string_view(), true, opts);
+  admission_counts cnts;
+  std::vector<chops::net::tcp_io_interface> ios; // only accessed in io state change callback
+  std::promise<void> first_prom;
+  auto first_fut = first_prom.get_future();
+  std::promise<void> resumed_prom;
+  auto resumed_fut = resumed_prom.get_future();
+  std::size_t total_starts = 0u;
+  std::size_t max_num = 0u;
+  acc_ptr->start( [&] (chops::net::tcp_io_interface io, std::size_t num, bool starting ) {
+      if (!starting) {
+        return;
+      }
+      max_num = std::max(max_num, num);
+      ios.push_back(io);
+      ++total_starts;
+      if (total_starts == 2u) {
+        first_prom.set_value();
+      }
+      if (total_starts == 3u) {
+        resumed_prom.set_value();
+      }
+    },
+    make_admission_err_func(cnts)
+  );
+  auto conn_fut = std::async(std::launch::async, start_read_only_funcs, std::ref(ioc), 3);
+  first_fut.get();
+  // third connection is left in the listen backlog
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  REQUIRE (cnts.deferred >= 1u);
+  REQUIRE (resumed_fut.wait_for(std::chrono::milliseconds(0)) == std::future_status::timeout);
+
+  // closing one connection resumes accepting
+  asio::post(ioc, [&ios] () { ios.front().stop_io(); } );
+  resumed_fut.get();
+  REQUIRE (cnts.rejected == 0u);
+
+  acc_ptr->stop();
+  conn_fut.get();
+  REQUIRE (max_num == 2u);
+  wk.reset();
+}
+
+TEST_CASE ( "Tcp acceptor test, admission control, accept rate", 
+           "[tcp_acc] [admission] [accept_rate]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::tcp_acceptor_options opts;
+  opts.accept_rate = 20.0; // one connection every 50 ms
+  opts.accept_burst = 1.0;
+
+  auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                std::string_view(test_port), std::string_view(), true, opts);
+  admission_counts cnts;
+  std::promise<void> prom;
+  auto start_fut = prom.get_future();
+  std::size_t total_starts = 0u;
+  acc_ptr->start( [&] (chops::net::tcp_io_interface io, std::size_t num, bool starting ) {
+      if (starting && ++total_starts == 6u) {
+        prom.set_value();
+      }
+    },
+    make_admission_err_func(cnts)
+  );
+  auto start_time = std::chrono::steady_clock::now();
+  auto conn_fut = std::async(std::launch::async, start_read_only_funcs, std::ref(ioc), 6);
+  start_fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start_time;
+  // first connection uses the initial token, the other five wait for a token each
+  REQUIRE (elapsed >= std::chrono::milliseconds(200));
+  REQUIRE (cnts.deferred >= 1u);
+  REQUIRE (cnts.rejected == 0u);
+
+  acc_ptr->stop();
+  conn_fut.get();
+  wk.reset();
+}
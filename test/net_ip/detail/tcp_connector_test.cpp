@@ -7,6 +7,8 @@
  *  This test is similar to the tcp_acceptor_test code, except the Chops Net IP 
  *  tcp_connector class instead of Asio blocking io calls.
  *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
  *  @author Cliff Green
  *
  *  Copyright (c) 2018-2025 by Cliff Green
@@ -17,6 +19,7 @@
  */
 
 #include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
 
 #include "asio/ip/tcp.hpp"
 #include "asio/buffer.hpp"
@@ -31,6 +34,7 @@
 #include <chrono>
 #include <functional> // std::ref, std::cref
 #include <string_view>
+#include <string> // std::stoi
 #include <vector>
 #include <deque>
 #include <ranges> // std::views::iota
@@ -39,6 +43,7 @@
 
 #include "net_ip/detail/tcp_acceptor.hpp"
 #include "net_ip/detail/tcp_connector.hpp"
+#include "net_ip/resolver_cache.hpp"
 
 #include "net_ip/basic_io_output.hpp"
 #include "net_ip/io_type_decls.hpp"
@@ -60,6 +65,8 @@ using namespace chops::test;
 
 const char* test_port_var = "30777";
 const char* test_port_fixed = "30778";
+const char* test_port_fast = "30779";
+constexpr unsigned short test_port_blackhole = 30780;
 const char* test_host = "localhost";
 constexpr int num_msgs = 50;
 constexpr std::chrono::milliseconds tout { 800 };
@@ -485,3 +492,339 @@ TEST_CASE ( "Tcp connector test, LF msgs, two-way, interval 0, 15 connectors, ma
 
 }
 
+
+// echo fixed size messages back to the connector
+auto start_echo_acceptor(asio::io_context& ioc, const chops::net::tcp_acceptor_options& opts,
+                         chops::net::err_wait_q& err_wq) {
+  auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                    std::string_view(test_port_fast), std::string_view(), true, opts);
+  auto r = acc_ptr->start( [] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+        if (starting) {
+          auto r = io.start_io(fixed_size_buf_size, 
+              [] (asio::const_buffer buf, chops::net::tcp_io_output io_out, asio::ip::tcp::endpoint) {
+                io_out.send(buf.data(), buf.size());
+                return true;
+              }
+          );
+          assert(r);
+        }
+      },
+    chops::net::make_error_func_with_wait_queue<chops::net::tcp_io>(err_wq)
+  );
+  assert (!r);
+  return acc_ptr;
+}
+
+// connect, send a request as soon as the connection is up, and wait for the reply,
+// which is the typical short-lived request connection
+std::chrono::steady_clock::duration request_round_trip(asio::io_context& ioc, 
+                                       const chops::net::tcp_connector_options& opts,
+                                       chops::net::err_wait_q& err_wq) {
+  auto conn_ptr = std::make_shared<chops::net::detail::tcp_connector>(ioc,
+                     std::string_view(test_port_fast), std::string_view(test_host),
+                     chops::net::simple_timeout(tout), false, opts);
+  auto prom_ptr = std::make_shared<test_prom>();
+  auto fut = prom_ptr->get_future();
+  test_counter cnt = 0;
+  auto start = std::chrono::steady_clock::now();
+  auto r = conn_ptr->start( [prom_ptr, &cnt] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+        if (starting) {
+          auto r = io.start_io(fixed_size_buf_size, tcp_fixed_size_msg_hdlr(std::move(*prom_ptr), 1u, cnt));
+          assert(r);
+          // with fast open this is carried in the SYN
+          auto sent = io.make_io_output()->send(make_fixed_size_buf());
+          assert(sent);
+        }
+      },
+    chops::net::make_error_func_with_wait_queue<chops::net::tcp_io>(err_wq)
+  );
+  assert (!r);
+  fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  conn_ptr->stop();
+  return elapsed;
+}
+
+#if defined(TCP_FASTOPEN_CONNECT) && defined(TCP_FASTOPEN) && defined(TCP_DEFER_ACCEPT)
+
+chops::net::tcp_acceptor_options make_fast_acceptor_options() {
+  chops::net::tcp_acceptor_options opts;
+  opts.fast_open_queue_len = 64;
+  opts.defer_accept = std::chrono::seconds(5);
+  return opts;
+}
+
+TEST_CASE ( "Tcp connector test, fast open and deferred accept", 
+           "[tcp_conn] [fast_open]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::err_wait_q err_wq;
+  auto err_fut = std::async(std::launch::async, 
+          chops::net::ostream_error_sink_with_wait_queue, 
+          std::ref(err_wq), std::ref(std::cerr));
+  {
+    auto acc_ptr = start_echo_acceptor(ioc, make_fast_acceptor_options(), err_wq);
+    REQUIRE (acc_ptr->is_started());
+
+    chops::net::tcp_connector_options opts;
+    opts.fast_open = true;
+    // the first connect obtains the fast open cookie, later connects use it
+    for (int i : std::views::iota(0, 5)) {
+      auto t = request_round_trip(ioc, opts, err_wq);
+      REQUIRE (t > std::chrono::steady_clock::duration::zero());
+    }
+    // a connector without fast open still works with a fast open acceptor
+    auto t = request_round_trip(ioc, chops::net::tcp_connector_options(), err_wq);
+    REQUIRE (t > std::chrono::steady_clock::duration::zero());
+
+    acc_ptr->stop();
+    REQUIRE_FALSE (acc_ptr->is_started());
+  }
+
+  while (!err_wq.empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  err_wq.request_stop();
+  err_fut.get();
+  wk.reset();
+}
+
+// gains require fast open enabled for both client and server on the host (on Linux,
+// net.ipv4.tcp_fastopen set to 3), otherwise only deferred accept is in effect
+TEST_CASE ( "Tcp connector connect to first reply latency benchmark", 
+           "[.] [benchmark] [tcp_conn] [fast_open]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::err_wait_q err_wq;
+  auto err_fut = std::async(std::launch::async, 
+          chops::net::ostream_error_sink_with_wait_queue, 
+          std::ref(err_wq), std::ref(std::cerr));
+  {
+    auto acc_ptr = start_echo_acceptor(ioc, chops::net::tcp_acceptor_options(), err_wq);
+    BENCHMARK ( "Connect and first reply, default options" ) {
+      return request_round_trip(ioc, chops::net::tcp_connector_options(), err_wq);
+    };
+    acc_ptr->stop();
+  }
+  {
+    auto acc_ptr = start_echo_acceptor(ioc, make_fast_acceptor_options(), err_wq);
+    chops::net::tcp_connector_options opts;
+    opts.fast_open = true;
+    BENCHMARK ( "Connect and first reply, fast open and deferred accept" ) {
+      return request_round_trip(ioc, opts, err_wq);
+    };
+    acc_ptr->stop();
+  }
+
+  while (!err_wq.empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  err_wq.request_stop();
+  err_fut.get();
+  wk.reset();
+}
+
+#endif
+
+// a listening socket with a full accept queue silently drops connect requests, which
+// behaves like an unresponsive (blackholed) address
+struct blackhole_listener {
+  asio::io_context                     ioc;
+  asio::ip::tcp::acceptor              acc;
+  asio::ip::tcp::socket                filler;
+
+  // with a backlog of 0 the accept queue is full after one connection
+  explicit blackhole_listener(const asio::ip::tcp::endpoint& endp) : ioc(), acc(ioc), filler(ioc) {
+    acc.open(endp.protocol());
+    acc.set_option(asio::socket_base::reuse_address(true));
+    acc.bind(endp);
+    acc.listen(0);
+    filler.connect(endp);
+  }
+};
+
+TEST_CASE ( "Tcp connector test, happy eyeballs with a blackholed endpoint", 
+           "[tcp_conn] [happy_eyeballs]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  chops::net::err_wait_q err_wq;
+  auto err_fut = std::async(std::launch::async, 
+          chops::net::ostream_error_sink_with_wait_queue, 
+          std::ref(err_wq), std::ref(std::cerr));
+  {
+    auto loopback = asio::ip::make_address("127.0.0.1");
+    blackhole_listener bh(asio::ip::tcp::endpoint(loopback, test_port_blackhole));
+    auto acc_ptr = start_echo_acceptor(ioc, chops::net::tcp_acceptor_options(), err_wq);
+
+    std::vector<asio::ip::tcp::endpoint> endps {
+        asio::ip::tcp::endpoint(loopback, test_port_blackhole),
+        asio::ip::tcp::endpoint(loopback, 
+                                static_cast<unsigned short>(std::stoi(test_port_fast))) };
+
+    chops::net::tcp_connector_options opts;
+    opts.happy_eyeballs = true;
+    opts.attempt_delay = 100ms;
+
+    for (int i : std::views::iota(0, 3)) {
+      auto conn_ptr = std::make_shared<chops::net::detail::tcp_connector>(ioc,
+                         endps.cbegin(), endps.cend(), chops::net::simple_timeout(tout), false, opts);
+      chops::net::tcp_io_wait_q io_wq;
+      auto start = std::chrono::steady_clock::now();
+      auto r = conn_ptr->start( [&io_wq] (chops::net::tcp_io_interface io, std::size_t num, bool starting) {
+            if (starting) {
+              io_wq.emplace_push(*(io.make_io_output()), num, starting);
+            }
+          },
+        chops::net::make_error_func_with_wait_queue<chops::net::tcp_io>(err_wq)
+      );
+      REQUIRE_FALSE (r);
+      auto d = *(io_wq.wait_and_pop());
+      auto elapsed = std::chrono::steady_clock::now() - start;
+      REQUIRE (d.starting);
+      REQUIRE (d.num_handlers == 1u);
+      // connected through the second endpoint after the attempt delay, while the 
+      // first attempt is still outstanding (a SYN retry is at least 1 second)
+      REQUIRE (elapsed >= opts.attempt_delay);
+      REQUIRE (elapsed < 900ms);
+      conn_ptr->stop();
+    }
+
+    acc_ptr->stop();
+  }
+
+  while (!err_wq.empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  err_wq.request_stop();
+  err_fut.get();
+  wk.reset();
+}
+
+TEST_CASE ( "Tcp connector test, connect deadline with a blackholed endpoint", 
+           "[tcp_conn] [connect_deadline]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  auto loopback = asio::ip::make_address("127.0.0.1");
+  asio::ip::tcp::endpoint endp(loopback, test_port_blackhole);
+  blackhole_listener bh(endp);
+
+  chops::net::tcp_connector_options opts;
+  opts.connect_deadline = 150ms;
+
+  std::atomic_size_t last_attempt = 0u;
+  auto tout_func = [&last_attempt] (std::size_t attempts) {
+    last_attempt = attempts;
+    return attempts < 3u ? chops::net::optional_millis(50ms) : chops::net::optional_millis();
+  };
+
+  std::atomic_size_t deadline_cnt = 0u;
+  std::promise<void> closed_prom;
+  auto closed_fut = closed_prom.get_future();
+  auto conn_ptr = std::make_shared<chops::net::detail::tcp_connector>(ioc,
+                     &endp, &endp + 1, chops::net::tcp_connector_timeout_func(tout_func), false, opts);
+  auto start = std::chrono::steady_clock::now();
+  auto r = conn_ptr->start( no_start_io_state_chg,
+        [&deadline_cnt, &closed_prom] (chops::net::tcp_io_interface, std::error_code err) {
+          if (err == std::make_error_code(chops::net::net_ip_errc::tcp_connector_connect_deadline)) {
+            ++deadline_cnt;
+          }
+          else if (err == std::make_error_code(chops::net::net_ip_errc::tcp_connector_closed)) {
+            closed_prom.set_value();
+          }
+        }
+  );
+  REQUIRE_FALSE (r);
+  closed_fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // each attempt is bounded by the deadline and counted by the timeout function,
+  // rather than waiting on SYN retries (the first retry alone is 1 second)
+  REQUIRE (deadline_cnt == 3u);
+  REQUIRE (last_attempt == 3u);
+  REQUIRE (elapsed >= 3 * opts.connect_deadline + 2 * 50ms);
+  REQUIRE (elapsed < 1s);
+  REQUIRE_FALSE (conn_ptr->is_started());
+
+  wk.reset();
+}
+
+TEST_CASE ( "Tcp connector test, shared endpoint cache and re-resolve on reconnect", 
+           "[tcp_conn] [resolver_cache]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  auto cache = std::make_shared<chops::net::resolver_cache>();
+
+  // a listen interface name, so the acceptor start completes after an async lookup
+  chops::net::tcp_acceptor_options acc_opts;
+  acc_opts.endpoints_cache = cache;
+  auto acc_ptr = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                     std::string_view(test_port_fast), std::string_view(test_host), true, acc_opts);
+  auto r = acc_ptr->start(no_start_io_state_chg, 
+                          [] (chops::net::tcp_io_interface, std::error_code) { } );
+  REQUIRE_FALSE (r);
+
+  chops::net::tcp_connector_options opts;
+  opts.re_resolve_on_reconnect = true;
+  opts.endpoints_cache = cache;
+
+  constexpr std::size_t num_conns = 4u;
+  std::atomic_size_t resolve_cnt = 0u;
+  std::atomic_size_t conn_cnt = 0u;
+  std::promise<void> conns_prom;
+  auto conns_fut = conns_prom.get_future();
+
+  auto conn_ptr = std::make_shared<chops::net::detail::tcp_connector>(ioc,
+                     std::string_view(test_port_fast), std::string_view(test_host),
+                     chops::net::simple_timeout(50ms), true, opts);
+  r = conn_ptr->start( [&ioc] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+        if (starting) { // drop each connection, the connector then reconnects
+          asio::post(ioc, [io] () mutable { io.stop_io(); } );
+        }
+      },
+      [&] (chops::net::tcp_io_interface, std::error_code err) {
+        if (err == std::make_error_code(chops::net::net_ip_errc::tcp_connector_resolving_addresses)) {
+          ++resolve_cnt;
+        }
+        else if (err == std::make_error_code(chops::net::net_ip_errc::tcp_connector_connected)) {
+          if (++conn_cnt == num_conns) {
+            conns_prom.set_value();
+          }
+        }
+      }
+  );
+  REQUIRE_FALSE (r);
+  conns_fut.get();
+  conn_ptr->stop();
+  acc_ptr->stop();
+
+  // one lookup each for the acceptor and the connector, the reconnect lookups are 
+  // satisfied from the cache
+  auto st = cache->get_stats();
+  REQUIRE (resolve_cnt >= num_conns);
+  REQUIRE (st.misses == 2u);
+  REQUIRE (st.hits >= num_conns - 1u);
+  REQUIRE (st.entries == 2u);
+
+  wk.reset();
+}
@@ -2,6 +2,8 @@
  *
  * @brief Test scenarios for @c tcp_io detail class.
  *
+ * The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
  * @author Cliff Green
  *
  * @copyright (c) 2017-2025 by Cliff Green
@@ -26,6 +28,9 @@
 #include <chrono>
 #include <functional> // std::ref, std::cref
 #include <string_view>
+#include <array>
+#include <vector>
+#include <atomic>
 
 #include <cassert>
 
@@ -334,3 +339,143 @@ TEST_CASE ( "Tcp IO handler test, LF msgs, two-way, interval 0, many msgs",
 
 }
 
+
+// large stateful message handler, counting every copy or move of the handler object
+std::atomic<std::size_t> hdlr_copies { 0u };
+
+struct large_state_hdlr {
+  std::array<char, 4096>                 m_state {};
+  chops::const_shared_buffer             m_buf;
+  std::shared_ptr<std::promise<void>>    m_prom;
+  int                                    m_max;
+  int                                    m_cnt = 0;
+
+  large_state_hdlr(const chops::const_shared_buffer& buf, 
+                   std::shared_ptr<std::promise<void>> prom, int max) :
+    m_buf(buf), m_prom(std::move(prom)), m_max(max) { }
+
+  large_state_hdlr(const large_state_hdlr& rhs) : 
+    m_state(rhs.m_state), m_buf(rhs.m_buf), m_prom(rhs.m_prom), m_max(rhs.m_max), 
+    m_cnt(rhs.m_cnt) { ++hdlr_copies; }
+
+  large_state_hdlr(large_state_hdlr&& rhs) : 
+    m_state(rhs.m_state), m_buf(std::move(rhs.m_buf)), m_prom(std::move(rhs.m_prom)), 
+    m_max(rhs.m_max), m_cnt(rhs.m_cnt) { ++hdlr_copies; }
+
+  bool operator()(asio::const_buffer buf, chops::net::basic_io_output<chops::net::detail::tcp_io> io_out,
+                  asio::ip::tcp::endpoint) {
+    m_state[static_cast<std::size_t>(m_cnt) % m_state.size()] += static_cast<char>(buf.size());
+    ++m_cnt;
+    if (m_prom && m_cnt == m_max) {
+      m_prom->set_value();
+      return true;
+    }
+    io_out.send(m_buf);
+    return true;
+  }
+};
+
+// ping-pong num_msgs round trips between two tcp_io objects with large stateful message 
+// handlers, returns the number of handler copies or moves after IO was started
+std::size_t large_hdlr_ping_pong (int num_round_trips) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  asio::ip::tcp::endpoint endp(asio::ip::make_address("127.0.0.1"), 30436);
+  asio::ip::tcp::acceptor acc(ioc, endp);
+  asio::ip::tcp::socket conn_sock(ioc);
+  conn_sock.connect(endp);
+  auto acc_sock = acc.accept();
+
+  auto notify = [] (std::error_code, chops::net::detail::tcp_io_shared_ptr) { };
+  auto conn_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(conn_sock), notify);
+  auto acc_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(acc_sock), notify);
+
+  constexpr std::size_t msg_size = 32u;
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+  auto prom = std::make_shared<std::promise<void>>();
+  auto fut = prom->get_future();
+
+  REQUIRE (acc_iop->start_io(msg_size, large_state_hdlr(buf, { }, 0)));
+  REQUIRE (conn_iop->start_io(msg_size, large_state_hdlr(buf, prom, num_round_trips)));
+  auto start_copies = hdlr_copies.load();
+
+  auto start = std::chrono::steady_clock::now();
+  REQUIRE (conn_iop->send(buf));
+  fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto copies = hdlr_copies.load() - start_copies;
+
+  std::cerr << "TCP IO handler, large stateful message handler, round trips: " << num_round_trips <<
+               ", usecs per round trip: " << 
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / 
+                   (1000.0 * num_round_trips) << 
+               ", handler copies or moves: " << copies << std::endl;
+
+  conn_iop->stop_io();
+  acc_iop->stop_io();
+  wk.reset();
+  return copies;
+}
+
+TEST_CASE ( "Tcp IO handler test, message handler is not copied or moved per message",
+            "[tcp_io] [large_state_hdlr]" ) {
+
+  REQUIRE (large_hdlr_ping_pong(num_msgs) == 0u);
+
+}
+
+TEST_CASE ( "Tcp IO handler, large stateful message handler ping-pong benchmark",
+            "[.] [benchmark] [tcp_io] [large_state_hdlr]" ) {
+
+  REQUIRE (large_hdlr_ping_pong(100000) == 0u);
+
+}
+
+TEST_CASE ( "Tcp IO handler test, send batch",
+            "[tcp_io] [send_batch]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto& ioc = wk.get_io_context();
+
+  asio::ip::tcp::endpoint endp(asio::ip::make_address("127.0.0.1"), 30437);
+  asio::ip::tcp::acceptor acc(ioc, endp);
+  asio::ip::tcp::socket conn_sock(ioc);
+  conn_sock.connect(endp);
+  auto acc_sock = acc.accept();
+
+  auto notify = [] (std::error_code, chops::net::detail::tcp_io_shared_ptr) { };
+  auto conn_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(conn_sock), notify);
+  auto acc_iop = std::make_shared<chops::net::detail::tcp_io>(std::move(acc_sock), notify);
+
+  constexpr std::size_t msg_size = 8u;
+  constexpr int batch_size = 20;
+  std::vector<chops::const_shared_buffer> bufs;
+  for (int i = 0; i < batch_size; ++i) {
+    bufs.push_back(chops::const_shared_buffer { chops::mutable_shared_buffer(msg_size) });
+  }
+
+  std::promise<int> prom;
+  auto fut = prom.get_future();
+  REQUIRE (acc_iop->start_io(msg_size, 
+        [cnt = 0, &prom] (asio::const_buffer, 
+                          chops::net::basic_io_output<chops::net::detail::tcp_io>,
+                          asio::ip::tcp::endpoint) mutable {
+          if (++cnt == batch_size) {
+            prom.set_value(cnt);
+          }
+          return true;
+        }
+  ));
+  REQUIRE (conn_iop->send_batch(bufs) == 0u); // IO not started
+  REQUIRE (conn_iop->start_io());
+  REQUIRE (conn_iop->send_batch(bufs) == bufs.size());
+  REQUIRE (fut.get() == batch_size);
+
+  conn_iop->stop_io();
+  acc_iop->stop_io();
+  wk.reset();
+}
@@ -21,8 +21,10 @@
 #include <utility> // std::pair
 #include <future>
 #include <string_view>
+#include <memory> // std::make_shared
 
 #include "net_ip/endpoints_resolver.hpp"
+#include "net_ip/resolver_cache.hpp"
 #include "net_ip_component/worker.hpp"
 
 template <typename Protocol>
@@ -119,6 +121,57 @@ TEST_CASE ( "Make endpoints local test, UDP 3",
 
 }
 
+TEST_CASE ( "Make endpoints with cache and non-blocking lookups",
+            "[make_endpoints] [resolver_cache]" ) {
+
+  using results_t = asio::ip::basic_resolver_results<asio::ip::tcp>;
+  using prom_ret = std::pair<std::error_code, results_t>;
+
+  chops::net::worker wk;
+  wk.start();
+
+  auto cache = std::make_shared<chops::net::resolver_cache>();
+  chops::net::endpoints_resolver<asio::ip::tcp> resolver(wk.get_io_context(), cache);
+
+  // numeric hosts and ports do not need a name lookup, and are not cached
+  REQUIRE (resolver.try_make_endpoints(true, "", "23000"));
+  REQUIRE (resolver.try_make_endpoints(false, "127.0.0.1", "23000"));
+  REQUIRE (cache->get_stats().entries == 0u);
+
+  REQUIRE_FALSE (resolver.try_make_endpoints(false, "localhost", "23000"));
+
+  auto async_lookup = [&resolver] () {
+    std::promise<prom_ret> res_prom;
+    auto fut = res_prom.get_future();
+    resolver.make_endpoints(false, "localhost", "23000",
+      [p = std::move(res_prom)] (const std::error_code& err, results_t res) mutable {
+        p.set_value(prom_ret(err, res));
+      }
+    );
+    return fut.get();
+  };
+
+  auto a = async_lookup();
+  REQUIRE_FALSE (a.first);
+  REQUIRE_FALSE (a.second.empty());
+  REQUIRE (cache->get_stats().entries == 1u);
+
+  auto b = async_lookup(); // satisfied from the cache
+  REQUIRE_FALSE (b.first);
+  REQUIRE (b.second.size() == a.second.size());
+  REQUIRE (b.second.cbegin()->endpoint() == a.second.cbegin()->endpoint());
+
+  REQUIRE (resolver.try_make_endpoints(false, "localhost", "23000"));
+  REQUIRE (resolver.make_endpoints(false, "localhost", "23000"));
+
+  auto st = cache->get_stats();
+  REQUIRE (st.hits == 3u);
+  REQUIRE (st.misses == 1u);
+
+  wk.reset();
+
+}
+
 /*
 TEST_CASE ( "Make endpoints remote test, TCP invalid", 
             "[tcp_make_endpoints_invalid]" ) {
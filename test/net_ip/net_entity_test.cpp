@@ -17,6 +17,7 @@
 #include <functional> // std::ref
 #include <system_error> // std::error_code
 #include <set>
+#include <vector>
 #include <chrono>
 #include <thread>
 #include <future>
@@ -122,6 +123,43 @@ void test_methods (chops::net::net_entity net_ent, chops::net::err_wait_q& err_w
   REQUIRE (net_ent.stop());
 }
 
+// the non-blocking forms, including a blocking visit_io_output called from within an
+// io_context thread (which previously deadlocked)
+template <typename IOT>
+void test_async_methods (chops::net::net_entity net_ent, chops::net::err_wait_q& err_wq) {
+
+  REQUIRE (net_ent.is_valid());
+  REQUIRE_FALSE (net_ent.stop([] (std::error_code) { assert(false); } ));
+
+  std::promise<std::error_code> start_prom;
+  auto start_fut = start_prom.get_future();
+  REQUIRE (net_ent.start(no_start_io_state_chg<IOT>(), 
+                         chops::net::make_error_func_with_wait_queue<IOT>(err_wq),
+                         [&start_prom] (std::error_code err) { start_prom.set_value(err); } ));
+  REQUIRE_FALSE (start_fut.get());
+  REQUIRE (*(net_ent.is_started()));
+  REQUIRE_FALSE (net_ent.start(no_start_io_state_chg<IOT>(), 
+                               chops::net::make_error_func_with_wait_queue<IOT>(err_wq),
+                               [] (std::error_code) { assert(false); } ));
+
+  std::promise<std::size_t> visit_prom;
+  auto visit_fut = visit_prom.get_future();
+  REQUIRE (net_ent.visit_io_output(io_output_visitor<IOT>(), 
+        [net_ent, &visit_prom] (std::size_t num) {
+          // blocking form, in an io_context thread
+          auto r = net_ent.visit_io_output(io_output_visitor<IOT>());
+          visit_prom.set_value(r ? (*r + num) : 42u);
+        }
+  ));
+  REQUIRE (visit_fut.get() == 0u);
+
+  std::promise<std::error_code> stop_prom;
+  auto stop_fut = stop_prom.get_future();
+  REQUIRE (net_ent.stop([&stop_prom] (std::error_code err) { stop_prom.set_value(err); } ));
+  REQUIRE_FALSE (stop_fut.get());
+  REQUIRE_FALSE (*(net_ent.is_started()));
+}
+
 void test_tcp_msg_send (const vec_buf& in_msg_vec,
                         chops::net::net_entity net_acc, chops::net::net_entity net_conn,
                         chops::net::err_wait_q& err_wq) {
@@ -330,6 +368,25 @@ TEST_CASE ( "Net entity method and comparison testing, UDP entity, TCP acceptor,
     test_methods<chops::net::udp_io, asio::ip::udp::socket>(ne_udp_recv, err_wq);
   }
 
+  {
+    auto sp = std::make_shared<chops::net::detail::tcp_connector>(ioc,
+                                                     std::string_view(test_port_tcp1),
+                                                     std::string_view(test_host_tcp),
+                                                     chops::net::simple_timeout(tout), false);
+    test_async_methods<chops::net::tcp_io>(chops::net::net_entity(sp), err_wq);
+  }
+
+  {
+    auto sp = std::make_shared<chops::net::detail::tcp_acceptor>(ioc, 
+                                                     test_port_tcp1, test_host_tcp, true );
+    test_async_methods<chops::net::tcp_io>(chops::net::net_entity(sp), err_wq);
+  }
+
+  {
+    auto sp = std::make_shared<chops::net::detail::udp_entity_io>(ioc, test_port_udp, test_host_udp );
+    test_async_methods<chops::net::udp_io>(chops::net::net_entity(sp), err_wq);
+  }
+
   {
     auto msg_vec = make_msg_vec (make_variable_len_msg, "Having fun?", 'F', num_msgs);
     auto sp_conn = std::make_shared<chops::net::detail::tcp_connector>(ioc,
@@ -365,3 +422,75 @@ TEST_CASE ( "Net entity method and comparison testing, UDP entity, TCP acceptor,
 
 }
 
+
+// start num_ents UDP senders, either one blocking start at a time or with start_all,
+// returning the elapsed time
+std::chrono::microseconds start_udp_entities (asio::io_context& ioc, std::size_t num_ents, 
+                                              bool bulk) {
+
+  std::vector<chops::net::net_entity> ents;
+  std::vector<chops::net::detail::udp_entity_io_shared_ptr> sps;
+  for (std::size_t i = 0u; i < num_ents; ++i) {
+    sps.push_back(std::make_shared<chops::net::detail::udp_entity_io>(ioc, asio::ip::udp::endpoint()));
+    ents.push_back(chops::net::net_entity(sps.back()));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::size_t num_started = 0u;
+  if (bulk) {
+    std::promise<std::size_t> prom;
+    auto fut = prom.get_future();
+    chops::net::start_all(ents.begin(), ents.end(), 
+                          no_start_io_state_chg<chops::net::udp_io>(), 
+                          chops::net::udp_empty_error_func,
+                          [&prom] (std::size_t n) { prom.set_value(n); } );
+    num_started = fut.get();
+  }
+  else {
+    for (auto& ent : ents) {
+      if (ent.start(no_start_io_state_chg<chops::net::udp_io>(), chops::net::udp_empty_error_func)) {
+        ++num_started;
+      }
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - start);
+  REQUIRE (num_started == num_ents);
+
+  for (auto& ent : ents) {
+    ent.stop();
+  }
+  return elapsed;
+}
+
+TEST_CASE ( "Net entity start_all, UDP entities", "[net_entity] [start_all]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  start_udp_entities(wk.get_io_context(), 20u, true);
+
+  // nothing to start, completion handler invoked directly
+  std::vector<chops::net::net_entity> ents { chops::net::net_entity() };
+  std::size_t cnt = 42u;
+  REQUIRE (chops::net::start_all(ents.begin(), ents.end(), 
+                                 no_start_io_state_chg<chops::net::udp_io>(), 
+                                 chops::net::udp_empty_error_func,
+                                 [&cnt] (std::size_t n) { cnt = n; } ) == 0u);
+  REQUIRE (cnt == 0u);
+  wk.reset();
+}
+
+// each UDP entity opens a socket, the open file limit (ulimit -n) must allow 10k sockets
+TEST_CASE ( "Net entity startup time benchmark, 10k UDP entities, blocking start vs start_all", 
+            "[.] [benchmark] [net_entity] [start_all]" ) {
+
+  constexpr std::size_t num_ents = 10000u;
+
+  chops::net::worker wk;
+  wk.start();
+  auto blocking = start_udp_entities(wk.get_io_context(), num_ents, false);
+  auto bulk = start_udp_entities(wk.get_io_context(), num_ents, true);
+  std::cerr << "Start " << num_ents << " UDP entities, blocking start usecs: " << 
+               blocking.count() << ", start_all usecs: " << bulk.count() << std::endl;
+  wk.reset();
+}
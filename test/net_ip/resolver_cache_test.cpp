@@ -0,0 +1,90 @@
+/** @file
+ *
+ * @brief Test scenarios for @c resolver_cache class.
+ *
+ * @author Cliff Green
+ *
+ * @copyright (c) 2025 by Cliff Green
+ *
+ * Distributed under the Boost Software License, Version 1.0. 
+ * (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/ip/tcp.hpp"
+#include "asio/ip/udp.hpp"
+#include "asio/ip/address.hpp"
+
+#include <vector>
+#include <chrono>
+
+#include "net_ip/resolver_cache.hpp"
+
+template <typename Protocol>
+asio::ip::basic_resolver_results<Protocol> make_results() {
+  using endp_t = typename Protocol::endpoint;
+  std::vector<endp_t> vec { endp_t(asio::ip::make_address("127.0.0.1"), 23400),
+                            endp_t(asio::ip::make_address("::1"), 23400) };
+  return asio::ip::basic_resolver_results<Protocol>::create(vec.cbegin(), vec.cend(), 
+                                                            "testhost", "23400");
+}
+
+TEST_CASE ( "Resolver cache hits, misses and keys", "[resolver_cache]" ) {
+
+  chops::net::resolver_cache cache;
+
+  REQUIRE_FALSE (cache.find<asio::ip::tcp>(false, "testhost", "23400"));
+  cache.insert<asio::ip::tcp>(false, "testhost", "23400", make_results<asio::ip::tcp>());
+
+  auto res = cache.find<asio::ip::tcp>(false, "testhost", "23400");
+  REQUIRE (res);
+  REQUIRE (res->size() == 2u);
+  REQUIRE (res->cbegin()->endpoint() == 
+           asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 23400));
+  REQUIRE (res->cbegin()->host_name() == "testhost");
+
+  // protocol, local flag, host and port are all part of the key
+  REQUIRE_FALSE (cache.find<asio::ip::udp>(false, "testhost", "23400"));
+  REQUIRE_FALSE (cache.find<asio::ip::tcp>(true, "testhost", "23400"));
+  REQUIRE_FALSE (cache.find<asio::ip::tcp>(false, "otherhost", "23400"));
+  REQUIRE_FALSE (cache.find<asio::ip::tcp>(false, "testhost", "23401"));
+
+  auto st = cache.get_stats();
+  REQUIRE (st.hits == 1u);
+  REQUIRE (st.misses == 5u); // every lookup not satisfied from the cache
+  REQUIRE (st.entries == 1u);
+
+  cache.clear();
+  REQUIRE_FALSE (cache.find<asio::ip::tcp>(false, "testhost", "23400"));
+  st = cache.get_stats();
+  REQUIRE (st.hits == 1u);
+  REQUIRE (st.misses == 6u);
+  REQUIRE (st.entries == 0u);
+}
+
+TEST_CASE ( "Resolver cache entry expiry", "[resolver_cache]" ) {
+
+  using namespace std::literals::chrono_literals;
+
+  chops::net::resolver_cache cache(0s);
+
+  cache.insert<asio::ip::udp>(true, "", "23400", make_results<asio::ip::udp>());
+  REQUIRE (cache.get_stats().entries == 1u);
+  REQUIRE_FALSE (cache.find<asio::ip::udp>(true, "", "23400"));
+
+  // the expired entry is removed by the lookup
+  auto st = cache.get_stats();
+  REQUIRE (st.hits == 0u);
+  REQUIRE (st.misses == 1u);
+  REQUIRE (st.entries == 0u);
+
+  // a new insert replaces the expired entry
+  chops::net::resolver_cache cache2(60s);
+  cache2.insert<asio::ip::udp>(true, "", "23400", make_results<asio::ip::udp>());
+  cache2.insert<asio::ip::udp>(true, "", "23400", make_results<asio::ip::udp>());
+  REQUIRE (cache2.find<asio::ip::udp>(true, "", "23400"));
+  REQUIRE (cache2.get_stats().entries == 1u);
+}
+
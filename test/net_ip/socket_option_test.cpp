@@ -0,0 +1,54 @@
+/** @file
+ *
+ * @brief Test scenarios for @c int_socket_option class template.
+ *
+ * @author Cliff Green
+ *
+ * @copyright (c) 2025 by Cliff Green
+ *
+ * Distributed under the Boost Software License, Version 1.0. 
+ * (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/io_context.hpp"
+#include "asio/ip/udp.hpp"
+#include "asio/socket_base.hpp"
+
+#include <system_error>
+
+#include "net_ip/socket_option.hpp"
+
+// SO_REUSEADDR is available on all platforms, so it is used to check set and get
+using reuse_addr_option = chops::net::int_socket_option<SOL_SOCKET, SO_REUSEADDR>;
+
+TEST_CASE ( "Int socket option set and get", "[socket_option]" ) {
+
+  reuse_addr_option opt { };
+  REQUIRE (opt.value() == 0);
+  REQUIRE (opt.level(asio::ip::udp::v4()) == SOL_SOCKET);
+  REQUIRE (opt.name(asio::ip::udp::v4()) == SO_REUSEADDR);
+  REQUIRE (opt.size(asio::ip::udp::v4()) == sizeof(int));
+  REQUIRE_THROWS (opt.resize(asio::ip::udp::v4(), 1u));
+
+  asio::io_context ioc;
+  asio::ip::udp::socket sock(ioc, asio::ip::udp::v4());
+  std::error_code ec;
+  sock.set_option(reuse_addr_option(1), ec);
+  REQUIRE_FALSE (ec);
+
+  asio::socket_base::reuse_address asio_opt;
+  sock.get_option(asio_opt, ec);
+  REQUIRE_FALSE (ec);
+  REQUIRE (asio_opt.value());
+
+  sock.set_option(asio::socket_base::reuse_address(false), ec);
+  REQUIRE_FALSE (ec);
+  reuse_addr_option get_opt(1);
+  sock.get_option(get_opt, ec);
+  REQUIRE_FALSE (ec);
+  REQUIRE (get_opt.value() == 0);
+}
+
@@ -2,6 +2,8 @@
  *
  * @brief Unit tests for classes and functions in tcp_connector_timeout.hpp.
  *
+ * The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
  * @author Nathan Deutsch
  *
  * @copyright (c) 2019-2025 by Cliff Green, Nathan Deutsch
@@ -12,6 +14,15 @@
  */
 
 #include "catch2/catch_test_macros.hpp"
+#include "catch2/benchmark/catch_benchmark.hpp"
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstddef> // std::size_t
+#include <algorithm> // std::max_element
+#include <iostream>
+
 #include "net_ip/tcp_connector_timeout.hpp"
 
 using namespace std::chrono_literals;
@@ -139,3 +150,116 @@ TEST_CASE("tcp connector timeout", "[tcp_connector_timeout]") {
     REQUIRE(timeout_with_backoff(3) == std::optional<std::chrono::milliseconds> {1000001});
 */
 }
+
+TEST_CASE("tcp connector jitter timeouts", "[tcp_connector_timeout] [jitter]") {
+
+  constexpr std::size_t num_attempts = 12u;
+
+  {
+    chops::net::full_jitter_timeout to { 100ms, 5000ms };
+    for (std::size_t i = 1u; i <= num_attempts; ++i) {
+      auto ret = to(i);
+      REQUIRE (ret);
+      REQUIRE (*ret >= 0ms);
+      REQUIRE (*ret <= std::min(100ms * (1 << (i-1u)), 5000ms));
+    }
+  }
+
+  {
+    chops::net::equal_jitter_timeout to { 100ms, 5000ms };
+    for (std::size_t i = 1u; i <= num_attempts; ++i) {
+      auto ret = to(i);
+      auto ceil = std::min(100ms * (1 << (i-1u)), 5000ms);
+      REQUIRE (ret);
+      REQUIRE (*ret >= ceil / 2);
+      REQUIRE (*ret <= ceil);
+    }
+  }
+
+  {
+    chops::net::decorrelated_jitter_timeout to { 100ms, 5000ms };
+    auto prev = 100ms;
+    for (std::size_t i = 1u; i <= num_attempts; ++i) {
+      auto ret = to(i);
+      REQUIRE (ret);
+      REQUIRE (*ret >= 100ms);
+      REQUIRE (*ret <= std::min(3 * prev, 5000ms));
+      prev = *ret;
+    }
+    // starts over after a successful connect
+    auto ret = to(1u);
+    REQUIRE (*ret <= 300ms);
+  }
+
+  INFO("Testing that seeded copies repeat and unseeded copies differ");
+
+  {
+    chops::net::tcp_connector_timeout_func f1 { chops::net::full_jitter_timeout { 100ms, 60000ms, 42u } };
+    chops::net::tcp_connector_timeout_func f2 { chops::net::full_jitter_timeout { 100ms, 60000ms, 42u } };
+    for (std::size_t i = 1u; i <= num_attempts; ++i) {
+      REQUIRE (f1(i) == f2(i));
+    }
+  }
+
+  {
+    chops::net::equal_jitter_timeout proto { 1000ms, 60000ms };
+    chops::net::tcp_connector_timeout_func f1 { proto };
+    chops::net::tcp_connector_timeout_func f2 { proto };
+    bool differ = false;
+    for (std::size_t i = 1u; i <= num_attempts; ++i) {
+      differ = differ || (f1(i) != f2(i));
+    }
+    REQUIRE (differ);
+  }
+}
+
+// simulates a server restart: every connector is disconnected at the same time and
+// retries a fixed number of times, the connect attempt arrival times at the server are
+// bucketed to show how much the reconnect load is spread out
+template <typename F>
+void reconnect_storm(const char* name, const F& proto, std::size_t num_conns, std::size_t retries) {
+  constexpr long long bucket_ms = 100;
+  std::map<long long, std::size_t> buckets;
+  for (std::size_t c = 0u; c < num_conns; ++c) {
+    chops::net::tcp_connector_timeout_func func { proto }; // each connector has a copy
+    long long t = 0;
+    for (std::size_t a = 1u; a <= retries; ++a) {
+      t += (*func(a)).count();
+      ++buckets[t / bucket_ms];
+    }
+  }
+  auto peak = std::max_element(buckets.cbegin(), buckets.cend(),
+                  [] (const auto& a, const auto& b) { return a.second < b.second; } );
+  std::cout << name << ": peak " << peak->second << " attempts per " << bucket_ms 
+            << "ms at " << peak->first * bucket_ms << "ms, attempts spread over "
+            << buckets.size() << " buckets, last attempt at " 
+            << buckets.crbegin()->first * bucket_ms << "ms\n";
+}
+
+TEST_CASE("tcp connector timeout reconnect storm simulation", "[.] [benchmark] [tcp_connector_timeout]") {
+
+  constexpr std::size_t num_conns = 20000u;
+  constexpr std::size_t retries = 5u;
+
+  reconnect_storm("backoff, no jitter", chops::net::backoff_timeout { 1000ms, 30000ms },
+                  num_conns, retries);
+  reconnect_storm("full jitter", chops::net::full_jitter_timeout { 1000ms, 30000ms },
+                  num_conns, retries);
+  reconnect_storm("equal jitter", chops::net::equal_jitter_timeout { 1000ms, 30000ms },
+                  num_conns, retries);
+  reconnect_storm("decorrelated jitter", chops::net::decorrelated_jitter_timeout { 1000ms, 30000ms },
+                  num_conns, retries);
+
+  chops::net::full_jitter_timeout full { 100ms, 10000ms };
+  BENCHMARK ( "full jitter timeout call" ) {
+    return full(4u);
+  };
+  chops::net::decorrelated_jitter_timeout decor { 100ms, 10000ms };
+  BENCHMARK ( "decorrelated jitter timeout call" ) {
+    return decor(4u);
+  };
+  chops::net::backoff_timeout backoff { 100ms, 10000ms };
+  BENCHMARK ( "backoff timeout call, no jitter" ) {
+    return backoff(4u);
+  };
+}
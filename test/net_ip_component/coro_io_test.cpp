@@ -0,0 +1,355 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenarios for @c coro_reader, @c async_send and @c io_state_awaiter.
+ *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/io_context.hpp"
+#include "asio/ip/tcp.hpp"
+#include "asio/buffer.hpp"
+#include "asio/post.hpp"
+#include "asio/bind_executor.hpp"
+#include "asio/awaitable.hpp"
+#include "asio/co_spawn.hpp"
+#include "asio/detached.hpp"
+#include "asio/use_awaitable.hpp"
+#include "asio/use_future.hpp"
+#include "asio/as_tuple.hpp"
+#include "asio/this_coro.hpp"
+
+#include <system_error> // std::error_code
+#include <cstddef> // std::size_t
+#include <memory> // std::make_unique, std::make_shared
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <future>
+#include <chrono>
+#include <iostream>
+
+#include "net_ip_component/coro_io.hpp"
+#include "net_ip_component/worker.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+#include "net_ip/io_type_decls.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+using tcp_reader = chops::net::coro_reader<chops::net::tcp_io>;
+using tcp_awaiter = chops::net::io_state_awaiter<chops::net::tcp_io>;
+
+constexpr std::size_t msg_size = 32u;
+constexpr std::size_t max_queued_bytes = 64u * 1024u;
+constexpr int num_round_trips = 200;
+
+asio::awaitable<void> read_strings (tcp_reader& rdr, int num, std::vector<std::string>& strs,
+                                    std::error_code& last_err) {
+  for (int i = 0; i < num; ++i) {
+    auto [err, buf] = co_await rdr.async_read(asio::as_tuple(asio::use_awaitable));
+    if (err) {
+      last_err = err;
+      co_return;
+    }
+    strs.emplace_back(static_cast<const char*>(buf.data()), buf.size());
+  }
+}
+
+void call_hdlr (tcp_reader::coro_msg_handler& mh, std::string_view s, bool expected_ret = true) {
+  REQUIRE (mh(asio::buffer(s.data(), s.size()), chops::net::tcp_io_output(),
+              asio::ip::tcp::endpoint()) == expected_ret);
+}
+
+TEST_CASE ( "Coro reader, messages arriving before a read are queued",
+            "[coro_io] [coro_reader]" ) {
+
+  asio::io_context ioc;
+  tcp_reader rdr(ioc.get_executor());
+  std::vector<std::string> strs;
+  std::error_code last_err;
+
+  {
+    auto mh = rdr.msg_handler();
+    call_hdlr(mh, "Able");
+    call_hdlr(mh, "was I");
+    call_hdlr(mh, "ere I saw Elba");
+    // IO handler stopped, last copy of message handler destroyed
+  }
+
+  asio::co_spawn(ioc, read_strings(rdr, 4, strs, last_err), asio::detached);
+  ioc.run();
+
+  REQUIRE (strs.size() == 3u);
+  REQUIRE (strs[0] == "Able");
+  REQUIRE (strs[1] == "was I");
+  REQUIRE (strs[2] == "ere I saw Elba");
+  REQUIRE (last_err == chops::net::net_ip_errc::coro_reader_io_stopped);
+}
+
+TEST_CASE ( "Coro reader, message delivered to a waiting read is not copied",
+            "[coro_io] [coro_reader]" ) {
+
+  asio::io_context ioc;
+  tcp_reader rdr(ioc.get_executor());
+  auto mh = rdr.msg_handler();
+  std::array<char, 8> msg { 'C', 'o', 'r', 'o', 'u', 't', 'i', 'n' };
+  const void* data_ptr = nullptr;
+  std::size_t data_sz = 0u;
+
+  asio::co_spawn(ioc, [&] () -> asio::awaitable<void> {
+        auto [err, buf] = co_await rdr.async_read(asio::as_tuple(asio::use_awaitable));
+        if (!err) {
+          data_ptr = buf.data();
+          data_sz = buf.size();
+        }
+      }, asio::detached);
+  bool ret = false;
+  // runs after the coroutine is waiting in async_read
+  asio::post(ioc, [&] {
+        ret = mh(asio::buffer(msg), chops::net::tcp_io_output(), asio::ip::tcp::endpoint());
+      } );
+  ioc.run();
+
+  REQUIRE (ret);
+  REQUIRE (data_ptr == msg.data());
+  REQUIRE (data_sz == msg.size());
+}
+
+TEST_CASE ( "Coro reader, destroying the reader aborts the read and ends IO processing",
+            "[coro_io] [coro_reader]" ) {
+
+  asio::io_context ioc;
+  auto rdr = std::make_unique<tcp_reader>(ioc.get_executor());
+  auto mh = rdr->msg_handler();
+  std::vector<std::string> strs;
+  std::error_code last_err;
+
+  asio::co_spawn(ioc, read_strings(*rdr, 1, strs, last_err), asio::detached);
+  asio::post(ioc, [&rdr] { rdr.reset(); } );
+  ioc.run();
+
+  REQUIRE (strs.empty());
+  REQUIRE (last_err == asio::error::operation_aborted);
+  call_hdlr(mh, "No reader", false);
+}
+
+TEST_CASE ( "IO state awaiter, started IO interfaces are returned in order",
+            "[coro_io] [io_state_awaiter]" ) {
+
+  asio::io_context ioc;
+  tcp_awaiter aw(ioc.get_executor());
+  auto io_state_chg = aw.io_state_change();
+  int num_ios = 0;
+  std::error_code last_err;
+
+  io_state_chg(chops::net::tcp_io_interface(), 1u, true);
+  io_state_chg(chops::net::tcp_io_interface(), 0u, false); // ignored
+  io_state_chg(chops::net::tcp_io_interface(), 1u, true);
+
+  asio::co_spawn(ioc, [&] () -> asio::awaitable<void> {
+        for (;;) {
+          auto [err, io] = co_await aw.async_wait_io(asio::as_tuple(asio::use_awaitable));
+          if (err) {
+            last_err = err;
+            co_return;
+          }
+          ++num_ios;
+        }
+      }, asio::detached);
+  asio::post(ioc, [&aw] { aw.close(); } );
+  ioc.run();
+
+  REQUIRE (num_ios == 2);
+  REQUIRE (last_err == asio::error::operation_aborted);
+}
+
+TEST_CASE ( "Async send, no associated IO handler",
+            "[coro_io] [async_send]" ) {
+
+  asio::io_context ioc;
+  std::error_code send_err;
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+
+  chops::net::async_send(chops::net::tcp_io_output(), buf, max_queued_bytes,
+                         asio::bind_executor(ioc,
+                             [&send_err] (std::error_code err) { send_err = err; } ));
+  ioc.run();
+
+  REQUIRE (send_err);
+}
+
+// coroutine and callback ping-pong over a TCP connection, each returns the number of
+// round trips completed
+
+void err_func (chops::net::tcp_io_interface, std::error_code) { }
+
+asio::awaitable<void> echo_session (tcp_awaiter& aw) {
+  auto [wait_err, io] = co_await aw.async_wait_io(asio::as_tuple(asio::use_awaitable));
+  if (wait_err) {
+    co_return;
+  }
+  tcp_reader rdr(co_await asio::this_coro::executor);
+  if (!io.start_io(msg_size, rdr.msg_handler())) {
+    co_return;
+  }
+  auto io_out = io.make_io_output();
+  for (;;) {
+    auto [err, buf] = co_await rdr.async_read(asio::as_tuple(asio::use_awaitable));
+    if (err) {
+      co_return;
+    }
+    auto [send_err] = co_await chops::net::async_send(*io_out,
+                                 chops::const_shared_buffer(buf.data(), buf.size()),
+                                 max_queued_bytes, asio::as_tuple(asio::use_awaitable));
+    if (send_err) {
+      co_return;
+    }
+  }
+}
+
+asio::awaitable<int> ping_pong_client (tcp_awaiter& aw, int num) {
+  // completes when the connection is established
+  auto [wait_err, io] = co_await aw.async_wait_io(asio::as_tuple(asio::use_awaitable));
+  if (wait_err) {
+    co_return 0;
+  }
+  tcp_reader rdr(co_await asio::this_coro::executor);
+  if (!io.start_io(msg_size, rdr.msg_handler())) {
+    co_return 0;
+  }
+  auto io_out = io.make_io_output();
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+  int cnt = 0;
+  for (; cnt < num; ++cnt) {
+    auto [send_err] = co_await chops::net::async_send(*io_out, buf, max_queued_bytes,
+                                                      asio::as_tuple(asio::use_awaitable));
+    if (send_err) {
+      break;
+    }
+    auto [err, rd_buf] = co_await rdr.async_read(asio::as_tuple(asio::use_awaitable));
+    if (err || rd_buf.size() != msg_size) {
+      break;
+    }
+  }
+  co_return cnt;
+}
+
+int coro_ping_pong (int num, unsigned short port) {
+
+  chops::net::worker wk;
+  wk.start();
+  auto exec = wk.get_io_context().get_executor();
+
+  asio::ip::tcp::endpoint endp(asio::ip::make_address("127.0.0.1"), port);
+  chops::net::net_ip nip(wk.get_io_context());
+  tcp_awaiter acc_aw(exec);
+  tcp_awaiter conn_aw(exec);
+
+  auto acc = nip.make_tcp_acceptor(endp);
+  REQUIRE (acc.start(acc_aw.io_state_change(), err_func));
+  asio::co_spawn(exec, echo_session(acc_aw), asio::detached);
+
+  auto start = std::chrono::steady_clock::now();
+  auto conn = nip.make_tcp_connector(endp);
+  auto fut = asio::co_spawn(exec, ping_pong_client(conn_aw, num), asio::use_future);
+  REQUIRE (conn.start(conn_aw.io_state_change(), err_func));
+  int cnt = fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cerr << "Coroutine TCP ping-pong, round trips: " << cnt <<
+               ", usecs per round trip: " <<
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+                   (1000.0 * num) << std::endl;
+
+  conn.stop();
+  acc.stop();
+  acc_aw.close();
+  conn_aw.close();
+  nip.remove_all();
+  wk.reset();
+  return cnt;
+}
+
+int callback_ping_pong (int num, unsigned short port) {
+
+  chops::net::worker wk;
+  wk.start();
+
+  asio::ip::tcp::endpoint endp(asio::ip::make_address("127.0.0.1"), port);
+  chops::net::net_ip nip(wk.get_io_context());
+
+  auto acc = nip.make_tcp_acceptor(endp);
+  REQUIRE (acc.start( [] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+      if (starting) {
+        io.start_io(msg_size, [] (asio::const_buffer buf, chops::net::tcp_io_output io_out,
+                                  asio::ip::tcp::endpoint) {
+            return io_out.send(buf.data(), buf.size());
+          } );
+      }
+    }, err_func));
+
+  chops::const_shared_buffer buf { chops::mutable_shared_buffer(msg_size) };
+  auto prom = std::make_shared<std::promise<int>>();
+  auto fut = prom->get_future();
+
+  auto start = std::chrono::steady_clock::now();
+  auto conn = nip.make_tcp_connector(endp);
+  REQUIRE (conn.start( [buf, prom, num] (chops::net::tcp_io_interface io, std::size_t,
+                                         bool starting) {
+      if (starting) {
+        io.start_io(msg_size, [buf, prom, num, cnt = 0] (asio::const_buffer,
+                                  chops::net::tcp_io_output io_out,
+                                  asio::ip::tcp::endpoint) mutable {
+            if (++cnt == num) {
+              prom->set_value(cnt);
+              return false;
+            }
+            return io_out.send(buf);
+          } );
+        io.make_io_output()->send(buf);
+      }
+    }, err_func));
+  int cnt = fut.get();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cerr << "Callback TCP ping-pong, round trips: " << cnt <<
+               ", usecs per round trip: " <<
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+                   (1000.0 * num) << std::endl;
+
+  conn.stop();
+  acc.stop();
+  nip.remove_all();
+  wk.reset();
+  return cnt;
+}
+
+TEST_CASE ( "Coroutine TCP ping-pong, connector wait, reads and sends",
+            "[coro_io] [tcp_ping_pong]" ) {
+
+  REQUIRE (coro_ping_pong(num_round_trips, 30883) == num_round_trips);
+
+}
+
+TEST_CASE ( "Coroutine versus callback TCP ping-pong benchmark",
+            "[.] [benchmark] [coro_io] [tcp_ping_pong]" ) {
+
+  constexpr int num_bench = 100000;
+  REQUIRE (callback_ping_pong(num_bench, 30884) == num_bench);
+  REQUIRE (coro_ping_pong(num_bench, 30884) == num_bench);
+
+}
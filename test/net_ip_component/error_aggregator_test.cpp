@@ -0,0 +1,213 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenario for error aggregator component.
+ *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstddef> // std::size_t
+#include <system_error>
+#include <future>
+#include <functional> // std::ref
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <sstream>
+#include <iostream>
+
+#include "net_ip/net_ip_error.hpp"
+
+#include "net_ip_component/error_aggregator.hpp"
+#include "net_ip_component/error_delivery.hpp"
+
+#include "queue/wait_queue.hpp"
+
+#include "shared_test/mock_classes.hpp"
+
+using errc = chops::net::net_ip_errc;
+
+TEST_CASE ( "Testing error_aggregator counts and recent events",
+            "[error_aggregator]" ) {
+
+  using namespace chops::test;
+
+  auto ioh1 = std::make_shared<io_handler_mock>();
+  auto ioh2 = std::make_shared<io_handler_mock>();
+  auto io1 = io_interface_mock(ioh1);
+  auto io2 = io_interface_mock(ioh2);
+
+  chops::net::error_aggregator agg(4u);
+  auto err_func = chops::net::make_error_func_with_aggregator<io_handler_mock>(agg);
+
+  err_func(io1, std::make_error_code(errc::tcp_connector_resolving_addresses));
+  err_func(io1, std::make_error_code(errc::tcp_connector_connecting));
+  err_func(io1, std::make_error_code(errc::tcp_connector_connected));
+  err_func(io2, std::make_error_code(errc::tcp_io_handler_stopped));
+  err_func(io2, std::make_error_code(std::errc::connection_reset));
+  err_func(io1, std::make_error_code(errc::tcp_connector_closed));
+
+  auto snap = agg.snapshot();
+  REQUIRE (snap.total(errc::tcp_connector_connecting) == 1u);
+  REQUIRE (snap.total(errc::tcp_io_handler_stopped) == 1u);
+  REQUIRE (snap.total(errc::weak_ptr_expired) == 0u);
+  REQUIRE (snap.total_counts[chops::net::error_snapshot::other_index] == 1u);
+  REQUIRE (snap.interval(errc::tcp_connector_closed) == 1u);
+  REQUIRE (snap.suppressed == 0u);
+  REQUIRE (snap.interval_suppressed == 0u);
+  // ring holds the latest 4 events, oldest first
+  REQUIRE (snap.recent.size() == 4u);
+  REQUIRE (snap.recent.front().err == std::make_error_code(errc::tcp_connector_connected));
+  REQUIRE (snap.recent.front().io_intf_ptr == io1.get_ptr());
+  REQUIRE (snap.recent[2].err == std::make_error_code(std::errc::connection_reset));
+  REQUIRE (snap.recent.back().err == std::make_error_code(errc::tcp_connector_closed));
+
+  // interval counts and recent events are relative to the previous snapshot
+  err_func(io1, std::make_error_code(errc::tcp_connector_connecting));
+  snap = agg.snapshot();
+  REQUIRE (snap.total(errc::tcp_connector_connecting) == 2u);
+  REQUIRE (snap.interval(errc::tcp_connector_connecting) == 1u);
+  REQUIRE (snap.interval(errc::tcp_connector_closed) == 0u);
+  REQUIRE (snap.recent.size() == 1u);
+
+  std::ostringstream os;
+  chops::net::ostream_error_snapshot(snap, os);
+  REQUIRE_FALSE (os.str().empty());
+}
+
+TEST_CASE ( "Testing error_aggregator sampling and rate limits",
+            "[error_aggregator]" ) {
+
+  chops::net::error_aggregator agg(64u, std::chrono::seconds(60));
+  const void* ptr = &agg;
+
+  agg.set_code_policy(errc::tcp_connector_connecting, chops::net::error_code_policy { 0u, 0u });
+  agg.set_code_policy(errc::tcp_connector_connected, chops::net::error_code_policy { 4u, 0u });
+  agg.set_code_policy(errc::tcp_connector_closed, chops::net::error_code_policy { 1u, 3u });
+
+  for (int i = 0; i < 10; ++i) {
+    agg.record(ptr, std::make_error_code(errc::tcp_connector_connecting));
+    agg.record(ptr, std::make_error_code(errc::tcp_connector_connected));
+    agg.record(ptr, std::make_error_code(errc::tcp_connector_closed));
+  }
+  auto snap = agg.snapshot();
+  REQUIRE (snap.total(errc::tcp_connector_connecting) == 10u);
+  REQUIRE (snap.total(errc::tcp_connector_connected) == 10u);
+  REQUIRE (snap.total(errc::tcp_connector_closed) == 10u);
+  REQUIRE (snap.suppressed == 7u);
+  REQUIRE (snap.interval_suppressed == 7u);
+
+  std::size_t connecting = 0u, connected = 0u, closed = 0u;
+  for (const auto& ev : snap.recent) {
+    connecting += (ev.err == std::make_error_code(errc::tcp_connector_connecting)) ? 1u : 0u;
+    connected += (ev.err == std::make_error_code(errc::tcp_connector_connected)) ? 1u : 0u;
+    closed += (ev.err == std::make_error_code(errc::tcp_connector_closed)) ? 1u : 0u;
+  }
+  REQUIRE (connecting == 0u);
+  REQUIRE (connected == 2u); // single recording thread, every 4th event
+  REQUIRE (closed == 3u);
+
+  // the rate interval has not expired, so all of these are suppressed
+  for (int i = 0; i < 5; ++i) {
+    agg.record(ptr, std::make_error_code(errc::tcp_connector_closed));
+  }
+  snap = agg.snapshot();
+  REQUIRE (snap.suppressed == 12u);
+  REQUIRE (snap.interval_suppressed == 5u);
+  REQUIRE (snap.interval(errc::tcp_connector_closed) == 5u);
+  REQUIRE (snap.recent.empty());
+}
+
+TEST_CASE ( "Testing error_aggregator concurrent recording and periodic snapshots",
+            "[error_aggregator] [concurrent]" ) {
+
+  constexpr int num_thrs = 4;
+  constexpr int errs_per_thr = 10000;
+
+  chops::net::error_aggregator agg(16u);
+
+  std::promise<void> stop_prom;
+  std::size_t interval_tot = 0u;
+  bool recent_ok = true;
+  auto snap_fut = std::async(std::launch::async,
+        chops::net::periodic_error_snapshots<std::function<void (const chops::net::error_snapshot&)>>,
+        std::ref(agg), std::chrono::milliseconds(5), stop_prom.get_future().share(),
+        [&interval_tot, &recent_ok] (const chops::net::error_snapshot& snap) {
+          interval_tot += snap.interval(errc::tcp_connector_connected);
+          recent_ok = recent_ok && snap.recent.size() <= 16u;
+        } );
+
+  std::vector<std::thread> thrs;
+  for (int i = 0; i < num_thrs; ++i) {
+    thrs.emplace_back( [&agg] {
+        for (int j = 0; j < errs_per_thr; ++j) {
+          agg.record(&agg, std::make_error_code(errc::tcp_connector_connected));
+        }
+      } );
+  }
+  for (auto& t : thrs) {
+    t.join();
+  }
+  stop_prom.set_value();
+  REQUIRE (snap_fut.get() >= 1u);
+  REQUIRE (interval_tot == static_cast<std::size_t>(num_thrs * errs_per_thr));
+  REQUIRE (recent_ok);
+  REQUIRE (agg.snapshot().total(errc::tcp_connector_connected) ==
+           static_cast<std::size_t>(num_thrs * errs_per_thr));
+}
+
+TEST_CASE ( "Testing error_aggregator versus wait_queue error delivery benchmark",
+            "[.] [benchmark] [error_aggregator]" ) {
+
+  using namespace chops::test;
+
+  constexpr int errs_per_thr = 200000;
+
+  auto ioh = std::make_shared<io_handler_mock>();
+  auto io = io_interface_mock(ioh);
+  auto ec = std::make_error_code(errc::tcp_connector_connecting);
+
+  auto run = [] (int num_thrs, auto err_func) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> thrs;
+    for (int i = 0; i < num_thrs; ++i) {
+      thrs.emplace_back( [err_func] () mutable {
+          for (int j = 0; j < errs_per_thr; ++j) {
+            err_func();
+          }
+        } );
+    }
+    for (auto& t : thrs) {
+      t.join();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start).count() /
+             (static_cast<long long>(num_thrs) * errs_per_thr);
+  };
+
+  for (int num_thrs : { 1, 2, 4 }) {
+    chops::net::err_wait_q wq;
+    auto wq_func = chops::net::make_error_func_with_wait_queue<io_handler_mock>(wq);
+    auto wq_ns = run(num_thrs, [wq_func, io, ec] () mutable { wq_func(io, ec); });
+
+    chops::net::error_aggregator agg;
+    auto agg_func = chops::net::make_error_func_with_aggregator<io_handler_mock>(agg);
+    auto agg_ns = run(num_thrs, [agg_func, io, ec] () mutable { agg_func(io, ec); });
+
+    std::cerr << "error delivery, threads: " << num_thrs <<
+                 ", nsecs per error, wait_queue: " << wq_ns <<
+                 ", error_aggregator: " << agg_ns << std::endl;
+  }
+}
+
@@ -18,6 +18,8 @@
 #include <vector>
 #include <list>
 #include <memory> // std::shared_ptr
+#include <future>
+#include <chrono>
 
 #include "net_ip_component/output_queue_stats.hpp"
 
@@ -52,6 +54,15 @@ TEST_CASE ( "Testing accumulate_output_queue_stats for io_output objects",
       }
   );
 
+  auto fut = chops::net::make_output_queue_drained_future(io_out_vec.cbegin(), io_out_vec.cend());
+  REQUIRE (fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
+  // no IO handler is treated as drained
+  std::vector<io_out_mock> empty_out_vec { io_out_mock(), io_out_mock() };
+  fut = chops::net::make_output_queue_drained_future(empty_out_vec.cbegin(), 
+                                                     empty_out_vec.cend(), 10u);
+  REQUIRE (fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
 }
 
 TEST_CASE ( "Testing accumulate_output_queue_stats for net_entity objects",
@@ -78,6 +89,10 @@ TEST_CASE ( "Testing accumulate_output_queue_stats for net_entity objects",
       }
   );
 
+  auto fut = chops::net::make_net_entity_output_queue_drained_future<chops::net::udp_io>(
+                                                     ne_list.cbegin(), ne_list.cend());
+  REQUIRE (fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+
 }
 
 
@@ -4,6 +4,8 @@
  *
  *  @brief Test scenario for @c send_to_all class template.
  *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
  *  @author Cliff Green
  *
  *  Copyright (c) 2018-2025 by Cliff Green
@@ -17,15 +19,94 @@
 
 #include <cstddef> // std::size_t
 
-#include <memory> // std::make_shared
+#include <memory> // std::make_shared, std::make_unique
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <future>
 
 #include "net_ip_component/send_to_all.hpp"
+#include "net_ip_component/worker.hpp"
 
 #include "net_ip/queue_stats.hpp"
 #include "buffer/shared_buffer.hpp"
 
+#include "asio/ip/udp.hpp"
+#include "asio/io_context.hpp"
+#include "asio/any_io_executor.hpp"
+
 #include "shared_test/mock_classes.hpp"
 
+// thread-safe IO handler for concurrent send tests, counts the buffers sent
+struct counting_ioh : public std::enable_shared_from_this<counting_ioh> {
+  using endpoint_type = asio::ip::udp::endpoint;
+
+  std::atomic_size_t    sends { 0u };
+  std::atomic_size_t    sends_in_own_ctx { 0u };
+  std::atomic_size_t    queued_bytes { 0u }; // set by slow consumer tests
+  std::atomic_bool      stopped { false };
+  std::atomic_bool      timestamps { false };
+  asio::any_io_executor exec;
+
+  counting_ioh() = default;
+  explicit counting_ioh(asio::any_io_executor ex) : exec(ex) { }
+
+  chops::net::output_queue_stats get_output_queue_stats() const { 
+    return chops::net::output_queue_stats { 0u, queued_bytes.load() };
+  }
+  std::size_t clear_output_queue() { queued_bytes = 0u; return 1u; }
+  void enable_output_timestamps() { timestamps = true; }
+  bool stop_io() { return !stopped.exchange(true); }
+  asio::any_io_executor get_executor() const { return exec; }
+  bool send(chops::const_shared_buffer) {
+    ++sends;
+    auto p = exec.target<asio::io_context::executor_type>();
+    if (p && p->running_in_this_thread()) {
+      ++sends_in_own_ctx;
+    }
+    return true;
+  }
+  template <typename R>
+  std::size_t send_batch(const R& bufs) {
+    std::size_t cnt = 0u;
+    for (const auto& b : bufs) {
+      cnt += send(b) ? 1u : 0u;
+    }
+    return cnt;
+  }
+};
+
+using counting_sta = chops::net::send_to_all<counting_ioh>;
+
+// broadcast from num_thrs threads while another thread adds and removes a subscriber
+void concurrent_sends (counting_sta& sta, int num_thrs, int sends_per_thr) {
+  std::atomic_bool done { false };
+  auto extra = std::make_shared<counting_ioh>();
+  std::thread churn ( [&sta, &done, extra] {
+      chops::net::basic_io_output<counting_ioh> out(extra);
+      while (!done) {
+        sta.add_io_output(out);
+        sta.remove_io_output(out);
+      }
+    } );
+  std::vector<std::thread> thrs;
+  chops::const_shared_buffer buf(chops::mutable_shared_buffer(8u));
+  for (int i = 0; i < num_thrs; ++i) {
+    thrs.emplace_back( [&sta, buf, sends_per_thr] {
+        for (int j = 0; j < sends_per_thr; ++j) {
+          sta.send(buf);
+        }
+      } );
+  }
+  for (auto& t : thrs) {
+    t.join();
+  }
+  done = true;
+  churn.join();
+}
+
 TEST_CASE ( "Testing send_to_all class", "[send_to_all]" ) {
 
   using namespace chops::test;
@@ -75,7 +156,252 @@ TEST_CASE ( "Testing send_to_all class", "[send_to_all]" ) {
   REQUIRE(ioh1->send_called);
   REQUIRE(ioh2->send_called);
 
+  std::vector<chops::const_shared_buffer> bufs { buf, buf, buf };
+  REQUIRE (sta.send_batch(bufs) == 2u * bufs.size());
+  REQUIRE (sta.send_batch(bufs, out1) == bufs.size());
+
   auto tot = sta.get_total_output_queue_stats();
   REQUIRE(tot.output_queue_size == sta.size() * io_handler_mock::qs_base);
   REQUIRE(tot.bytes_in_output_queue == sta.size() * (io_handler_mock::qs_base + 1));
 }
+
+TEST_CASE ( "Testing send_to_all class, slow consumer policies", "[send_to_all] [slow_consumer]" ) {
+
+  using policy = chops::net::slow_consumer_policy;
+  constexpr std::size_t limit = 100u;
+
+  auto make_ioh = [] { 
+    auto ioh = std::make_shared<counting_ioh>();
+    ioh->queued_bytes = limit + 1u; // over the limit
+    return ioh;
+  };
+  auto ioh_skip = make_ioh();
+  auto ioh_confl = make_ioh();
+  auto ioh_disc = make_ioh();
+  auto ioh_ok = std::make_shared<counting_ioh>();
+  auto ioh_nolim = make_ioh();
+
+  // default policy has no limits
+  counting_sta sta { };
+  REQUIRE_FALSE (policy().is_active());
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_skip),
+                    policy { limit, { }, { }, policy::action::skip });
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_confl),
+                    policy { limit, { }, { }, policy::action::conflate });
+  sta.add_io_interface(chops::net::basic_io_interface<counting_ioh>(ioh_disc),
+                    policy { limit, { }, { }, policy::action::disconnect });
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_ok),
+                    policy { limit, { }, { }, policy::action::disconnect });
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_nolim));
+  REQUIRE (sta.size() == 5u);
+  // output queue time stamps are only needed for age or stall limits
+  REQUIRE_FALSE (ioh_skip->timestamps);
+  REQUIRE_FALSE (ioh_nolim->timestamps);
+
+  chops::const_shared_buffer buf(chops::mutable_shared_buffer(8u));
+  sta.send(buf);
+
+  REQUIRE (ioh_skip->sends == 0u);
+  REQUIRE (ioh_confl->sends == 1u);
+  REQUIRE (ioh_confl->queued_bytes == 0u);
+  REQUIRE (ioh_disc->sends == 0u);
+  REQUIRE (ioh_disc->stopped);
+  REQUIRE (ioh_ok->sends == 1u);
+  REQUIRE (ioh_nolim->sends == 1u);
+  REQUIRE (sta.size() == 4u);
+
+  auto st = sta.get_slow_consumer_stats();
+  REQUIRE (st.skipped == 1u);
+  REQUIRE (st.conflated == 1u);
+  REQUIRE (st.disconnected == 1u);
+
+  std::vector<chops::const_shared_buffer> bufs { buf, buf };
+  REQUIRE (sta.send_batch(bufs) == 3u * bufs.size()); // skip subscriber still over the limit
+  ioh_skip->queued_bytes = 0u;
+  sta.send(buf);
+  REQUIRE (ioh_skip->sends == 1u);
+
+  st = sta.get_slow_consumer_stats();
+  REQUIRE (st.skipped == 2u);
+  REQUIRE (st.conflated == 1u);
+  REQUIRE (st.disconnected == 1u);
+
+  // default policy from the constructor, used by the io_state_change interface
+  counting_sta sta_def { policy { limit, { }, { }, policy::action::disconnect } };
+  auto ioh_def = make_ioh();
+  sta_def(chops::net::basic_io_interface<counting_ioh>(ioh_def), 1u, true);
+  REQUIRE (sta_def.size() == 1u);
+  sta_def.send(buf);
+  REQUIRE (sta_def.size() == 0u);
+  REQUIRE (ioh_def->stopped);
+  REQUIRE (ioh_def->sends == 0u);
+  REQUIRE (sta_def.get_slow_consumer_stats().disconnected == 1u);
+
+  auto ioh_age = std::make_shared<counting_ioh>();
+  auto ioh_stall = std::make_shared<counting_ioh>();
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_age),
+                    policy { 0u, std::chrono::seconds(1), { }, policy::action::skip });
+  sta.add_io_output(chops::net::basic_io_output<counting_ioh>(ioh_stall),
+                    policy { 0u, { }, std::chrono::seconds(1), policy::action::skip });
+  REQUIRE (ioh_age->timestamps);
+  REQUIRE (ioh_stall->timestamps);
+}
+
+TEST_CASE ( "Testing send_to_all class, membership changes during concurrent sends",
+            "[send_to_all] [concurrent]" ) {
+
+  constexpr int num_subs = 100;
+  constexpr int num_thrs = 4;
+  constexpr int sends_per_thr = 1000;
+
+  counting_sta sta { };
+  std::vector<std::shared_ptr<counting_ioh> > iohs;
+  for (int i = 0; i < num_subs; ++i) {
+    iohs.push_back(std::make_shared<counting_ioh>());
+    sta.add_io_output(chops::net::basic_io_output<counting_ioh>(iohs.back()));
+  }
+  concurrent_sends(sta, num_thrs, sends_per_thr);
+  REQUIRE (sta.size() == static_cast<std::size_t>(num_subs));
+  for (const auto& ioh : iohs) {
+    REQUIRE (ioh->sends == static_cast<std::size_t>(num_thrs * sends_per_thr));
+  }
+}
+
+TEST_CASE ( "Testing send_to_all class, 10k subscribers concurrent send benchmark",
+            "[.] [benchmark] [send_to_all]" ) {
+
+  constexpr int num_subs = 10000;
+  constexpr int sends_per_thr = 1000;
+
+  counting_sta sta { };
+  std::vector<std::shared_ptr<counting_ioh> > iohs;
+  for (int i = 0; i < num_subs; ++i) {
+    iohs.push_back(std::make_shared<counting_ioh>());
+    sta.add_io_output(chops::net::basic_io_output<counting_ioh>(iohs.back()));
+  }
+  for (int num_thrs : { 1, 2, 4, 8 }) {
+    auto start = std::chrono::steady_clock::now();
+    concurrent_sends(sta, num_thrs, sends_per_thr);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "send_to_all, subscribers: " << num_subs << ", send threads: " << num_thrs <<
+                 ", nsecs per buffer sent: " << 
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / 
+                     (1.0 * num_subs * num_thrs * sends_per_thr) << std::endl;
+  }
+  REQUIRE (sta.size() == static_cast<std::size_t>(num_subs));
+}
+
+asio::any_io_executor get_exec (asio::io_context& ioc) { return ioc.get_executor(); }
+asio::any_io_executor get_exec (chops::net::worker& wk) { return wk.get_io_context().get_executor(); }
+
+// add num_per_ctx subscribers for each io_context (or worker), returning the IO handlers
+template <typename C>
+std::vector<std::shared_ptr<counting_ioh> > add_ctx_subs (counting_sta& sta, C& ctxs,
+                                                          int num_per_ctx) {
+  std::vector<std::shared_ptr<counting_ioh> > iohs;
+  for (int i = 0; i < num_per_ctx; ++i) {
+    for (auto& ctx : ctxs) {
+      iohs.push_back(std::make_shared<counting_ioh>(get_exec(ctx)));
+      sta.add_io_output(chops::net::basic_io_output<counting_ioh>(iohs.back()));
+    }
+  }
+  return iohs;
+}
+
+// send_parallel, then run each io_context in its own thread, returns the completion count
+std::size_t run_send_parallel (const counting_sta& sta, std::vector<asio::io_context>& iocs,
+                               std::size_t expected_tasks) {
+  std::promise<std::size_t> prom;
+  auto fut = prom.get_future();
+  REQUIRE (sta.send_parallel(chops::const_shared_buffer(chops::mutable_shared_buffer(8u)),
+                 [&prom] (std::size_t n) { prom.set_value(n); } ) == expected_tasks);
+  std::vector<std::thread> thrs;
+  for (auto& ioc : iocs) {
+    thrs.emplace_back( [&ioc] { ioc.run(); ioc.restart(); } );
+  }
+  for (auto& t : thrs) {
+    t.join();
+  }
+  return fut.get();
+}
+
+TEST_CASE ( "Testing send_to_all class, parallel send across io_contexts",
+            "[send_to_all] [send_parallel]" ) {
+
+  constexpr int num_per_ctx = 5;
+
+  counting_sta sta { };
+  std::vector<asio::io_context> iocs(3);
+  REQUIRE (run_send_parallel(sta, iocs, 0u) == 0u);
+
+  auto iohs = add_ctx_subs(sta, iocs, num_per_ctx);
+  REQUIRE (run_send_parallel(sta, iocs, iocs.size()) == iohs.size());
+  for (const auto& ioh : iohs) {
+    REQUIRE (ioh->sends == 1u);
+    REQUIRE (ioh->sends_in_own_ctx == 1u);
+  }
+
+  // membership change, partitions recomputed
+  sta.remove_io_output(chops::net::basic_io_output<counting_ioh>(iohs.front()));
+  REQUIRE (run_send_parallel(sta, iocs, iocs.size()) == iohs.size() - 1u);
+  REQUIRE (iohs.front()->sends == 1u);
+  REQUIRE (iohs.back()->sends == 2u);
+
+  // the posted tasks may run after the send_to_all object is destroyed
+  std::size_t sent = 0u;
+  std::vector<std::shared_ptr<counting_ioh> > tmp_iohs;
+  {
+    auto sta_tmp = std::make_unique<counting_sta>(chops::net::slow_consumer_policy { 100u });
+    tmp_iohs = add_ctx_subs(*sta_tmp, iocs, 1);
+    REQUIRE (sta_tmp->send_parallel(chops::const_shared_buffer(chops::mutable_shared_buffer(8u)),
+                 [&sent] (std::size_t n) { sent = n; } ) == iocs.size());
+  }
+  for (auto& ioc : iocs) {
+    ioc.run();
+    ioc.restart();
+  }
+  REQUIRE (sent == iocs.size());
+}
+
+TEST_CASE ( "Testing send_to_all class, 50k subscribers serial versus parallel send benchmark",
+            "[.] [benchmark] [send_to_all] [send_parallel]" ) {
+
+  constexpr int num_ctxs = 4;
+  constexpr int num_per_ctx = 12500;
+  constexpr int num_sends = 100;
+
+  counting_sta sta { };
+  // each io_context run by a worker thread for the whole benchmark
+  std::vector<chops::net::worker> wks(num_ctxs);
+  for (auto& wk : wks) {
+    wk.start();
+  }
+  auto iohs = add_ctx_subs(sta, wks, num_per_ctx);
+  chops::const_shared_buffer buf(chops::mutable_shared_buffer(8u));
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_sends; ++i) {
+    sta.send(buf);
+  }
+  auto serial = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_sends; ++i) {
+    std::promise<std::size_t> prom;
+    auto fut = prom.get_future();
+    sta.send_parallel(buf, [&prom] (std::size_t n) { prom.set_value(n); } );
+    REQUIRE (fut.get() == iohs.size());
+  }
+  auto parallel = std::chrono::steady_clock::now() - start;
+
+  std::cerr << "send_to_all, subscribers: " << iohs.size() << ", io_contexts: " << num_ctxs <<
+               ", usecs per serial send: " << 
+               std::chrono::duration_cast<std::chrono::microseconds>(serial).count() / (1.0 * num_sends) <<
+               ", usecs per parallel send: " << 
+               std::chrono::duration_cast<std::chrono::microseconds>(parallel).count() / (1.0 * num_sends) <<
+               std::endl;
+  REQUIRE (iohs.front()->sends == 2u * num_sends);
+  for (auto& wk : wks) {
+    wk.reset();
+  }
+}
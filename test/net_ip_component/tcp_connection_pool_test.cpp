@@ -0,0 +1,254 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenarios for @c tcp_connection_pool class.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0. 
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/ip/tcp.hpp"
+#include "asio/buffer.hpp"
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <string_view>
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <chrono>
+
+#include "net_ip_component/tcp_connection_pool.hpp"
+#include "net_ip_component/worker.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+
+const char* test_port = "30881";
+const char* test_host = "localhost";
+constexpr std::size_t num_conns = 4u;
+
+// records which connection (remote endpoint) each key arrives on, a message is the key
+// followed by a newline
+struct key_tracker {
+  std::mutex                                                  m_mutex;
+  std::map<std::string, std::set<asio::ip::tcp::endpoint> >  m_keys;
+  std::atomic_size_t                                          m_msgs = 0u;
+
+  void operator() (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+    if (starting) {
+      io.start_io(std::string_view("\n"), 
+          [this] (asio::const_buffer buf, chops::net::tcp_io_output, asio::ip::tcp::endpoint endp) {
+            std::string key(static_cast<const char*>(buf.data()), buf.size() - 1u);
+            {
+              std::scoped_lock<std::mutex> lk(m_mutex);
+              m_keys[key].insert(endp);
+            }
+            ++m_msgs;
+            return true;
+          }
+      );
+    }
+  }
+};
+
+void pool_io_state_chg (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+  if (starting) {
+    io.start_io(std::string_view("\n"), 
+                [] (asio::const_buffer, chops::net::tcp_io_output, asio::ip::tcp::endpoint) {
+                  return true;
+                }
+    );
+  }
+}
+
+void pool_err_func (chops::net::tcp_io_interface, std::error_code) { }
+
+template <typename P>
+void wait_for (P pred) {
+  using namespace std::chrono_literals;
+  for (int i = 0; i < 500 && !pred(); ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+}
+
+TEST_CASE ( "Tcp connection pool, round robin, key affinity and stats", "[tcp_connection_pool]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  chops::net::net_ip nip(wk.get_io_context());
+
+  key_tracker tracker;
+  auto acc = nip.make_tcp_acceptor(test_port);
+  REQUIRE (acc.start(std::ref(tracker), pool_err_func));
+
+  {
+    chops::net::tcp_connection_pool pool(nip, num_conns, test_port, test_host,
+                                         chops::net::pool_send_policy::round_robin,
+                                         chops::net::simple_timeout(50ms));
+    REQUIRE (pool.size() == num_conns);
+    REQUIRE (pool.num_connected() == 0u);
+    REQUIRE_FALSE (pool.send("x\n", 2u));
+
+    REQUIRE_FALSE (pool.start(pool_io_state_chg, pool_err_func));
+    wait_for([&pool] { return pool.num_connected() == num_conns; });
+    REQUIRE (pool.num_connected() == num_conns);
+
+    constexpr std::size_t rr_msgs = 40u;
+    for (std::size_t i = 0u; i < rr_msgs; ++i) {
+      REQUIRE (pool.send("rr\n", 3u));
+    }
+    auto st = pool.get_member_stats();
+    REQUIRE (st.size() == num_conns);
+    for (const auto& m : st) {
+      REQUIRE (m.connected);
+      REQUIRE (m.connects == 1u);
+      REQUIRE (m.sends == rr_msgs / num_conns);
+      REQUIRE (m.bytes_sent == 3u * rr_msgs / num_conns);
+    }
+
+    const std::string keys[] { "alpha", "bravo", "charlie", "delta", "echo", "foxtrot" };
+    constexpr std::size_t key_msgs = 20u;
+    for (std::size_t i = 0u; i < key_msgs; ++i) {
+      for (const auto& k : keys) {
+        REQUIRE (pool.send_by_key(k, k.data(), k.size()));
+        REQUIRE (pool.send_by_key(k, "\n", 1u));
+      }
+    }
+    std::size_t total = rr_msgs + key_msgs * std::size(keys);
+    wait_for([&tracker, total] { return tracker.m_msgs == total; });
+    REQUIRE (tracker.m_msgs == total);
+
+    std::scoped_lock<std::mutex> lk(tracker.m_mutex);
+    REQUIRE (tracker.m_keys["rr"].size() == num_conns); // spread across every connection
+    for (const auto& k : keys) {
+      REQUIRE (tracker.m_keys[k].size() == 1u); // each key on a single connection
+    }
+  }
+  // the pool destructor stops and removes the connectors
+  acc.stop();
+  nip.remove_all();
+  wk.reset();
+}
+
+TEST_CASE ( "Tcp connection pool, least loaded and reconnects", "[tcp_connection_pool]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  chops::net::net_ip nip(wk.get_io_context());
+
+  chops::net::tcp_connection_pool pool(nip, num_conns, test_port, test_host,
+                                       chops::net::pool_send_policy::least_loaded,
+                                       chops::net::simple_timeout(50ms));
+  // the connectors retry until the acceptor is started
+  REQUIRE_FALSE (pool.start(pool_io_state_chg, pool_err_func));
+
+  for (int i = 0; i < 2; ++i) {
+    key_tracker tracker;
+    auto acc = nip.make_tcp_acceptor(test_port);
+    REQUIRE (acc.start(std::ref(tracker), pool_err_func));
+    wait_for([&pool] { return pool.num_connected() == num_conns; });
+    REQUIRE (pool.num_connected() == num_conns);
+
+    constexpr std::size_t msgs = 200u;
+    for (std::size_t j = 0u; j < msgs; ++j) {
+      REQUIRE (pool.send("ll\n", 3u));
+    }
+    wait_for([&tracker, msgs] { return tracker.m_msgs == msgs; });
+    REQUIRE (tracker.m_msgs == msgs);
+
+    // stopping the acceptor drops every connection, the pool reconnects when the 
+    // next acceptor is started
+    acc.stop();
+    nip.remove(acc);
+    wait_for([&pool] { return pool.num_connected() == 0u; });
+    REQUIRE (pool.num_connected() == 0u);
+    REQUIRE_FALSE (pool.send("ll\n", 3u));
+  }
+
+  std::size_t sends = 0u;
+  for (const auto& m : pool.get_member_stats()) {
+    REQUIRE_FALSE (m.connected);
+    REQUIRE (m.connects == 2u);
+    sends += m.sends;
+  }
+  REQUIRE (sends == 400u);
+
+  pool.stop();
+  wk.reset();
+}
+
+
+TEST_CASE ( "Tcp connection pool, send when the chosen connection has stopped", "[tcp_connection_pool]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start();
+  chops::net::net_ip nip(wk.get_io_context());
+
+  key_tracker tracker;
+  auto acc = nip.make_tcp_acceptor(test_port);
+  REQUIRE (acc.start(std::ref(tracker), pool_err_func));
+
+  std::mutex io_mutex;
+  std::optional<chops::net::tcp_io_interface> first_io;
+  std::atomic_bool sent = false;
+  std::atomic_size_t accepted = 0u;
+  {
+    chops::net::tcp_connection_pool pool(nip, num_conns, test_port, test_host,
+                                         chops::net::pool_send_policy::round_robin,
+                                         chops::net::simple_timeout(50ms));
+    auto io_state_chg = [&io_mutex, &first_io] (chops::net::tcp_io_interface io, 
+                                                std::size_t num, bool starting) {
+      pool_io_state_chg(io, num, starting);
+      std::scoped_lock<std::mutex> lk(io_mutex);
+      if (starting && !first_io) {
+        first_io = io;
+      }
+    };
+    // the error function is called after the IO handler has stopped but before the pool 
+    // is told the connection is down, so the stopped connection is still in the snapshot
+    // and is chosen by one of the round robin sends
+    auto err_func = [&pool, &sent, &accepted] (chops::net::tcp_io_interface, std::error_code e) {
+      if (e != chops::net::net_ip_errc::tcp_io_handler_stopped || sent.exchange(true)) {
+        return;
+      }
+      for (std::size_t i = 0u; i < num_conns; ++i) {
+        accepted += pool.send("st\n", 3u) ? 1u : 0u;
+      }
+    };
+    REQUIRE_FALSE (pool.start(io_state_chg, err_func));
+    wait_for([&pool] { return pool.num_connected() == num_conns; });
+    REQUIRE (pool.num_connected() == num_conns);
+
+    {
+      std::scoped_lock<std::mutex> lk(io_mutex);
+      REQUIRE (first_io);
+      REQUIRE (first_io->stop_io());
+    }
+    wait_for([&sent] { return sent.load(); });
+    REQUIRE (sent);
+    REQUIRE (accepted == num_conns);
+    wait_for([&tracker] { return tracker.m_msgs == num_conns; });
+    REQUIRE (tracker.m_msgs == num_conns);
+  }
+  acc.stop();
+  nip.remove_all();
+  wk.reset();
+}
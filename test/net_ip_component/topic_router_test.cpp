@@ -0,0 +1,161 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenario for @c topic_router class template.
+ *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0.
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+
+#include <memory> // std::make_shared
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <iostream>
+
+#include "net_ip_component/topic_router.hpp"
+
+#include "buffer/shared_buffer.hpp"
+
+#include "shared_test/mock_classes.hpp"
+
+// stateless (and so thread-safe) IO handler for the publish benchmark
+struct null_ioh : public std::enable_shared_from_this<null_ioh> {
+  bool send(chops::const_shared_buffer) { return true; }
+};
+
+TEST_CASE ( "Testing topic_router class", "[topic_router]" ) {
+
+  using namespace chops::test;
+
+  chops::net::topic_router<io_handler_mock> rtr { };
+  REQUIRE (rtr.num_topics() == 0u);
+  REQUIRE (rtr.size() == 0u);
+
+  auto ioh1 = std::make_shared<io_handler_mock>();
+  auto ioh2 = std::make_shared<io_handler_mock>();
+  auto ioh3 = std::make_shared<io_handler_mock>();
+
+  io_interface_mock io_intf1(ioh1);
+  io_interface_mock io_intf2(ioh2);
+  io_interface_mock io_intf3(ioh3);
+
+  io_output_mock out1 = *(io_intf1.make_io_output());
+  io_output_mock out2 = *(io_intf2.make_io_output());
+  io_output_mock out3 = *(io_intf3.make_io_output());
+
+  constexpr std::uint64_t t1 = 1u;
+  constexpr std::uint64_t t2 = 2u;
+  constexpr std::uint64_t t3 = 3u;
+
+  REQUIRE (rtr.subscribe(t1, out1));
+  REQUIRE_FALSE (rtr.subscribe(t1, out1));
+  REQUIRE (rtr.subscribe(t1, out2));
+  REQUIRE (rtr.subscribe(t1, out3));
+  REQUIRE (rtr.subscribe(t2, out2));
+  REQUIRE (rtr.subscribe(t3, out3));
+  REQUIRE (rtr.num_topics() == 3u);
+  REQUIRE (rtr.size() == 3u);
+  REQUIRE (rtr.num_subscribers(t1) == 3u);
+  REQUIRE (rtr.num_subscribers(t2) == 1u);
+  REQUIRE (rtr.has_subscribers(t3));
+  REQUIRE_FALSE (rtr.has_subscribers(42u));
+
+  std::byte b(static_cast<std::byte>(0xFE));
+  chops::const_shared_buffer buf(&b, 1u);
+
+  REQUIRE (rtr.publish(t2, buf) == 1u);
+  REQUIRE_FALSE (ioh1->send_called);
+  REQUIRE (ioh2->send_called);
+  REQUIRE_FALSE (ioh3->send_called);
+
+  REQUIRE (rtr.publish(t1, buf) == 3u);
+  REQUIRE (rtr.publish(t1, buf, out1) == 2u);
+  REQUIRE (rtr.publish(t1, &b, 1u) == 3u);
+  REQUIRE (rtr.publish(t1, &b, 1u, out2) == 2u);
+  REQUIRE (rtr.publish(t2, chops::mutable_shared_buffer(&b, 1u)) == 1u);
+  REQUIRE (rtr.publish(42u, buf) == 0u);
+  REQUIRE (rtr.publish(42u, &b, 1u) == 0u);
+
+  REQUIRE (rtr.unsubscribe(t1, out2));
+  REQUIRE_FALSE (rtr.unsubscribe(t1, out2));
+  REQUIRE_FALSE (rtr.unsubscribe(t3, out1));
+  REQUIRE (rtr.num_subscribers(t1) == 2u);
+  REQUIRE (rtr.unsubscribe(t2, out2));
+  REQUIRE (rtr.num_topics() == 2u); // empty topics are removed
+  REQUIRE (rtr.size() == 2u);
+
+  // io_state_change interface, stopping unsubscribes from all topics
+  rtr(io_intf3, 1u, true);
+  REQUIRE (rtr.num_subscribers(t1) == 2u);
+  rtr(io_intf3, 0u, false);
+  REQUIRE (rtr.num_subscribers(t1) == 1u);
+  REQUIRE_FALSE (rtr.has_subscribers(t3));
+  REQUIRE (rtr.num_topics() == 1u);
+  REQUIRE (rtr.size() == 1u);
+
+  // subscriptions can be removed after the IO handler is destroyed
+  REQUIRE (rtr.subscribe(t2, out1));
+  out1 = io_output_mock();
+  io_output_mock out_exp = *(io_intf1.make_io_output());
+  ioh1.reset();
+  REQUIRE (rtr.publish(t1, buf) == 0u);
+  REQUIRE (rtr.unsubscribe_all(out_exp) == 2u);
+  REQUIRE (rtr.num_topics() == 0u);
+  REQUIRE (rtr.size() == 0u);
+}
+
+TEST_CASE ( "Testing topic_router class, 10k topics publish benchmark",
+            "[.] [benchmark] [topic_router]" ) {
+
+  constexpr int num_conns = 1000;
+  constexpr int num_topics = 10000;
+  constexpr int topics_per_conn = 100; // 10 subscribers per topic
+  constexpr int pubs_per_thr = 1000000;
+
+  chops::net::topic_router<null_ioh> rtr { };
+  std::vector<std::shared_ptr<null_ioh> > iohs;
+  for (int i = 0; i < num_conns; ++i) {
+    iohs.push_back(std::make_shared<null_ioh>());
+    chops::net::basic_io_output<null_ioh> out(iohs.back());
+    for (int j = 0; j < topics_per_conn; ++j) {
+      rtr.subscribe(static_cast<std::uint64_t>((i * topics_per_conn + j) % num_topics), out);
+    }
+  }
+  REQUIRE (rtr.num_topics() == static_cast<std::size_t>(num_topics));
+
+  chops::const_shared_buffer buf(chops::mutable_shared_buffer(8u));
+  for (int num_thrs : { 1, 2, 4 }) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> thrs;
+    for (int i = 0; i < num_thrs; ++i) {
+      thrs.emplace_back( [&rtr, buf] {
+          for (int j = 0; j < pubs_per_thr; ++j) {
+            rtr.publish(static_cast<std::uint64_t>(j % num_topics), buf);
+          }
+        } );
+    }
+    for (auto& t : thrs) {
+      t.join();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "topic_router, topics: " << num_topics << ", publish threads: " << num_thrs <<
+                 ", nsecs per publish: " <<
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+                   (static_cast<long long>(num_thrs) * pubs_per_thr) << std::endl;
+  }
+}
+
@@ -0,0 +1,213 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenarios for @c worker_pool class.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0. 
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/post.hpp"
+#include "asio/ip/tcp.hpp"
+#include "asio/buffer.hpp"
+
+#include <cstddef> // std::size_t
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept> // std::invalid_argument
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "net_ip_component/worker_pool.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+
+constexpr std::size_t num_thrs = 4u;
+
+void busy_wait(std::chrono::microseconds d) {
+  auto end = std::chrono::steady_clock::now() + d;
+  while (std::chrono::steady_clock::now() < end) { }
+}
+
+TEST_CASE ( "Worker pool, io_context per thread", "[worker_pool]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker_pool_options opts;
+  opts.num_threads = num_thrs;
+  opts.thread_name_prefix = "wp_test";
+  chops::net::worker_pool wp(opts);
+  REQUIRE (wp.size() == num_thrs);
+  REQUIRE (wp.get_io_contexts().size() == num_thrs);
+  wp.start();
+
+  constexpr int num_handlers = 100;
+  std::mutex mut;
+  std::vector<std::set<std::thread::id>> thr_ids(num_thrs);
+  std::set<std::string> names;
+  for (std::size_t i = 0u; i < num_thrs; ++i) {
+    for (int j = 0; j < num_handlers; ++j) {
+      asio::post(wp.get_io_context(i), [&, i] () {
+          busy_wait(100us);
+          std::scoped_lock<std::mutex> lk(mut);
+          thr_ids[i].insert(std::this_thread::get_id());
+#if defined(__linux__)
+          char buf[16];
+          pthread_getname_np(pthread_self(), buf, sizeof(buf));
+          names.insert(buf);
+#endif
+        }
+      );
+    }
+  }
+  wp.reset(); // waits for the handlers
+
+  std::set<std::thread::id> all_ids;
+  for (const auto& ids : thr_ids) {
+    REQUIRE (ids.size() == 1u); // each io_context is run by a single thread
+    all_ids.insert(*ids.cbegin());
+  }
+  REQUIRE (all_ids.size() == num_thrs);
+#if defined(__linux__)
+  REQUIRE (names == std::set<std::string> { "wp_test-0", "wp_test-1", "wp_test-2", "wp_test-3" });
+#endif
+
+  for (const auto& st : wp.get_thread_stats()) {
+    REQUIRE (st.handlers == static_cast<std::size_t>(num_handlers));
+    REQUIRE (st.busy > 0ns);
+    REQUIRE (st.busy <= st.elapsed);
+    REQUIRE (st.utilization() > 0.0);
+    REQUIRE (st.utilization() <= 1.0);
+    REQUIRE_FALSE (st.pinned);
+  }
+}
+
+TEST_CASE ( "Worker pool, shared io_context and CPU affinity", "[worker_pool]" ) {
+
+  chops::net::worker_pool_options opts;
+  opts.num_threads = num_thrs;
+  opts.layout = chops::net::worker_pool_layout::shared_io_context;
+  opts.cpus = { 0 };
+  chops::net::worker_pool wp(opts);
+  REQUIRE (wp.get_io_contexts().size() == 1u);
+  REQUIRE (&wp.get_io_context(2u) == &wp.get_io_context());
+  wp.start();
+
+  constexpr std::size_t num_handlers = 1000u;
+  std::atomic_size_t cnt = 0u;
+  std::atomic_bool other_cpu = false;
+  for (std::size_t i = 0u; i < num_handlers; ++i) {
+    asio::post(wp.get_io_context(), [&] () {
+        ++cnt;
+#if defined(__linux__)
+        if (sched_getcpu() != 0) {
+          other_cpu = true;
+        }
+#endif
+      }
+    );
+  }
+  wp.reset();
+  REQUIRE (cnt == num_handlers);
+
+  std::size_t total = 0u;
+  for (const auto& st : wp.get_thread_stats()) {
+    total += st.handlers;
+#if defined(__linux__)
+    REQUIRE (st.pinned);
+#endif
+  }
+  REQUIRE (total == num_handlers);
+  REQUIRE_FALSE (other_cpu);
+}
+
+TEST_CASE ( "Worker pool, stop abandons handlers", "[worker_pool]" ) {
+
+  chops::net::worker_pool wp(chops::net::worker_pool_options { 2u });
+  wp.start();
+  std::atomic_size_t cnt = 0u;
+  for (int i = 0; i < 10; ++i) {
+    asio::post(wp.get_io_context(0u), [&cnt] () { 
+        ++cnt;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+    );
+  }
+  wp.stop();
+  REQUIRE (cnt < 10u);
+}
+
+TEST_CASE ( "Worker pool, net_ip entities assigned across threads", "[worker_pool]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker_pool wp(chops::net::worker_pool_options { num_thrs });
+  wp.start();
+  REQUIRE_THROWS_AS (chops::net::net_ip(chops::net::io_context_refs()), std::invalid_argument);
+  chops::net::net_ip nip(wp.get_io_contexts());
+
+  auto acc = nip.make_tcp_acceptor("30991");
+  std::atomic_size_t msgs = 0u;
+  REQUIRE (acc.start([&msgs] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+        if (starting) {
+          io.start_io(std::string_view("\n"), 
+              [&msgs] (asio::const_buffer, chops::net::tcp_io_output, asio::ip::tcp::endpoint) {
+                ++msgs;
+                return true;
+              }
+          );
+        }
+      },
+      [] (chops::net::tcp_io_interface, std::error_code) { }
+  ));
+
+  std::vector<chops::net::net_entity> conns;
+  std::set<const asio::execution_context*> ctxs;
+  for (std::size_t i = 0u; i < num_thrs - 1u; ++i) {
+    auto conn = nip.make_tcp_connector("30991", "localhost", chops::net::simple_timeout(50ms));
+    conn.visit_socket([&ctxs] (asio::ip::tcp::socket& sock) {
+        ctxs.insert(&sock.get_executor().context());
+      }
+    );
+    REQUIRE (conn.start([] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+          if (starting) {
+            io.start_io();
+            io.make_io_output()->send("hello\n", 6u);
+          }
+        },
+        [] (chops::net::tcp_io_interface, std::error_code) { }
+    ));
+    conns.push_back(conn);
+  }
+  // the acceptor uses the first io_context, the connectors the others
+  REQUIRE (ctxs.size() == num_thrs - 1u);
+  REQUIRE (ctxs.count(&wp.get_io_context(0u)) == 0u);
+
+  for (int i = 0; i < 500 && msgs < num_thrs - 1u; ++i) {
+    std::this_thread::sleep_for(10ms);
+  }
+  REQUIRE (msgs == num_thrs - 1u);
+
+  nip.stop_all();
+  nip.remove_all();
+  wp.reset();
+}
+
@@ -0,0 +1,190 @@
+/** @file
+ *
+ *  @ingroup test_module
+ *
+ *  @brief Test scenarios for @c worker class, including a run loop latency benchmark.
+ *
+ *  The benchmark test cases are hidden, run them with the "[benchmark]" tag. The busy
+ *  polling results are only meaningful with a free CPU core for each spinning thread.
+ *
+ *  @author Cliff Green
+ *
+ *  Copyright (c) 2025 by Cliff Green
+ *
+ *  Distributed under the Boost Software License, Version 1.0. 
+ *  (See accompanying file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#include "catch2/catch_test_macros.hpp"
+
+#include "asio/post.hpp"
+#include "asio/ip/tcp.hpp"
+#include "asio/ip/udp.hpp"
+#include "asio/buffer.hpp"
+
+#include <cstddef> // std::size_t
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <memory> // std::make_shared
+#include <vector>
+#include <algorithm> // std::sort
+#include <string>
+#include <iostream>
+
+#include "net_ip_component/worker.hpp"
+
+#include "net_ip/net_ip.hpp"
+#include "net_ip/net_entity.hpp"
+
+TEST_CASE ( "Worker, run and reset", "[worker]" ) {
+
+  chops::net::worker wk;
+  wk.start();
+  std::atomic_size_t cnt = 0u;
+  for (int i = 0; i < 100; ++i) {
+    asio::post(wk.get_io_context(), [&cnt] () { ++cnt; } );
+  }
+  wk.reset();
+  REQUIRE (cnt == 100u);
+  REQUIRE (wk.get_thread_stats().handlers == 0u); // not collected by the run method
+}
+
+TEST_CASE ( "Worker, busy poll run loop", "[worker] [busy_poll]" ) {
+
+  using namespace std::chrono_literals;
+
+  chops::net::worker wk;
+  wk.start_busy_poll(2ms);
+  std::atomic_size_t cnt = 0u;
+  for (int i = 0; i < 20; ++i) {
+    asio::post(wk.get_io_context(), [&cnt] () { ++cnt; } );
+    // alternate gaps shorter and longer than the spin budget
+    std::this_thread::sleep_for(i % 2 == 0 ? 200us : 5ms);
+  }
+  wk.reset();
+  REQUIRE (cnt == 20u);
+
+  auto st = wk.get_thread_stats();
+  REQUIRE (st.handlers == 20u);
+  REQUIRE (st.spin > 2ms);
+  REQUIRE (st.blocks > 0u);
+  REQUIRE (st.blocks <= 11u); // at most once per long gap, plus the final wait
+  REQUIRE (st.busy + st.spin <= st.elapsed);
+}
+
+TEST_CASE ( "Worker, busy poll socket option", "[worker] [busy_poll]" ) {
+
+  asio::io_context ioc;
+  asio::ip::udp::socket sock(ioc, asio::ip::udp::v4());
+  auto ec = chops::net::set_busy_poll_option(sock, std::chrono::microseconds(0));
+#if defined(SO_BUSY_POLL)
+  REQUIRE_FALSE (ec);
+#else
+  REQUIRE (ec == std::make_error_code(std::errc::operation_not_supported));
+#endif
+}
+
+// request / response exchanges on loopback, each side run by its own worker, returning
+// the round trip time of each exchange
+std::vector<std::chrono::nanoseconds> ping_pong(bool busy_poll, std::size_t num_exchanges) {
+
+  using namespace std::chrono_literals;
+  using clock = std::chrono::steady_clock;
+
+  constexpr std::size_t msg_size = 16u;
+  const char* port = "30995";
+
+  chops::net::worker srv_wk;
+  chops::net::worker cli_wk;
+  if (busy_poll) { // a spin budget longer than the gap between exchanges, so never blocking
+    srv_wk.start_busy_poll(100ms);
+    cli_wk.start_busy_poll(100ms);
+  }
+  else {
+    srv_wk.start();
+    cli_wk.start();
+  }
+
+  std::vector<std::chrono::nanoseconds> rtts;
+  rtts.reserve(num_exchanges);
+  {
+    chops::net::net_ip srv_nip(srv_wk.get_io_context());
+    chops::net::net_ip cli_nip(cli_wk.get_io_context());
+
+    auto acc = srv_nip.make_tcp_acceptor(port);
+    acc.start([] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+          if (starting) {
+            io.start_io(msg_size, 
+                [] (asio::const_buffer buf, chops::net::tcp_io_output io_out, asio::ip::tcp::endpoint) {
+                  io_out.send(buf.data(), buf.size());
+                  return true;
+                }
+            );
+          }
+        },
+        [] (chops::net::tcp_io_interface, std::error_code) { }
+    );
+
+    std::promise<void> done_prom;
+    auto done_fut = done_prom.get_future();
+    auto sent = std::make_shared<clock::time_point>();
+    const std::string msg(msg_size, 'p');
+    auto conn = cli_nip.make_tcp_connector(port, "127.0.0.1");
+    conn.start([&, sent] (chops::net::tcp_io_interface io, std::size_t, bool starting) {
+          if (!starting) {
+            return;
+          }
+          io.start_io(msg_size, 
+              [&, sent] (asio::const_buffer, chops::net::tcp_io_output io_out, asio::ip::tcp::endpoint) {
+                rtts.push_back(clock::now() - *sent);
+                if (rtts.size() == num_exchanges) {
+                  done_prom.set_value();
+                  return false;
+                }
+                *sent = clock::now();
+                io_out.send(msg.data(), msg.size());
+                return true;
+              }
+          );
+          *sent = clock::now();
+          io.make_io_output()->send(msg.data(), msg.size());
+        },
+        [] (chops::net::tcp_io_interface, std::error_code) { }
+    );
+    done_fut.get();
+    cli_nip.stop_all();
+    srv_nip.stop_all();
+  }
+  srv_wk.reset();
+  cli_wk.reset();
+  return rtts;
+}
+
+void print_percentiles(const std::string& name, std::vector<std::chrono::nanoseconds> rtts) {
+  std::sort(rtts.begin(), rtts.end());
+  auto pct = [&rtts] (double p) {
+    auto idx = static_cast<std::size_t>(p * static_cast<double>(rtts.size() - 1u));
+    return std::chrono::duration_cast<std::chrono::microseconds>(rtts[idx]).count();
+  };
+  std::cout << name << " round trip usecs: p50 " << pct(0.50) << ", p90 " << pct(0.90) 
+            << ", p99 " << pct(0.99) << ", p99.9 " << pct(0.999) << ", max " << pct(1.0) 
+            << std::endl;
+}
+
+TEST_CASE ( "Worker run versus busy poll ping-pong latency benchmark", 
+            "[.] [benchmark] [worker] [busy_poll]" ) {
+
+  constexpr std::size_t num_exchanges = 20000u;
+
+  auto run_rtts = ping_pong(false, num_exchanges);
+  REQUIRE (run_rtts.size() == num_exchanges);
+  print_percentiles("run", run_rtts);
+
+  auto poll_rtts = ping_pong(true, num_exchanges);
+  REQUIRE (poll_rtts.size() == num_exchanges);
+  print_percentiles("busy poll", poll_rtts);
+}
+
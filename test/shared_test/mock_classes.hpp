@@ -18,6 +18,7 @@
 
 #include <memory> // std::shared_ptr
 #include <string_view>
+#include <iterator> // std::size
 #include <cstddef> // std::size_t, std::byte
 #include <system_error>
 
@@ -36,7 +37,7 @@ namespace test {
 
 inline std::size_t mock_hdr_decoder_func (const std::byte*, std::size_t) { return 0u; }
 
-struct io_handler_mock {
+struct io_handler_mock : public std::enable_shared_from_this<io_handler_mock> {
   using endpoint_type = asio::ip::udp::endpoint;
 
   double mock_sock = 42.0;
@@ -55,11 +56,25 @@ struct io_handler_mock {
     return chops::net::output_queue_stats { qs_base, qs_base +1 };
   }
 
+  std::size_t clear_output_queue() { return 0u; }
+
+  void enable_output_timestamps() { }
+
+  template <typename F>
+  void notify_when_drained(std::size_t, F&& func) { func(); }
+
   bool send_called = false;
 
   bool send(chops::const_shared_buffer) { send_called = true; return true; }
   bool send(chops::const_shared_buffer, const endpoint_type&) { send_called = true; return true; }
 
+  template <typename R>
+  std::size_t send_batch(const R& bufs) { send_called = true; return std::size(bufs); }
+  template <typename R>
+  std::size_t send_batch(const R& bufs, const endpoint_type&) { 
+    send_called = true; return std::size(bufs);
+  }
+
   bool mf_sio_called = false;
   bool simple_var_len_sio_called = false;
   bool delim_sio_called = false;